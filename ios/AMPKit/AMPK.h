@@ -15,10 +15,16 @@
  */
 
 #import "AMPKArticle.h"
+#import "AMPKArticleMetadataCache.h"
+#import "AMPKContentBlockingPolicy.h"
+#import "AMPKFeedIngestor.h"
+#import "AMPKFeedSnapshot.h"
 #import "AMPKPrefetchController.h"
 #import "AMPKPresenterProtocol.h"
+#import "AMPKRuntimeCache.h"
 #import "AMPKViewer.h"
 #import "AMPKViewerDataSource.h"
+#import "AMPKViewerTraceRecorder.h"
 #import "AMPKWebViewerViewController.h"
 
 /**
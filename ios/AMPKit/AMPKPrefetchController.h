@@ -16,6 +16,7 @@
 
 #import <Foundation/Foundation.h>
 
+@class AMPKFeedSnapshot;
 @class AMPKViewer;
 @class AMPKViewerDataSource;
 @protocol AMPKAnalyticsProtocol;
@@ -80,6 +81,25 @@ NS_ASSUME_NONNULL_BEGIN
                  usingHeaders:(nullable NSDictionary<NSString *, NSString *> *)headers
             prefetchedAtIndex:(NSInteger)index NS_REQUIRES_SUPER;
 
+/**
+ * Like ampViewerWithArticles:usingHeaders:prefetchedAtIndex:, but the articles are validated and
+ * their URLs computed on a background queue, which keeps large feeds from dropping frames. The
+ * viewer is updated on the main queue once that is done, and then @c completion is called. If this
+ * is called again first, only the latest feed is applied and earlier completions aren't called.
+ * @param articles Don't change the articles until @c completion is called.
+ */
+- (void)ingestArticles:(NSArray<id <AMPKArticleProtocol>> *)articles
+          usingHeaders:(nullable NSDictionary<NSString *, NSString *> *)headers
+     prefetchedAtIndex:(NSInteger)index
+            completion:(nullable void (^)(void))completion;
+
+/**
+ * Shows the articles of @c snapshot, built for the viewer data source's domain name, and prefetches
+ * the one at @c index.
+ */
+- (void)ampViewerWithFeedSnapshot:(AMPKFeedSnapshot *)snapshot
+                prefetchedAtIndex:(NSInteger)index NS_REQUIRES_SUPER;
+
 /**
  * Call this method to change the pre-fetched index. You may call this before presenting the AMP
  * viewer to make sure the viewer is loaded on the correct article.
@@ -16,13 +16,16 @@
 
 #import "AMPKPrefetchController.h"
 
+#import "AMPKFeedIngestor.h"
+#import "AMPKFeedSnapshot.h"
 #import "AMPKViewer.h"
 #import "AMPKViewerDataSource.h"
 
-
 NS_ASSUME_NONNULL_BEGIN
 
-@implementation AMPKPrefetchController
+@implementation AMPKPrefetchController {
+  AMPKFeedIngestor *_feedIngestor;
+}
 
 @synthesize ampViewController = _ampViewController;
 
@@ -45,6 +48,31 @@ NS_ASSUME_NONNULL_BEGIN
   [self.ampViewController setCurrentViewerIndex:index];
 }
 
+- (void)ingestArticles:(NSArray<id <AMPKArticleProtocol>> *)articles
+          usingHeaders:(nullable NSDictionary<NSString *, NSString *> *)headers
+     prefetchedAtIndex:(NSInteger)index
+            completion:(nullable void (^)(void))completion {
+  if (!_feedIngestor) {
+    _feedIngestor = [[AMPKFeedIngestor alloc] init];
+  }
+  __weak AMPKPrefetchController *weakSelf = self;
+  [_feedIngestor ingestArticles:articles
+                        headers:headers
+                     domainName:self.ampViewController.viewerDataSource.domainName
+                     completion:^(AMPKFeedSnapshot *snapshot) {
+    [weakSelf ampViewerWithFeedSnapshot:snapshot prefetchedAtIndex:index];
+    if (completion) {
+      completion();
+    }
+  }];
+}
+
+- (void)ampViewerWithFeedSnapshot:(AMPKFeedSnapshot *)snapshot
+                prefetchedAtIndex:(NSInteger)index {
+  [self.ampViewController.viewerDataSource setFeedSnapshot:snapshot];
+  [self.ampViewController setCurrentViewerIndex:index];
+}
+
 #pragma mark - Opening Viewer
 
 - (void)updatePrefetchIndex:(NSInteger)index {
@@ -107,8 +107,25 @@
   [self.AMPKViewControllerDelegate AMPKCloseViewer:sender];
 }
 
+- (void)closeLinkedArticle:(id)sender {
+  UINavigationController *navigationController =
+      (UINavigationController *)self.presentedViewController;
+  AMPKWebViewerViewController *linkedViewer =
+      (AMPKWebViewerViewController *)navigationController.viewControllers.firstObject;
+  [linkedViewer setVisible:NO];
+  [self dismissViewControllerAnimated:YES
+                           completion:^{
+                             // The view may be reused for one of the articles.
+                             [linkedViewer willMoveToParentViewController:nil];
+                             [linkedViewer.view removeFromSuperview];
+                             [linkedViewer removeFromParentViewController];
+                             [self.viewerDataSource releaseLinkedViewController:linkedViewer];
+                           }];
+}
+
 - (void)shareURL:(id)sender {
-  NSArray *item = @[self.currentAmpWebViewerController.article.canonicalURL];
+  AMPKWebViewerViewController *current = self.currentAmpWebViewerController;
+  NSArray *item = @[ current.sharingURL ?: current.article.publisherURL ];
   UIActivityViewController *activityViewController =
       [[UIActivityViewController alloc] initWithActivityItems:item
                                         applicationActivities:nil];
@@ -136,11 +153,33 @@
   if ([self.AMPKViewControllerDelegate respondsToSelector:@selector(AMPKPresentExternalURL:)]) {
     [self.AMPKViewControllerDelegate AMPKPresentExternalURL:url];
   } else {
+    // Links in a linked page are presented over it.
+    UIViewController *presentingViewController = self;
+    while (presentingViewController.presentedViewController) {
+      presentingViewController = presentingViewController.presentedViewController;
+    }
     SFSafariViewController *safariViewController = [[SFSafariViewController alloc] initWithURL:url];
-    [self presentViewController:safariViewController animated:YES completion:nil];
+    [presentingViewController presentViewController:safariViewController
+                                           animated:YES
+                                         completion:nil];
   }
 }
 
+- (void)presentAmpWebViewerController:(AMPKWebViewerViewController *)ampWebViewerController
+                   fromViewController:(UIViewController *)fromViewController {
+  ampWebViewerController.navigationItem.title =
+      [self headerStringForURL:ampWebViewerController.article.publisherURL];
+  ampWebViewerController.navigationItem.leftBarButtonItem =
+      [[UIBarButtonItem alloc] initWithBarButtonSystemItem:UIBarButtonSystemItemDone
+                                                    target:self
+                                                    action:@selector(closeLinkedArticle:)];
+  UINavigationController *navigationController =
+      [[UINavigationController alloc] initWithRootViewController:ampWebViewerController];
+  // Only closed with the Done button, which hands the AMP view back to the viewer.
+  navigationController.modalPresentationStyle = UIModalPresentationFullScreen;
+  [self presentViewController:navigationController animated:YES completion:nil];
+}
+
 - (void)presentAccessUrl:(NSURL *)accessUrl
            requestPrefix:(NSString *)identifier
                requestId:(NSString *)requestId
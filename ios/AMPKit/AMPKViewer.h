@@ -105,6 +105,25 @@
 
 @end
 
+/** Class extension for AMP pages linked from the articles. */
+@interface AMPKViewer ()
+
+/**
+ * Opens @c url, a link the user tapped in one of the articles, in an AMP view from the viewer data
+ * source's pool if it links to an AMP page (see ampk_AMPPublisherURL) and the presenter implements
+ * presentAmpWebViewerController:fromViewController:. Returns NO if it didn't open it, so the link
+ * can be presented some other way.
+ */
+- (BOOL)openAmpLinkURL:(NSURL *)url fromViewController:(UIViewController *)fromViewController;
+
+/**
+ * Starts loading the AMP page @c url links to, if it can be opened by openAmpLinkURL:, e.g. when
+ * the user long presses or hovers over the link.
+ */
+- (void)prefetchAmpLinkURL:(NSURL *)url;
+
+@end
+
 @protocol AMPKViewerDelegate <NSObject>
 
 /**
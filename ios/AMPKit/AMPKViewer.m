@@ -15,10 +15,15 @@
  */
 
 #import "AMPKViewer.h"
+#import "AMPKViewer_private.h"
 
+#import "AMPKArticle.h"
 #import "AMPKMessageBroadcaster.h"
+#import "AMPKPresenterProtocol.h"
 #import "AMPKViewerDataSource.h"
+#import "AMPKViewerTraceRecorder.h"
 #import "AMPKWebViewerViewController.h"
+#import "NSURL+AMPK.h"
 
 @interface AMPKViewer () <AMPKViewerDataSourceDelegate>
 
@@ -57,12 +62,14 @@
 - (void)viewWillAppear:(BOOL)animated {
   [super viewWillAppear:animated];
 
+  [_traceRecorder recordForeground];
   [_currentAmpWebViewerController setVisible:YES];
 }
 
 - (void)viewDidDisappear:(BOOL)animated {
   [super viewDidDisappear:animated];
 
+  [_traceRecorder recordBackground];
   [_currentAmpWebViewerController setVisible:NO];
 }
 
@@ -70,6 +77,7 @@
 
 - (void)setCurrentViewerIndex:(NSInteger)currentViewerIndex {
   if (_currentViewerIndex != currentViewerIndex) {
+    [_traceRecorder recordJumpToIndex:currentViewerIndex];
     [self resetVisibleAmpViewerControllerAtIndex:currentViewerIndex];
   }
 }
@@ -117,6 +125,7 @@
   [willTransitionController setVisible:YES];
 
   NSInteger index = [_viewerDataSource indexForViewController:willTransitionController];
+  [_traceRecorder recordSwipeBeginToIndex:index];
   [_viewerDataSource prefetchItemAtIndex:index];
 
   [_pageViewControllerDelegate ampPageViewController:self
@@ -128,6 +137,7 @@
    previousViewControllers:(NSArray<UIViewController *> *)previousViewControllers
        transitionCompleted:(BOOL)completed {
   if (!completed) {
+    [_traceRecorder recordSwipeEndAtIndex:_currentViewerIndex completed:NO];
     return;
   }
   self.isPrefetched = NO;
@@ -138,12 +148,14 @@
 
   NSInteger index =
       [_viewerDataSource indexForViewController:pageViewController.viewControllers.firstObject];
+  [_traceRecorder recordSwipeEndAtIndex:index completed:YES];
   [self resetVisibleAmpViewerControllerAtIndex:index];
 }
 
 #pragma mark - AMPKViewerDataSourceDelegate
 
 - (void)ampViewerDataSourceDidChange:(AMPKViewerDataSource *)dataSource {
+  [_traceRecorder recordFeedWithCount:dataSource.count];
   if (_currentViewerIndex > dataSource.count) {
     // Reset viewerIndex if it is out of bounds.
     _currentViewerIndex = 0;
@@ -153,6 +165,31 @@
   [_pageViewControllerDelegate ampPageViewControllerDidChangeViewerDataSource:self];
 }
 
+#pragma mark - Linked AMP Pages
+
+- (BOOL)openAmpLinkURL:(NSURL *)url fromViewController:(UIViewController *)fromViewController {
+  id<AMPKArticleProtocol> article = [self linkedArticleForURL:url];
+  if (!article) {
+    return NO;
+  }
+  AMPKWebViewerViewController *linkedViewer =
+      [_viewerDataSource viewControllerForLinkedArticle:article visible:YES];
+  // Links in the linked page go straight to the presenter. Without a viewer the page can't page or
+  // hide this viewer, or open another linked page over itself.
+  linkedViewer.presenter = _presenter;
+  linkedViewer.viewer = nil;
+  [linkedViewer setVisible:YES];
+  [_presenter presentAmpWebViewerController:linkedViewer fromViewController:fromViewController];
+  return YES;
+}
+
+- (void)prefetchAmpLinkURL:(NSURL *)url {
+  id<AMPKArticleProtocol> article = [self linkedArticleForURL:url];
+  if (article) {
+    ((void)[_viewerDataSource viewControllerForLinkedArticle:article visible:NO]);
+  }
+}
+
 #pragma mark - AMP Runtime Extension endpoints
 
 - (void)setPagingEnabled:(BOOL)enabled {
@@ -171,12 +208,27 @@
 
 #pragma mark - Private
 
+// The AMP page |url| links to, if the presenter can present it.
+- (id<AMPKArticleProtocol>)linkedArticleForURL:(NSURL *)url {
+  SEL presentSelector = @selector(presentAmpWebViewerController:fromViewController:);
+  if (![_presenter respondsToSelector:presentSelector]) {
+    return nil;
+  }
+  NSURL *publisherURL = [url ampk_AMPPublisherURL];
+  if (!publisherURL) {
+    return nil;
+  }
+  return [AMPKArticle articleWithURL:publisherURL cdnURL:[url sanitizedCDNURL]];
+}
+
 // Reset the current visible AMP viewer to be at a givin index.
 - (void)resetVisibleAmpViewerControllerAtIndex:(NSInteger)index {
   UIScrollView *previousScrollView = _currentAmpWebViewerController.webScrollView;
   previousScrollView.scrollsToTop = NO;
 
   _currentViewerIndex = index;
+  // Before asking for the article, so the data source loads it ahead of its neighbours.
+  [_viewerDataSource setCurrentVisibleIndex:index];
   _currentAmpWebViewerController = _viewerDataSource[index];
   _currentAmpWebViewerController.presenter = self.presenter;
   _currentAmpWebViewerController.viewer = self;
@@ -187,13 +239,12 @@
   // perform dismissal animation.
   webScrollView.scrollsToTop = YES;
 
-  [_viewerDataSource setCurrentVisibleIndex:index];
-
   // WKWebView won't pre-render any view if it is not within window. Thus, we force to it to be
-  // pre-render here.
+  // pre-render here. A paused neighbour has already rendered and is left out of the window, where
+  // WebKit throttles it, until it is swiped to.
   AMPKWebViewerViewController *before = _viewerDataSource[index - 1];
   if (before) {
-    if (!before.view.window) {
+    if (!before.paused && !before.view.window) {
       [self.view insertSubview:before.view atIndex:0];
     }
     [before setVisible:NO];
@@ -201,7 +252,7 @@
 
   AMPKWebViewerViewController *after = _viewerDataSource[index + 1];
   if (after) {
-    if (!after.view.window) {
+    if (!after.paused && !after.view.window) {
       [self.view insertSubview:after.view atIndex:0];
     }
     [after setVisible:NO];
@@ -24,6 +24,16 @@ NS_ASSUME_NONNULL_BEGIN
 /** Generate the CDN proxy address from the current URL. */
 - (NSURL *)ampk_ProxiedURL;
 
+/**
+ * Returns the CDN URL on the cache subdomain of its publisher, e.g.
+ * https://www-example-com.cdn.ampproject.org/c/s/www.example.com/article for
+ * https://cdn.ampproject.org/c/s/www.example.com/article, which the cache would redirect to. URLs
+ * already on a subdomain are returned as they are. Returns nil if the URL isn't a CDN URL or its
+ * publisher's host has no plain subdomain, i.e. an internationalized one or one too long
+ * for it.
+ */
+- (nullable NSURL *)ampk_CacheSubdomainURL;
+
 /**
  * Set the hash fragment to the fragment used for proxy initialization of the current URL. Note,
  * this will overwrite any current hash fragment as the proxy does not allow any fragments in the
@@ -32,6 +42,13 @@ NS_ASSUME_NONNULL_BEGIN
  */
 - (NSURL *)URLBySettingProxyHashFragmentsForDomain:(NSURL *)domain;
 
+/**
+ * Generate the address of the current URL in the AMP viewer on @c domain, e.g.
+ * https://www.google.com/amp/s/www.example.com/article for https://www.example.com/article.
+ * @param domain should be a Google domain of current user's country. Ex: https//:xxx.google.com/
+ */
+- (NSURL *)ampk_WebViewerURLForDomain:(NSURL *)domain;
+
 /**
  * Returns the path of the URL but including the trailing slash if applicable. NSURL trims this
  * slash by default and AMP must keep it.
@@ -54,6 +71,14 @@ NS_ASSUME_NONNULL_BEGIN
  */
 - (nullable NSURL *)sanitizedCDNURL;
 
+/**
+ * Returns the publisher's URL of the AMP page the current URL links to, or nil if it isn't
+ * recognized as one. Recognized are CDN URLs, AMP viewer URLs such as
+ * https://www.google.com/amp/s/www.example.com/article, and publisher URLs in the usual AMP forms:
+ * an "amp" path component, an ".amp.html" page or an "amp" or "outputType=amp" query parameter.
+ */
+- (nullable NSURL *)ampk_AMPPublisherURL;
+
 @end
 
 NS_ASSUME_NONNULL_END
@@ -33,6 +33,28 @@ static NSArray *kAMPRuntimeQueryParamsBlackList(void) {
   return @[@"webview", @"dialog", @"viewport", @"visibilityState", @"prerenderSize", @"amp_js_v"];
 }
 
+// The label of a publisher's host on the cache, see ampk_CacheSubdomainURL: www.example.com is
+// served from www-example-com.cdn.ampproject.org. Only ASCII hosts whose label fits in the 63
+// characters DNS allows have one; the cache hashes the others and punycodes internationalized ones.
+static NSString *_Nullable kAMPCacheSubdomain(NSString *_Nullable host) {
+  if (!host.length || [host hasPrefix:@"xn--"] || [host containsString:@".xn--"]) {
+    return nil;
+  }
+  NSCharacterSet *hostCharacters =
+      [NSCharacterSet characterSetWithCharactersInString:
+                          @"abcdefghijklmnopqrstuvwxyz0123456789-."];
+  if ([host rangeOfCharacterFromSet:hostCharacters.invertedSet].location != NSNotFound) {
+    return nil;
+  }
+  NSString *label = [host stringByReplacingOccurrencesOfString:@"-" withString:@"--"];
+  label = [label stringByReplacingOccurrencesOfString:@"." withString:@"-"];
+  // A label with "--" as its third and fourth characters would read as an encoded one.
+  if (label.length >= 4 && [[label substringWithRange:NSMakeRange(2, 2)] isEqualToString:@"--"]) {
+    label = [NSString stringWithFormat:@"0-%@-0", label];
+  }
+  return label.length <= 63 ? label : nil;
+}
+
 @implementation NSURL (AMP)
 
 - (nullable NSURL *)sanitizedCDNURL {
@@ -80,6 +102,64 @@ static NSArray *kAMPRuntimeQueryParamsBlackList(void) {
   return NO;
 }
 
+- (nullable NSURL *)ampk_AMPPublisherURL {
+  NSString *scheme = self.scheme.lowercaseString;
+  if (![scheme isEqualToString:@"http"] && ![scheme isEqualToString:@"https"]) {
+    return nil;
+  }
+  if ([self isCDNURL]) {
+    return [[self sanitizedCDNURL] publisherURLAfterPrefix:@[ @"c" ]];
+  }
+  if ([self.host containsString:@".google."] && self.pathComponents.count > 2) {
+    return [self publisherURLAfterPrefix:@[ @"amp" ]];
+  }
+  if ([self.pathComponents containsObject:@"amp"] ||
+      [self.lastPathComponent hasSuffix:@".amp.html"]) {
+    return self;
+  }
+  NSURLComponents *components = [NSURLComponents componentsWithURL:self
+                                           resolvingAgainstBaseURL:NO];
+  for (NSURLQueryItem *item in components.queryItems) {
+    if ([item.name isEqualToString:@"amp"] ||
+        ([item.name isEqualToString:@"outputType"] && [item.value isEqualToString:@"amp"])) {
+      return self;
+    }
+  }
+  return nil;
+}
+
+// Maps the path of a CDN or AMP viewer URL, e.g. /c/s/www.example.com/article, back to the
+// publisher's URL, https://www.example.com/article. The inverse of basePathForMapping:.
+- (nullable NSURL *)publisherURLAfterPrefix:(NSArray<NSString *> *)prefixes {
+  // The percent encoded path, so the publisher's path is kept exactly as it was, trailing slash
+  // included.
+  NSURLComponents *components = [NSURLComponents componentsWithURL:self
+                                           resolvingAgainstBaseURL:NO];
+  NSMutableArray<NSString *> *pathComponents =
+      [[components.percentEncodedPath componentsSeparatedByString:@"/"] mutableCopy];
+  if (pathComponents.count && !pathComponents[0].length) {
+    [pathComponents removeObjectAtIndex:0];
+  }
+  if (pathComponents.count < 2 || ![prefixes containsObject:pathComponents[0]]) {
+    return nil;
+  }
+  [pathComponents removeObjectAtIndex:0];
+  NSString *scheme = @"http";
+  if ([pathComponents[0] isEqualToString:@"s"]) {
+    scheme = @"https";
+    [pathComponents removeObjectAtIndex:0];
+  }
+  if (!pathComponents.count || ![pathComponents[0] containsString:@"."]) {
+    return nil;
+  }
+  NSString *query = components.percentEncodedQuery;
+  NSString *urlString =
+      [NSString stringWithFormat:@"%@://%@%@%@", scheme,
+                                 [pathComponents componentsJoinedByString:@"/"],
+                                 query ? @"?" : @"", query ?: @""];
+  return [NSURL URLWithString:urlString];
+}
+
 - (BOOL)needsCDNSanitization {
   return [self isSpecifyingManualVersion] || self.query || self.fragment;
 }
@@ -169,6 +249,24 @@ static NSArray *kAMPRuntimeQueryParamsBlackList(void) {
   return url;
 }
 
+- (nullable NSURL *)ampk_CacheSubdomainURL {
+  NSString *cacheHost = [NSURL URLWithString:kDefaultAMPProxyPrefix].host;
+  if (![self isCDNURL]) {
+    return nil;
+  }
+  if (![self.host.lowercaseString isEqualToString:cacheHost]) {
+    return self;
+  }
+  NSString *subdomain = kAMPCacheSubdomain([self ampk_AMPPublisherURL].host.lowercaseString);
+  if (!subdomain) {
+    return nil;
+  }
+  NSURLComponents *components = [NSURLComponents componentsWithURL:self
+                                           resolvingAgainstBaseURL:NO];
+  components.host = [NSString stringWithFormat:@"%@.%@", subdomain, cacheHost];
+  return components.URL;
+}
+
 - (NSURL *)URLBySettingProxyHashFragmentsForDomain:(NSURL *)domain {
   // Use URLComponents to ensure we nil out any existing fragment that was passed in as part of the
   // host URL. Then, append the encoded host string manually. Since the fragment we set is encoded
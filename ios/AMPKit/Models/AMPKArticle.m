@@ -55,7 +55,8 @@ NS_ASSUME_NONNULL_BEGIN
 - (instancetype)copyWithZone:(nullable NSZone *)zone {
   AMPKArticle *ampArticle = [[[self class] alloc] init];
   ampArticle.publisherURL = [_publisherURL copy];
-  ampArticle.cdnURL = [_cdnURL copy];
+  // Already sanitized by setCdnURL:, so skip the setter.
+  ampArticle->_cdnURL = [_cdnURL copy];
   ampArticle.canonicalURL = [_canonicalURL copy];
   return ampArticle;
 }
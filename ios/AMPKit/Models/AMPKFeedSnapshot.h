@@ -0,0 +1,59 @@
+/**
+ * Copyright 2020 The AMP HTML Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS-IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#import <Foundation/Foundation.h>
+
+#import "AMPKArticleProtocol.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * An immutable, ready to show feed of AMP articles: the valid articles, copied, along with every
+ * URL the viewer needs for each of them. Building one does all the URL work up front and touches
+ * nothing but its arguments, so it can be done on any thread; AMPKFeedIngestor builds them in the
+ * background. Hand the result to AMPKViewerDataSource's setFeedSnapshot: on the main thread.
+ */
+@interface AMPKFeedSnapshot : NSObject
+
+/**
+ * Validates, copies and precomputes the URLs of @c articles. Articles that fail
+ * AMPKArticleIsValid are left out, so indexes refer to the snapshot's articles, not the input.
+ * @param domainName The viewer domain of the AMPKViewerDataSource that will show the feed.
+ */
+- (instancetype)initWithArticles:(NSArray<id<AMPKArticleProtocol>> *)articles
+                         headers:(nullable NSDictionary<NSString *, NSString *> *)headers
+                      domainName:(NSURL *)domainName NS_DESIGNATED_INITIALIZER;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+@property(nonatomic, copy, readonly) NSArray<id<AMPKArticleProtocol>> *articles;
+
+@property(nonatomic, copy, readonly, nullable) NSDictionary<NSString *, NSString *> *headers;
+
+@property(nonatomic, copy, readonly) NSURL *domainName;
+
+/** The cache URL the article at @c index is served from. */
+- (NSURL *)proxiedURLAtIndex:(NSUInteger)index;
+
+/** The proxied URL with the fragment that initializes the AMP runtime for the viewer. */
+- (NSURL *)loadURLAtIndex:(NSUInteger)index;
+
+/** The URL of the article in the viewer on @c domainName, e.g. for sharing. */
+- (NSURL *)viewerURLAtIndex:(NSUInteger)index;
+
+@end
+
+NS_ASSUME_NONNULL_END
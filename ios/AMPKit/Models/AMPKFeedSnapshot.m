@@ -0,0 +1,85 @@
+/**
+ * Copyright 2020 The AMP HTML Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS-IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#import "AMPKFeedSnapshot.h"
+
+#import "NSURL+AMPK.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+@implementation AMPKFeedSnapshot {
+  NSArray<NSURL *> *_proxiedURLs;
+  NSArray<NSURL *> *_loadURLs;
+  NSArray<NSURL *> *_viewerURLs;
+}
+
+- (instancetype)initWithArticles:(NSArray<id<AMPKArticleProtocol>> *)articles
+                         headers:(nullable NSDictionary<NSString *, NSString *> *)headers
+                      domainName:(NSURL *)domainName {
+  self = [super init];
+  if (self) {
+    NSMutableArray<id<AMPKArticleProtocol>> *validArticles =
+        [[NSMutableArray alloc] initWithCapacity:articles.count];
+    NSMutableArray<NSURL *> *proxiedURLs = [[NSMutableArray alloc] initWithCapacity:articles.count];
+    NSMutableArray<NSURL *> *loadURLs = [[NSMutableArray alloc] initWithCapacity:articles.count];
+    NSMutableArray<NSURL *> *viewerURLs = [[NSMutableArray alloc] initWithCapacity:articles.count];
+    for (id<AMPKArticleProtocol> article in articles) {
+      if (!AMPKArticleIsValid(article)) {
+        continue;
+      }
+      id<AMPKArticleProtocol> articleCopy = [article copyWithZone:nil];
+      NSURL *proxiedURL = articleCopy.cdnURL ?: [articleCopy.publisherURL ampk_ProxiedURL];
+      NSURL *loadURL = [proxiedURL URLBySettingProxyHashFragmentsForDomain:domainName];
+      NSURL *viewerURL = [articleCopy.publisherURL ampk_WebViewerURLForDomain:domainName];
+      if (!loadURL || !viewerURL) {
+        continue;
+      }
+      [validArticles addObject:articleCopy];
+      [proxiedURLs addObject:proxiedURL];
+      [loadURLs addObject:loadURL];
+      [viewerURLs addObject:viewerURL];
+    }
+    _articles = [validArticles copy];
+    _headers = [headers copy];
+    _domainName = [domainName copy];
+    _proxiedURLs = [proxiedURLs copy];
+    _loadURLs = [loadURLs copy];
+    _viewerURLs = [viewerURLs copy];
+  }
+  return self;
+}
+
+- (NSURL *)proxiedURLAtIndex:(NSUInteger)index {
+  return _proxiedURLs[index];
+}
+
+- (NSURL *)loadURLAtIndex:(NSUInteger)index {
+  return _loadURLs[index];
+}
+
+- (NSURL *)viewerURLAtIndex:(NSUInteger)index {
+  return _viewerURLs[index];
+}
+
+- (NSString *)description {
+  return [NSString stringWithFormat:@"<%@: %p, articles: %lu, domain: %@>",
+                                    NSStringFromClass([self class]), self,
+                                    (unsigned long)_articles.count, _domainName];
+}
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,35 @@
+/**
+ * Copyright 2020 The AMP HTML Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS-IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#import "AMPKContentBlockingPolicy.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/** Provide interface access for Unit Test. */
+@interface AMPKContentBlockingPolicy ()
+
+/** The identifier the compiled rules are stored under in WebKit's content rule list store. */
+@property(nonatomic, copy, readonly) NSString *ruleListIdentifier;
+
+/**
+ * Whether a policy alive in this process stores its rules under @c identifier, which keeps the
+ * list from being removed as stale.
+ */
++ (BOOL)isRuleListIdentifierLive:(NSString *)identifier;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,51 @@
+/**
+ * Copyright 2020 The AMP HTML Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS-IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#import "AMPKRuntimeCache.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+@class WKWebView;
+
+/** Provide interface access for refreshing and for Unit Test. */
+@interface AMPKRuntimeCache ()
+
+/**
+ * Writes @c scripts, keyed by the script URL, as @c version and makes it the current version.
+ * Versions other than the new one are removed from disk.
+ */
+- (BOOL)installScripts:(NSDictionary<NSURL *, NSData *> *)scripts
+               version:(NSString *)version
+                 error:(NSError **)error;
+
+/**
+ * Sets a handler called on the main queue for each script @c webView asks the cache for, with
+ * whether it was on disk and, if it was, its length. Only touch it on the main queue.
+ */
+- (void)setScriptHandler:(nullable void (^)(BOOL hit, NSUInteger length))handler
+              forWebView:(WKWebView *)webView;
+
+/**
+ * Keeps @c data, downloaded for @c url on a miss. A runtime of a new version replaces the current
+ * version; other scripts are added to it.
+ */
+- (void)storeScriptData:(NSData *)data
+                 forURL:(NSURL *)url
+               response:(NSHTTPURLResponse *)response;
+
+@end
+
+NS_ASSUME_NONNULL_END
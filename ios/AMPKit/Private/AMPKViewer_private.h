@@ -0,0 +1,34 @@
+/**
+ * Copyright 2020 The AMP HTML Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS-IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#import "AMPKViewer.h"
+
+@class AMPKViewerTraceRecorder;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/** Class extension for recording how the viewer is used. */
+@interface AMPKViewer ()
+
+/**
+ * When set, swipes, jumps to an article, article changes and the viewer appearing and disappearing
+ * are recorded to it. The traces can be replayed by the trace simulator in ios/Benchmarks.
+ */
+@property(nonatomic, nullable) AMPKViewerTraceRecorder *traceRecorder;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -21,6 +21,7 @@ static NSString *const kAmpJsMessagePostName = @"amp";
 static NSString *const kAmpChannelOpenMessageName = @"channelOpen";
 static NSString *const kAmpVisibilityChangeMessageName = @"visibilitychange";
 static NSString *const kAmpBroadcastMessageName = @"broadcast";
+static NSString *const kAmpShadowDocumentFailedMessageName = @"shadowDocumentFailed";
 
 @class AMPKWebViewerBaseMessageHandler;
 
@@ -74,6 +75,9 @@ static NSString *const kAmpBroadcastMessageName = @"broadcast";
 @interface AMPKWebViewerCancelFullOverlay : AMPKWebViewerBaseMessageHandler
 @end
 
+@interface AMPKWebViewerShadowDocumentFailed : AMPKWebViewerBaseMessageHandler
+@end
+
 @interface AMPKWebViewerMessageHandlerController ()
 @property(nonatomic, strong)
     NSDictionary<NSString *, AMPKWebViewerBaseMessageHandler *> *messageHandlers;
@@ -22,8 +22,58 @@
 @property(nonatomic, assign) CGPoint viewerContentOffset;
 @property(nonatomic, assign) NSInteger viewerDataSourceIndex;
 
+/** Whether the current article has been shown, see revealHandler. */
+@property(nonatomic, readonly, getter=isRevealed) BOOL revealed;
+
+/**
+ * Called once the current article is shown: when the AMP runtime reports documentLoaded, or when
+ * the web view finishes loading a page that never talks to the viewer.
+ */
+@property(nonatomic, copy, nullable) void (^revealHandler)(AMPKWebViewerViewController *viewer);
+
+/**
+ * Whether the system terminated the web view's content process since the current article was
+ * loaded, leaving the web view blank until reloadAfterWebContentTermination.
+ */
+@property(nonatomic, readonly, getter=isWebContentTerminated) BOOL webContentTerminated;
+
+/**
+ * Called when the web view's content process is terminated, to decide when to reload the article.
+ * Without one, the article is reloaded once the viewer is visible.
+ */
+@property(nonatomic, copy, nullable)
+    void (^terminationHandler)(AMPKWebViewerViewController *viewer);
+
+/**
+ * Called for each script the web view asks the runtime cache for, with whether it was on disk and,
+ * if it was, its length. Set it before the view loads.
+ */
+@property(nonatomic, copy, nullable) void (^runtimeCacheHandler)(BOOL hit, NSUInteger length);
+
 - (void)prepareForReuse;
 
+/**
+ * Loads the current article again, where the reader left it, if the web content process was
+ * terminated.
+ */
+- (void)reloadAfterWebContentTermination;
+
+/**
+ * Pauses the AMP runtime of a viewer that is no longer on screen and takes its view out of the view
+ * hierarchy, if AMPKViewer put it there to pre-render it, so WebKit throttles it too.
+ */
+- (void)pause;
+
+/**
+ * Loads @c article like loadAmpArticle:withHeaders:, using URLs computed ahead of time.
+ * @param proxiedURL The cache URL of @c article.
+ * @param loadURL @c proxiedURL with the viewer's hash fragments.
+ */
+- (void)loadAmpArticle:(id<AMPKArticleProtocol>)article
+           withHeaders:(nullable NSDictionary<NSString *, NSString *> *)headers
+            proxiedURL:(NSURL *)proxiedURL
+               loadURL:(NSURL *)loadURL;
+
 @end
 
 /** Private interface for AMP Runtime to interact with AmpWebViewer. */
@@ -38,6 +88,12 @@
  */
 - (void)AMPDocumentLoadedWithMessage:(AMPKWebViewerJsMessage *)message;
 
+/**
+ * This will be called when the shell couldn't attach the current article as a shadow document. The
+ * article is navigated to instead.
+ */
+- (void)shadowDocumentFailedWithMessage:(AMPKWebViewerJsMessage *)message;
+
 /** This will be called when the AMP runtime requests that the viewer enter full overlay mode. */
 - (void)requestFullOverlayMode;
 
@@ -55,6 +111,15 @@
 /** This should be called when the document sends the openChannel message. */
 - (void)channelOpenWithMessage:(AMPKWebViewerJsMessage *)message;
 
+/**
+ * Whether a frame loading @c request should be cancelled under the content blocking policy.
+ * Counts the request in blockedRequestCount if so.
+ */
+- (BOOL)shouldBlockFrameRequest:(NSURLRequest *)request;
+
+/** This will be called when the system terminates the web view's content process. */
+- (void)webContentProcessDidTerminate;
+
 @end
 
 /** Provide interface access for Unit Test. */
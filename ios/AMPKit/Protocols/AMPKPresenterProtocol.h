@@ -17,6 +17,7 @@
 #import <Foundation/Foundation.h>
 #import <UIKit/UIKit.h>
 
+@class AMPKWebViewerViewController;
 @protocol AMPKPaywallAccessProtocol;
 
 /** This protocol allows the caller to present a customer viewController. */
@@ -32,6 +33,19 @@
                requestId:(NSString *)requestId
       fromViewController:(UIViewController <AMPKPaywallAccessProtocol>*)fromViewController;
 
+@optional
+
+/**
+ * Present an AMP page the user tapped a link to. When implemented, links to AMP pages open in an
+ * AMP view from the viewer's pool, often already loaded, instead of going through
+ * presentEmbeddedLinkRequest:fromViewController:. The view is visible when this is called; set it
+ * back to not visible once it is dismissed and hand it back with AMPKViewerDataSource's
+ * releaseLinkedViewController:. Links in the presented page, AMP or not, go to
+ * presentEmbeddedLinkRequest:fromViewController: with it as the view controller.
+ */
+- (void)presentAmpWebViewerController:(AMPKWebViewerViewController *)ampWebViewerController
+                   fromViewController:(UIViewController *)fromViewController;
+
 @end
 
 @protocol AMPKPaywallAccessProtocol <NSObject>
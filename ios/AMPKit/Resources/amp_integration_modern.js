@@ -0,0 +1,175 @@
+/**
+ * Copyright 2020 The AMP HTML Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS-IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * The viewer side of the AMP messaging protocol for AMPKit's WKWebViews, for
+ * iOS 10 and later. It behaves like amp_integration.js, without the Closure
+ * Promise and MessageChannel polyfills the WebKit of iOS 10 doesn't need.
+ *
+ * Messages to the app are posted to the 'amp' script message handler; the app
+ * delivers messages with gws.amp.doc.messaging.receiveMessage(message).
+ */
+(function() {
+  'use strict';
+
+  /** Only AMP Docs served by the cache talk to the viewer, see matchesCDNURL:. */
+  const CACHE_HOST = 'cdn.ampproject.org';
+  const hostname = location.hostname;
+  if (hostname != CACHE_HOST &&
+      hostname.slice(-CACHE_HOST.length - 1) != '.' + CACHE_HOST) {
+    return;
+  }
+
+  const handler = window.webkit && window.webkit.messageHandlers &&
+      window.webkit.messageHandlers['amp'];
+  if (!handler) {
+    return;
+  }
+
+  const APP = '__AMPHTML__';
+  const CHANNEL_ID = 0;
+  const REQUEST = 'q';
+  const RESPONSE = 's';
+
+  let nextRequestId = 0;
+  /** @type {!Object<number, {resolve: function(*), reject: function(*)}>} */
+  const pendingRequests = {};
+  /** @type {?function(string, *, boolean):(!Promise|undefined)} */
+  let requestHandler = null;
+
+  /** @param {string} state exposed for debugging, as the closure build does. */
+  function setViewerState(state) {
+    window.viewerState = state;
+  }
+
+  /**
+   * @param {string} name
+   * @param {*} data
+   * @param {boolean=} rsvp whether a response is expected.
+   * @return {!Promise|undefined} resolves with the response when rsvp.
+   */
+  function sendRequest(name, data, rsvp) {
+    const requestId = nextRequestId++;
+    const message = {
+      type: REQUEST,
+      data,
+      app: APP,
+      channelid: CHANNEL_ID,
+      requestid: requestId,
+      name,
+    };
+    let response;
+    if (rsvp) {
+      message.rsvp = true;
+      response = new Promise((resolve, reject) => {
+        pendingRequests[requestId] = {resolve, reject};
+      });
+    }
+    try {
+      handler.postMessage(message);
+    } catch (e) {
+      if (!rsvp) {
+        throw e;
+      }
+      pendingRequests[requestId].reject(e);
+      delete pendingRequests[requestId];
+    }
+    return response;
+  }
+
+  /**
+   * @param {!Object} request
+   * @param {*} data
+   * @param {*=} error
+   */
+  function sendResponse(request, data, error) {
+    const message = {
+      type: RESPONSE,
+      data,
+      app: request.app,
+      channelid: request.channelid,
+      requestid: request.requestid,
+      name: request.name,
+    };
+    if (error !== undefined) {
+      message.error = error;
+    }
+    handler.postMessage(message);
+  }
+
+  /** @param {!Object} message a request from the app or a response to ours. */
+  function receiveMessage(message) {
+    if (message.type != REQUEST) {
+      const pending = pendingRequests[message.requestid];
+      if (pending) {
+        delete pendingRequests[message.requestid];
+        if (message.hasOwnProperty('error')) {
+          pending.reject(message.error);
+        } else {
+          pending.resolve(message.data);
+        }
+      }
+      return;
+    }
+
+    const rsvp = !!message.rsvp;
+    if (!requestHandler) {
+      if (rsvp) {
+        sendResponse(message, null, 'no handler found');
+      }
+      return;
+    }
+    const response = requestHandler(message.name, message.data, rsvp);
+    if (!rsvp) {
+      return;
+    }
+    if (response) {
+      response.then(data => sendResponse(message, data),
+          error => sendResponse(message, null, error));
+    } else {
+      sendResponse(message, null, 'invalid response from handler');
+    }
+  }
+
+  const gws = window.gws = window.gws || {};
+  const amp = gws.amp = gws.amp || {};
+  const doc = amp.doc = amp.doc || {};
+  const messaging = doc.messaging = doc.messaging || {};
+  messaging.receiveMessage = receiveMessage;
+
+  (window.AMP = window.AMP || []).push(AMP => {
+    try {
+      const viewer = AMP.viewer;
+      setViewerState('initializing');
+      const origin = viewer.getParam('origin');
+      setViewerState('channelPending');
+      sendRequest('channelOpen', {}, true).then(opened => {
+        if (!opened) {
+          return Promise.reject(opened);
+        }
+        requestHandler = viewer.receiveMessage.bind(viewer);
+        viewer.setMessageDeliverer(sendRequest, origin);
+        window.addEventListener('unload', () => sendRequest('unloaded', true));
+        setViewerState('channelOpen');
+      }).catch(error => {
+        setViewerState('channelFailedToOpen: ' + error);
+      });
+    } catch (e) {
+      setViewerState(e.stack || String(e));
+      throw e;
+    }
+  });
+})();
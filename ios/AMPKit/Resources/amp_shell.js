@@ -0,0 +1,277 @@
+/**
+ * Copyright 2020 The AMP HTML Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS-IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * The shell AMPKit keeps warm in a web view when it attaches AMP Docs as
+ * shadow documents rather than navigating to them. The shell page loads the
+ * shadow AMP runtime once; the app then attaches one article at a time:
+ *
+ *   ampkShell.attach(id, url, params)  starts a shadow document for url.
+ *   ampkShell.write(id, html)          streams the next chunk of its HTML.
+ *   ampkShell.close(id)                ends the stream.
+ *   ampkShell.detach()                 closes the current document.
+ *
+ * The shell page calls ampkShell.runtimeFailed(script) if the runtime script
+ * can't load. A script with a data-fallback-src, e.g. one served by the app's
+ * runtime cache, is retried from there first.
+ *
+ * Stale calls, for an id that is no longer attached, are ignored.
+ *
+ * The attached document talks to the app like a top level AMP Doc does with
+ * amp_integration.js: requests and responses are posted to the 'amp' script
+ * message handler and the app delivers messages with
+ * gws.amp.doc.messaging.receiveMessage(message). A document that can't be
+ * attached is reported with a shadowDocumentFailed request, after which the
+ * app navigates to it instead.
+ */
+(function() {
+  'use strict';
+
+  /**
+   * The shell is loaded under the cache subdomain of the documents it
+   * attaches, see shellURLForDocumentURL:. The app only attaches documents on
+   * one, see ampk_CacheSubdomainURL, and navigates to the others.
+   */
+  const CACHE_HOST = 'cdn.ampproject.org';
+  if (location.hostname.slice(-CACHE_HOST.length - 1) != '.' + CACHE_HOST) {
+    return;
+  }
+
+  /**
+   * The app swaps its message handler out and back in when the web view is
+   * reused, so it is looked up for every message rather than kept.
+   * @param {!Object} message
+   */
+  function post(message) {
+    const handler = window.webkit.messageHandlers['amp'];
+    if (handler) {
+      handler.postMessage(message);
+    }
+  }
+
+  if (!window.webkit || !window.webkit.messageHandlers) {
+    return;
+  }
+
+  const APP = '__AMPHTML__';
+  const CHANNEL_ID = 0;
+  const REQUEST = 'q';
+  const RESPONSE = 's';
+
+  let nextRequestId = 0;
+  /** @type {!Object<number, {resolve: function(*), reject: function(*)}>} */
+  let pendingRequests = {};
+
+  /** The attached document, if any. */
+  let current = null;
+  let runtimeFailed = false;
+
+  /**
+   * @param {string} name
+   * @param {*} data
+   * @param {boolean=} rsvp whether a response is expected.
+   * @return {!Promise|undefined} resolves with the response when rsvp.
+   */
+  function sendRequest(name, data, rsvp) {
+    const requestId = nextRequestId++;
+    const message = {
+      type: REQUEST,
+      data,
+      app: APP,
+      channelid: CHANNEL_ID,
+      requestid: requestId,
+      name,
+    };
+    let response;
+    if (rsvp) {
+      message.rsvp = true;
+      response = new Promise((resolve, reject) => {
+        pendingRequests[requestId] = {resolve, reject};
+      });
+    }
+    post(message);
+    return response;
+  }
+
+  /**
+   * @param {!Object} request
+   * @param {*} data
+   * @param {*=} error
+   */
+  function sendResponse(request, data, error) {
+    const message = {
+      type: RESPONSE,
+      data,
+      app: request.app,
+      channelid: request.channelid,
+      requestid: request.requestid,
+      name: request.name,
+    };
+    if (error !== undefined) {
+      message.error = error;
+    }
+    post(message);
+  }
+
+  /** @param {!Object} message a request from the app or a response to ours. */
+  function receiveMessage(message) {
+    if (message.type != REQUEST) {
+      const pending = pendingRequests[message.requestid];
+      if (pending) {
+        delete pendingRequests[message.requestid];
+        if (message.hasOwnProperty('error')) {
+          pending.reject(message.error);
+        } else {
+          pending.resolve(message.data);
+        }
+      }
+      return;
+    }
+
+    const rsvp = !!message.rsvp;
+    const shadowDoc = current && current.shadowDoc;
+    if (!shadowDoc) {
+      if (rsvp) {
+        sendResponse(message, null, 'no document attached');
+      }
+      return;
+    }
+    const response = shadowDoc.postMessage(message.name, message.data, rsvp);
+    if (!rsvp) {
+      return;
+    }
+    Promise.resolve(response).then(data => sendResponse(message, data),
+        error => sendResponse(message, null, error));
+  }
+
+  /**
+   * @param {number} id
+   * @param {*} error
+   */
+  function fail(id, error) {
+    if (current && current.id == id) {
+      detach();
+    }
+    sendRequest('shadowDocumentFailed', {id, error: String(error)});
+  }
+
+  /**
+   * @param {number} id
+   * @param {string} url the document's cache url, without the viewer fragment.
+   * @param {!Object<string, string>} params the viewer's init params.
+   */
+  function attach(id, url, params) {
+    detach();
+    if (runtimeFailed) {
+      fail(id, 'runtime failed to load');
+      return;
+    }
+    const host = document.createElement('div');
+    document.body.appendChild(host);
+    const attached = {id, host, shadowDoc: null, chunks: [], closed: false};
+    current = attached;
+
+    (window.AMP = window.AMP || []).push(AMP => {
+      if (current != attached) {
+        return;
+      }
+      try {
+        attached.shadowDoc = AMP.attachShadowDocAsStream(host, url, params);
+      } catch (e) {
+        fail(id, e);
+        return;
+      }
+      attached.shadowDoc.onMessage((name, data, rsvp) => {
+        if (current == attached) {
+          return sendRequest(name, data, rsvp);
+        }
+      });
+      attached.chunks.forEach(chunk => attached.shadowDoc.writer.write(chunk));
+      attached.chunks = null;
+      if (attached.closed) {
+        attached.shadowDoc.writer.close();
+      }
+    });
+  }
+
+  /**
+   * @param {number} id
+   * @param {string} html
+   */
+  function write(id, html) {
+    if (!current || current.id != id) {
+      return;
+    }
+    if (current.shadowDoc) {
+      current.shadowDoc.writer.write(html);
+    } else {
+      current.chunks.push(html);
+    }
+  }
+
+  /** @param {number} id */
+  function close(id) {
+    if (!current || current.id != id) {
+      return;
+    }
+    current.closed = true;
+    if (current.shadowDoc) {
+      current.shadowDoc.writer.close();
+    }
+  }
+
+  function detach() {
+    if (!current) {
+      return;
+    }
+    const attached = current;
+    current = null;
+    // Responses owed to the old document can't be delivered any more.
+    pendingRequests = {};
+    if (attached.shadowDoc) {
+      attached.shadowDoc.close();
+    }
+    attached.host.parentNode.removeChild(attached.host);
+  }
+
+  window.ampkShell = {
+    attach,
+    write,
+    close,
+    detach,
+    runtimeFailed(script) {
+      const fallbackSrc = script && script.getAttribute('data-fallback-src');
+      if (fallbackSrc) {
+        const fallback = document.createElement('script');
+        fallback.async = true;
+        fallback.src = fallbackSrc;
+        fallback.onerror = () => window.ampkShell.runtimeFailed(fallback);
+        document.head.appendChild(fallback);
+        return;
+      }
+      runtimeFailed = true;
+      if (current) {
+        fail(current.id, 'runtime failed to load');
+      }
+    },
+  };
+
+  const gws = window.gws = window.gws || {};
+  const amp = gws.amp = gws.amp || {};
+  const doc = amp.doc = amp.doc || {};
+  const messaging = doc.messaging = doc.messaging || {};
+  messaging.receiveMessage = receiveMessage;
+})();
@@ -0,0 +1,75 @@
+/**
+ * Copyright 2020 The AMP HTML Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS-IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+@class WKUserContentController;
+
+/**
+ * A set of third-party domains, such as ad and analytics hosts, whose requests are blocked in AMP
+ * viewers the user isn't looking at: neighbours loaded ahead of a swipe and prefetched viewers.
+ * The rules are lifted as soon as the viewer becomes visible. Set one on AMPKViewerDataSource to
+ * opt in.
+ *
+ * On iOS 11 and later every request to a blocked domain is stopped with a WKContentRuleList, which
+ * is compiled once and kept in WebKit's on-disk store across launches; a changed policy's earlier
+ * lists are removed, but never those of another live policy. On every version frames
+ * navigating to a blocked domain are cancelled, and those are the requests counted in
+ * AMPKWebViewerViewController's blockedRequestCount; WebKit doesn't report what rule lists block.
+ *
+ * Requests blocked while a viewer is hidden aren't retried when it becomes visible, so only block
+ * what the page can do without or requests again once it is visible.
+ */
+@interface AMPKContentBlockingPolicy : NSObject
+
+/**
+ * Blocks the major ad and analytics networks. AMP documents don't load ads while prerendering, so
+ * this mostly stops trackers and ads from pages that don't follow that rule.
+ */
++ (instancetype)defaultPolicy;
+
+/**
+ * @param blockedDomains Hosts to block, e.g. @"doubleclick.net"; subdomains are blocked too. Only
+ * third-party requests are blocked, so the document's own host is never affected.
+ */
+- (instancetype)initWithBlockedDomains:(NSArray<NSString *> *)blockedDomains
+    NS_DESIGNATED_INITIALIZER;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+@property(nonatomic, copy, readonly) NSArray<NSString *> *blockedDomains;
+
+/** Whether @c url's host is one of the blocked domains or a subdomain of one. */
+- (BOOL)blocksURL:(nullable NSURL *)url;
+
+/** The rules in WebKit's content rule list JSON format. */
+@property(nonatomic, copy, readonly) NSString *encodedContentRuleList;
+
+/**
+ * Starts blocking in the web view using @c userContentController. On iOS 11 and later this
+ * compiles the rule list, or loads it from disk, the first time it is needed. Does nothing on
+ * earlier versions.
+ */
+- (void)applyToUserContentController:(WKUserContentController *)userContentController;
+
+/** Stops blocking in the web view using @c userContentController. */
+- (void)removeFromUserContentController:(WKUserContentController *)userContentController;
+
+@end
+
+NS_ASSUME_NONNULL_END
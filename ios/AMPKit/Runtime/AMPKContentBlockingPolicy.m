@@ -0,0 +1,225 @@
+/**
+ * Copyright 2020 The AMP HTML Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS-IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#import "AMPKContentBlockingPolicy.h"
+
+#import <WebKit/WebKit.h>
+
+#import "AMPKContentBlockingPolicy_private.h"
+#import "AMPKRuntimeUtilities.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+// Compiled rule lists are stored under this prefix followed by a SHA-256 of the rules, so a changed
+// policy gets a new list and the old ones can be found and removed.
+static NSString *const kAMPKRuleListIdentifierPrefix = @"AMPKContentBlocking-";
+
+// The rule list identifiers of the policies alive in this process, counted once per policy. The
+// lists of any of them may be in use, so none of them are stale.
+static NSCountedSet<NSString *> *AMPKLiveRuleListIdentifiers(void) {
+  static NSCountedSet<NSString *> *identifiers;
+  static dispatch_once_t onceToken;
+  dispatch_once(&onceToken, ^{
+    identifiers = [[NSCountedSet alloc] init];
+  });
+  return identifiers;
+}
+
+@implementation AMPKContentBlockingPolicy {
+#if __IPHONE_OS_VERSION_MAX_ALLOWED >= 110000
+  WKContentRuleList *_ruleList;
+#endif
+  BOOL _loadingRuleList;
+  // User content controllers that asked for the rules while they were being compiled.
+  NSHashTable<WKUserContentController *> *_waitingControllers;
+}
+
++ (instancetype)defaultPolicy {
+  static AMPKContentBlockingPolicy *defaultPolicy;
+  static dispatch_once_t onceToken;
+  dispatch_once(&onceToken, ^{
+    defaultPolicy = [[AMPKContentBlockingPolicy alloc] initWithBlockedDomains:@[
+      @"doubleclick.net",
+      @"googlesyndication.com",
+      @"googleadservices.com",
+      @"google-analytics.com",
+      @"googletagmanager.com",
+      @"amazon-adsystem.com",
+      @"adnxs.com",
+      @"criteo.com",
+      @"criteo.net",
+      @"taboola.com",
+      @"outbrain.com",
+      @"scorecardresearch.com",
+      @"moatads.com",
+      @"chartbeat.com",
+      @"quantserve.com",
+    ]];
+  });
+  return defaultPolicy;
+}
+
+- (instancetype)initWithBlockedDomains:(NSArray<NSString *> *)blockedDomains {
+  self = [super init];
+  if (self) {
+    NSMutableArray<NSString *> *domains = [NSMutableArray arrayWithCapacity:blockedDomains.count];
+    for (NSString *domain in blockedDomains) {
+      [domains addObject:[domain lowercaseString]];
+    }
+    _blockedDomains = [domains copy];
+    _encodedContentRuleList = [self encodeContentRuleList];
+    NSData *encodedData = [_encodedContentRuleList dataUsingEncoding:NSUTF8StringEncoding];
+    _ruleListIdentifier =
+        [kAMPKRuleListIdentifierPrefix stringByAppendingString:AMPKSHA256HexString(encodedData)];
+    _waitingControllers = [NSHashTable weakObjectsHashTable];
+    NSCountedSet<NSString *> *liveIdentifiers = AMPKLiveRuleListIdentifiers();
+    @synchronized(liveIdentifiers) {
+      [liveIdentifiers addObject:_ruleListIdentifier];
+    }
+  }
+  return self;
+}
+
+- (void)dealloc {
+  NSCountedSet<NSString *> *liveIdentifiers = AMPKLiveRuleListIdentifiers();
+  @synchronized(liveIdentifiers) {
+    [liveIdentifiers removeObject:_ruleListIdentifier];
+  }
+}
+
+- (BOOL)blocksURL:(nullable NSURL *)url {
+  NSString *host = [url.host lowercaseString];
+  if (!host) {
+    return NO;
+  }
+  for (NSString *domain in _blockedDomains) {
+    if ([host isEqualToString:domain] ||
+        [host hasSuffix:[@"." stringByAppendingString:domain]]) {
+      return YES;
+    }
+  }
+  return NO;
+}
+
+- (void)applyToUserContentController:(WKUserContentController *)userContentController {
+#if __IPHONE_OS_VERSION_MAX_ALLOWED >= 110000
+  if (@available(iOS 11.0, *)) {
+    if (_ruleList) {
+      [userContentController addContentRuleList:_ruleList];
+      return;
+    }
+    [_waitingControllers addObject:userContentController];
+    [self loadRuleList];
+  }
+#endif
+}
+
+- (void)removeFromUserContentController:(WKUserContentController *)userContentController {
+  [_waitingControllers removeObject:userContentController];
+#if __IPHONE_OS_VERSION_MAX_ALLOWED >= 110000
+  if (@available(iOS 11.0, *)) {
+    if (_ruleList) {
+      [userContentController removeContentRuleList:_ruleList];
+    }
+  }
+#endif
+}
+
+#pragma mark - Private
+
++ (BOOL)isRuleListIdentifierLive:(NSString *)identifier {
+  NSCountedSet<NSString *> *liveIdentifiers = AMPKLiveRuleListIdentifiers();
+  @synchronized(liveIdentifiers) {
+    return [liveIdentifiers containsObject:identifier];
+  }
+}
+
+- (NSString *)encodeContentRuleList {
+  NSMutableArray<NSDictionary *> *rules = [NSMutableArray arrayWithCapacity:_blockedDomains.count];
+  for (NSString *domain in _blockedDomains) {
+    NSString *escapedDomain = [domain stringByReplacingOccurrencesOfString:@"."
+                                                                withString:@"\\."];
+    NSString *urlFilter =
+        [NSString stringWithFormat:@"^https?://([^/]*\\.)?%@[:/]", escapedDomain];
+    [rules addObject:@{
+      @"trigger" : @{ @"url-filter" : urlFilter, @"load-type" : @[ @"third-party" ] },
+      @"action" : @{ @"type" : @"block" },
+    }];
+  }
+  NSData *data = [NSJSONSerialization dataWithJSONObject:rules options:0 error:nil];
+  return [[NSString alloc] initWithData:data encoding:NSUTF8StringEncoding];
+}
+
+#if __IPHONE_OS_VERSION_MAX_ALLOWED >= 110000
+- (void)loadRuleList API_AVAILABLE(ios(11.0)) {
+  if (_loadingRuleList) {
+    return;
+  }
+  _loadingRuleList = YES;
+
+  NSString *identifier = _ruleListIdentifier;
+  WKContentRuleListStore *store = [WKContentRuleListStore defaultStore];
+  __weak AMPKContentBlockingPolicy *weakSelf = self;
+  void (^didLoad)(WKContentRuleList *, NSError *) = ^(WKContentRuleList *ruleList, NSError *error) {
+    AMPKContentBlockingPolicy *strongSelf = weakSelf;
+    if (error) {
+      NSLog(@"AMPKit could not compile its content blocking rules\n%@\n", error);
+    }
+    [strongSelf didLoadRuleList:ruleList];
+  };
+  [store lookUpContentRuleListForIdentifier:identifier
+                          completionHandler:^(WKContentRuleList *ruleList, NSError *error) {
+    if (ruleList) {
+      didLoad(ruleList, nil);
+      return;
+    }
+    [store compileContentRuleListForIdentifier:identifier
+                        encodedContentRuleList:self->_encodedContentRuleList
+                             completionHandler:didLoad];
+    [self removeStaleRuleListsFromStore:store];
+  }];
+}
+
+- (void)didLoadRuleList:(nullable WKContentRuleList *)ruleList API_AVAILABLE(ios(11.0)) {
+  _loadingRuleList = NO;
+  _ruleList = ruleList;
+  if (ruleList) {
+    for (WKUserContentController *userContentController in _waitingControllers) {
+      [userContentController addContentRuleList:ruleList];
+    }
+  }
+  [_waitingControllers removeAllObjects];
+}
+
+// Rule lists compiled for earlier versions of a policy would otherwise stay on disk for good. The
+// lists of every policy alive in this process are kept, this one's included; those of policies the
+// app hasn't created yet in this launch are compiled again when it does.
+- (void)removeStaleRuleListsFromStore:(WKContentRuleListStore *)store API_AVAILABLE(ios(11.0)) {
+  [store getAvailableContentRuleListIdentifiers:^(NSArray<NSString *> *identifiers) {
+    for (NSString *available in identifiers) {
+      if ([available hasPrefix:kAMPKRuleListIdentifierPrefix] &&
+          ![AMPKContentBlockingPolicy isRuleListIdentifierLive:available]) {
+        [store removeContentRuleListForIdentifier:available completionHandler:^(NSError *error) {
+        }];
+      }
+    }
+  }];
+}
+#endif
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,86 @@
+/**
+ * Copyright 2020 The AMP HTML Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS-IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/** The URL scheme AMPKRuntimeCache serves its scripts under, e.g. ampk-runtime://host/v0.js. */
+extern NSString *const AMPKRuntimeCacheURLScheme;
+
+/**
+ * Keeps an on-disk copy of the AMP runtime and a set of extensions, separate from WebKit's HTTP
+ * cache, which is shared with everything else and evicted without notice. The copies are kept as
+ * one version: when the runtime changes every script is downloaded again before the new set is
+ * used, so the runtime and its extensions always match.
+ *
+ * On iOS 11 and later the cache is also a WKURLSchemeHandler for AMPKRuntimeCacheURLScheme:
+ * ampk-runtime:// URLs are answered from disk, or from the network on a miss, whose response is
+ * then kept. WKURLSchemeHandler can't take over https URLs, so this only helps pages that refer to
+ * scripts through runtimeCacheURLForScriptURL:, such as the shell AMPKWebViewerViewController
+ * attaches shadow documents to. Set the cache on AMPKViewerDataSource to register it with every
+ * web view, refresh it and count its hits in the data source's metrics.
+ */
+@interface AMPKRuntimeCache : NSObject
+
+/**
+ * A cache in the app's caches directory of the shadow runtime served by https://cdn.ampproject.org,
+ * the only script AMPKit refers to through AMPKRuntimeCacheURLScheme.
+ */
++ (instancetype)defaultCache;
+
+/**
+ * @param directoryURL Where to keep the scripts. Created when first needed.
+ * @param scriptURLs The scripts to keep. The first must be the runtime, whose ETag versions the
+ * set.
+ */
+- (instancetype)initWithDirectoryURL:(NSURL *)directoryURL
+                          scriptURLs:(NSArray<NSURL *> *)scriptURLs NS_DESIGNATED_INITIALIZER;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+@property(nonatomic, copy, readonly) NSArray<NSURL *> *scriptURLs;
+
+/** The version of the scripts on disk, nil until they have been downloaded once. */
+@property(nonatomic, copy, readonly, nullable) NSString *version;
+
+/**
+ * Checks the runtime for a new version in the background and, if there is one, downloads the
+ * scripts again. Requests are served from the previous version until the new one is complete.
+ * AMPKViewerDataSource calls it when the cache is set; call it yourself for a cache that isn't
+ * set on a data source.
+ * @param completion Called on the main queue, with an error if the scripts couldn't be updated.
+ */
+- (void)refreshWithCompletion:(nullable void (^)(NSError *_Nullable error))completion;
+
+/** The copy of the script at @c url, or nil if it isn't on disk. Counts a hit or a miss. */
+- (nullable NSData *)scriptDataForURL:(NSURL *)url;
+
+/** @c url, an https script URL, under AMPKRuntimeCacheURLScheme. */
++ (NSURL *)runtimeCacheURLForScriptURL:(NSURL *)url;
+
+/** The number of script requests answered from disk. */
+@property(nonatomic, readonly) NSUInteger hitCount;
+
+/** The number of script requests that had to go to the network. */
+@property(nonatomic, readonly) NSUInteger missCount;
+
+/** The bytes served from disk rather than downloaded. */
+@property(nonatomic, readonly) unsigned long long bytesSaved;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,460 @@
+/**
+ * Copyright 2020 The AMP HTML Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS-IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#import "AMPKRuntimeCache.h"
+
+#import <WebKit/WebKit.h>
+
+#import "AMPKRuntimeCache_private.h"
+#import "AMPKRuntimeUtilities.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+NSString *const AMPKRuntimeCacheURLScheme = @"ampk-runtime";
+
+static NSString *const kAMPKRuntimeCacheErrorDomain = @"AMPKRuntimeCache";
+// Holds the current version, next to one directory per version.
+static NSString *const kVersionFileName = @"version";
+
+static NSString *const kDefaultCacheOrigin = @"https://cdn.ampproject.org";
+// Only scripts the app itself refers to through AMPKRuntimeCacheURLScheme are ever requested from
+// the cache: the shadow runtime, loaded by the shell AMPKWebViewerViewController attaches shadow
+// documents to. Documents load v0.js and their extensions from https URLs, which WebKit doesn't
+// hand to a scheme handler.
+static NSArray<NSString *> *kDefaultScriptPaths(void) {
+  return @[ @"/shadow-v0.js" ];
+}
+
+// Header lookups on NSHTTPURLResponse are only case insensitive from iOS 13.
+static NSString *_Nullable AMPKHeaderValue(NSHTTPURLResponse *response, NSString *name) {
+  __block NSString *value;
+  [response.allHeaderFields enumerateKeysAndObjectsUsingBlock:^(id key, id obj, BOOL *stop) {
+    if ([key isKindOfClass:[NSString class]] && [obj isKindOfClass:[NSString class]] &&
+        [key caseInsensitiveCompare:name] == NSOrderedSame) {
+      value = obj;
+      *stop = YES;
+    }
+  }];
+  return value;
+}
+
+// What versions the scripts downloaded with the runtime in @c response.
+static NSString *AMPKRuntimeVersion(NSHTTPURLResponse *response, NSData *data) {
+  return AMPKHeaderValue(response, @"ETag") ?: AMPKHeaderValue(response, @"Last-Modified") ?:
+      [NSString stringWithFormat:@"%lu", (unsigned long)data.length];
+}
+
+#if __IPHONE_OS_VERSION_MAX_ALLOWED >= 110000
+API_AVAILABLE(ios(11.0))
+@interface AMPKRuntimeCache (URLSchemeHandler) <WKURLSchemeHandler>
+@end
+#endif
+
+@implementation AMPKRuntimeCache {
+  NSURL *_directoryURL;
+  // Guards the version, the counters and the files on disk.
+  dispatch_queue_t _queue;
+  NSString *_version;
+  NSUInteger _hitCount;
+  NSUInteger _missCount;
+  unsigned long long _bytesSaved;
+  // The scheme tasks that haven't finished or been stopped. Only touched on the main queue.
+  NSMutableSet *_activeTasks;
+  // See setScriptHandler:forWebView:. Only touched on the main queue.
+  NSMapTable<WKWebView *, void (^)(BOOL, NSUInteger)> *_scriptHandlers;
+}
+
++ (instancetype)defaultCache {
+  static AMPKRuntimeCache *defaultCache;
+  static dispatch_once_t onceToken;
+  dispatch_once(&onceToken, ^{
+    NSURL *cachesURL = [[NSFileManager defaultManager] URLsForDirectory:NSCachesDirectory
+                                                              inDomains:NSUserDomainMask][0];
+    NSMutableArray<NSURL *> *scriptURLs = [NSMutableArray array];
+    for (NSString *path in kDefaultScriptPaths()) {
+      NSString *url = [kDefaultCacheOrigin stringByAppendingString:path];
+      [scriptURLs addObject:[NSURL URLWithString:url]];
+    }
+    defaultCache = [[AMPKRuntimeCache alloc]
+        initWithDirectoryURL:[cachesURL URLByAppendingPathComponent:@"AMPKRuntimeCache"]
+                  scriptURLs:scriptURLs];
+  });
+  return defaultCache;
+}
+
+- (instancetype)initWithDirectoryURL:(NSURL *)directoryURL
+                          scriptURLs:(NSArray<NSURL *> *)scriptURLs {
+  NSAssert(scriptURLs.count > 0, @"The runtime cache needs at least the runtime script");
+  self = [super init];
+  if (self) {
+    _directoryURL = [directoryURL copy];
+    _scriptURLs = [scriptURLs copy];
+    _queue = dispatch_queue_create("com.google.ampkit.runtime-cache", DISPATCH_QUEUE_SERIAL);
+    _activeTasks = [NSMutableSet set];
+    _scriptHandlers = [NSMapTable weakToStrongObjectsMapTable];
+    NSURL *versionURL = [_directoryURL URLByAppendingPathComponent:kVersionFileName];
+    _version = [NSString stringWithContentsOfURL:versionURL
+                                        encoding:NSUTF8StringEncoding
+                                           error:nil];
+  }
+  return self;
+}
+
+- (nullable NSString *)version {
+  __block NSString *version;
+  dispatch_sync(_queue, ^{
+    version = self->_version;
+  });
+  return version;
+}
+
+- (NSUInteger)hitCount {
+  __block NSUInteger hitCount;
+  dispatch_sync(_queue, ^{
+    hitCount = self->_hitCount;
+  });
+  return hitCount;
+}
+
+- (NSUInteger)missCount {
+  __block NSUInteger missCount;
+  dispatch_sync(_queue, ^{
+    missCount = self->_missCount;
+  });
+  return missCount;
+}
+
+- (unsigned long long)bytesSaved {
+  __block unsigned long long bytesSaved;
+  dispatch_sync(_queue, ^{
+    bytesSaved = self->_bytesSaved;
+  });
+  return bytesSaved;
+}
+
+- (nullable NSData *)scriptDataForURL:(NSURL *)url {
+  __block NSData *data;
+  dispatch_sync(_queue, ^{
+    data = [self queueScriptDataForURL:url];
+  });
+  return data;
+}
+
+- (void)setScriptHandler:(nullable void (^)(BOOL hit, NSUInteger length))handler
+              forWebView:(WKWebView *)webView {
+  if (handler) {
+    [_scriptHandlers setObject:[handler copy] forKey:webView];
+  } else {
+    [_scriptHandlers removeObjectForKey:webView];
+  }
+}
+
++ (NSURL *)runtimeCacheURLForScriptURL:(NSURL *)url {
+  NSURLComponents *components = [NSURLComponents componentsWithURL:url resolvingAgainstBaseURL:NO];
+  components.scheme = AMPKRuntimeCacheURLScheme;
+  return components.URL ?: url;
+}
+
+#pragma mark - Refreshing
+
+- (void)refreshWithCompletion:(nullable void (^)(NSError *_Nullable error))completion {
+  void (^finish)(NSError *_Nullable) = ^(NSError *_Nullable error) {
+    if (completion) {
+      dispatch_async(dispatch_get_main_queue(), ^{
+        completion(error);
+      });
+    }
+  };
+
+  NSURL *runtimeURL = _scriptURLs.firstObject;
+  NSString *currentVersion = self.version;
+  NSMutableURLRequest *request = [NSMutableURLRequest requestWithURL:runtimeURL];
+  if (currentVersion && [self hasAllScriptsForVersion:currentVersion]) {
+    [request setValue:currentVersion forHTTPHeaderField:@"If-None-Match"];
+  }
+  request.cachePolicy = NSURLRequestReloadIgnoringLocalCacheData;
+
+  [[[NSURLSession sharedSession] dataTaskWithRequest:request
+      completionHandler:^(NSData *_Nullable data, NSURLResponse *_Nullable response,
+                          NSError *_Nullable error) {
+    NSHTTPURLResponse *httpResponse = (NSHTTPURLResponse *)response;
+    if (error || ![httpResponse isKindOfClass:[NSHTTPURLResponse class]]) {
+      finish(error ?: [self errorWithDescription:@"No HTTP response for the runtime"]);
+      return;
+    }
+    if (httpResponse.statusCode == 304) {
+      finish(nil);
+      return;
+    }
+    if (httpResponse.statusCode != 200 || !data) {
+      finish([self errorWithDescription:@"Unexpected response for the runtime"]);
+      return;
+    }
+    NSString *version = AMPKRuntimeVersion(httpResponse, data);
+    if ([version isEqualToString:currentVersion] && [self hasAllScriptsForVersion:version]) {
+      finish(nil);
+      return;
+    }
+    [self downloadScriptsForVersion:version runtimeData:data completion:finish];
+  }] resume];
+}
+
+- (void)downloadScriptsForVersion:(NSString *)version
+                      runtimeData:(NSData *)runtimeData
+                       completion:(void (^)(NSError *_Nullable error))completion {
+  NSMutableDictionary<NSURL *, NSData *> *scripts = [NSMutableDictionary dictionary];
+  scripts[_scriptURLs.firstObject] = runtimeData;
+  __block NSError *downloadError;
+  dispatch_group_t group = dispatch_group_create();
+  for (NSURL *url in [_scriptURLs subarrayWithRange:NSMakeRange(1, _scriptURLs.count - 1)]) {
+    dispatch_group_enter(group);
+    [[[NSURLSession sharedSession] dataTaskWithURL:url
+        completionHandler:^(NSData *_Nullable data, NSURLResponse *_Nullable response,
+                            NSError *_Nullable error) {
+      NSInteger statusCode = [response isKindOfClass:[NSHTTPURLResponse class]] ?
+          ((NSHTTPURLResponse *)response).statusCode : 0;
+      dispatch_async(self->_queue, ^{
+        if (data && statusCode == 200) {
+          scripts[url] = data;
+        } else {
+          downloadError = error ?: [self errorWithDescription:url.absoluteString];
+        }
+        dispatch_group_leave(group);
+      });
+    }] resume];
+  }
+
+  dispatch_group_notify(group, _queue, ^{
+    if (downloadError) {
+      // Keep serving the previous version rather than a mix of the two.
+      completion(downloadError);
+      return;
+    }
+    NSError *error;
+    [self queueInstallScripts:scripts version:version error:&error];
+    completion(error);
+  });
+}
+
+- (BOOL)installScripts:(NSDictionary<NSURL *, NSData *> *)scripts
+               version:(NSString *)version
+                 error:(NSError **)error {
+  __block BOOL installed;
+  __block NSError *installError;
+  dispatch_sync(_queue, ^{
+    installed = [self queueInstallScripts:scripts version:version error:&installError];
+  });
+  if (error) {
+    *error = installError;
+  }
+  return installed;
+}
+
+- (void)storeScriptData:(NSData *)data
+                 forURL:(NSURL *)url
+               response:(NSHTTPURLResponse *)response {
+  dispatch_sync(_queue, ^{
+    [self queueStoreScriptData:data forURL:url response:response];
+  });
+}
+
+#pragma mark - Private, on the queue
+
+- (nullable NSData *)queueScriptDataForURL:(NSURL *)url {
+  NSData *data = nil;
+  if (_version && [_scriptURLs containsObject:url]) {
+    data = [NSData dataWithContentsOfURL:[self fileURLForScriptURL:url version:_version]];
+  }
+  if (data) {
+    _hitCount++;
+    _bytesSaved += data.length;
+  } else {
+    _missCount++;
+  }
+  return data;
+}
+
+- (BOOL)queueInstallScripts:(NSDictionary<NSURL *, NSData *> *)scripts
+                    version:(NSString *)version
+                      error:(NSError **)error {
+  NSFileManager *fileManager = [NSFileManager defaultManager];
+  NSURL *versionDirectoryURL = [self directoryURLForVersion:version];
+  if (![fileManager createDirectoryAtURL:versionDirectoryURL
+             withIntermediateDirectories:YES
+                              attributes:nil
+                                   error:error]) {
+    return NO;
+  }
+  for (NSURL *url in scripts) {
+    if (![scripts[url] writeToURL:[self fileURLForScriptURL:url version:version]
+                          options:NSDataWritingAtomic
+                            error:error]) {
+      return NO;
+    }
+  }
+  NSURL *versionURL = [_directoryURL URLByAppendingPathComponent:kVersionFileName];
+  if (![version writeToURL:versionURL atomically:YES encoding:NSUTF8StringEncoding error:error]) {
+    return NO;
+  }
+  _version = [version copy];
+
+  for (NSURL *url in [fileManager contentsOfDirectoryAtURL:_directoryURL
+                                includingPropertiesForKeys:nil
+                                                   options:0
+                                                     error:nil]) {
+    if (![url.lastPathComponent isEqualToString:kVersionFileName] &&
+        ![url.lastPathComponent isEqualToString:versionDirectoryURL.lastPathComponent]) {
+      [fileManager removeItemAtURL:url error:nil];
+    }
+  }
+  return YES;
+}
+
+// Keeps a script that was downloaded on a miss. The runtime, which versions the set, becomes the
+// current version if it is a new one; the other scripts join the current version, which the next
+// refresh completes or replaces.
+- (void)queueStoreScriptData:(NSData *)data
+                      forURL:(NSURL *)url
+                    response:(NSHTTPURLResponse *)response {
+  if ([url isEqual:_scriptURLs.firstObject]) {
+    NSString *version = AMPKRuntimeVersion(response, data);
+    if (![version isEqualToString:_version]) {
+      [self queueInstallScripts:@{url : data} version:version error:nil];
+      return;
+    }
+  }
+  if (_version) {
+    [data writeToURL:[self fileURLForScriptURL:url version:_version]
+             options:NSDataWritingAtomic
+               error:nil];
+  }
+}
+
+#pragma mark - Private
+
+- (BOOL)hasAllScriptsForVersion:(NSString *)version {
+  NSFileManager *fileManager = [NSFileManager defaultManager];
+  for (NSURL *url in _scriptURLs) {
+    if (![fileManager fileExistsAtPath:[self fileURLForScriptURL:url version:version].path]) {
+      return NO;
+    }
+  }
+  return YES;
+}
+
+// ETags are quoted and may hold any character, so each version gets a directory named after a
+// digest of it. Unlike -hash, it is the same on every launch and two versions never share one.
+- (NSURL *)directoryURLForVersion:(NSString *)version {
+  NSString *name = [@"v" stringByAppendingString:
+                             AMPKSHA256HexString([version dataUsingEncoding:NSUTF8StringEncoding])];
+  return [_directoryURL URLByAppendingPathComponent:name isDirectory:YES];
+}
+
+- (NSURL *)fileURLForScriptURL:(NSURL *)url version:(NSString *)version {
+  NSString *name = [[url.host stringByAppendingString:url.path]
+      stringByReplacingOccurrencesOfString:@"/" withString:@"_"];
+  return [[self directoryURLForVersion:version] URLByAppendingPathComponent:name];
+}
+
+- (NSError *)errorWithDescription:(NSString *)description {
+  return [NSError errorWithDomain:kAMPKRuntimeCacheErrorDomain
+                             code:0
+                         userInfo:@{ NSLocalizedDescriptionKey : description }];
+}
+
++ (NSURL *)scriptURLForRuntimeCacheURL:(NSURL *)url {
+  NSURLComponents *components = [NSURLComponents componentsWithURL:url resolvingAgainstBaseURL:NO];
+  components.scheme = @"https";
+  return components.URL ?: url;
+}
+
+#if __IPHONE_OS_VERSION_MAX_ALLOWED >= 110000
+#pragma mark - WKURLSchemeHandler
+
+- (void)webView:(WKWebView *)webView
+    startURLSchemeTask:(id<WKURLSchemeTask>)urlSchemeTask API_AVAILABLE(ios(11.0)) {
+  NSURL *scriptURL = [AMPKRuntimeCache scriptURLForRuntimeCacheURL:urlSchemeTask.request.URL];
+  [_activeTasks addObject:urlSchemeTask];
+  void (^scriptHandler)(BOOL, NSUInteger) = [_scriptHandlers objectForKey:webView];
+  dispatch_async(_queue, ^{
+    NSData *data = [self queueScriptDataForURL:scriptURL];
+    dispatch_async(dispatch_get_main_queue(), ^{
+      if (scriptHandler) {
+        scriptHandler(data != nil, data.length);
+      }
+    });
+    if (data) {
+      dispatch_async(dispatch_get_main_queue(), ^{
+        [self finishTask:urlSchemeTask statusCode:200 data:data error:nil];
+      });
+      return;
+    }
+    [[[NSURLSession sharedSession] dataTaskWithURL:scriptURL
+        completionHandler:^(NSData *_Nullable networkData, NSURLResponse *_Nullable response,
+                            NSError *_Nullable error) {
+      NSHTTPURLResponse *httpResponse = [response isKindOfClass:[NSHTTPURLResponse class]] ?
+          (NSHTTPURLResponse *)response : nil;
+      NSInteger statusCode = httpResponse.statusCode;
+      if (networkData && statusCode == 200 && [self.scriptURLs containsObject:scriptURL]) {
+        dispatch_async(self->_queue, ^{
+          [self queueStoreScriptData:networkData forURL:scriptURL response:httpResponse];
+        });
+      }
+      dispatch_async(dispatch_get_main_queue(), ^{
+        [self finishTask:urlSchemeTask statusCode:statusCode data:networkData error:error];
+      });
+    }] resume];
+  });
+}
+
+- (void)webView:(WKWebView *)webView
+    stopURLSchemeTask:(id<WKURLSchemeTask>)urlSchemeTask API_AVAILABLE(ios(11.0)) {
+  [_activeTasks removeObject:urlSchemeTask];
+}
+
+// WebKit raises if a stopped task is answered, so this checks the task is still active.
+- (void)finishTask:(id<WKURLSchemeTask>)urlSchemeTask
+        statusCode:(NSInteger)statusCode
+              data:(nullable NSData *)data
+             error:(nullable NSError *)error API_AVAILABLE(ios(11.0)) {
+  if (![_activeTasks containsObject:urlSchemeTask]) {
+    return;
+  }
+  [_activeTasks removeObject:urlSchemeTask];
+  if (!data) {
+    [urlSchemeTask didFailWithError:error ?: [self errorWithDescription:@"No data"]];
+    return;
+  }
+  NSDictionary<NSString *, NSString *> *headerFields = @{
+    @"Content-Type" : @"application/javascript; charset=utf-8",
+    @"Content-Length" : [NSString stringWithFormat:@"%lu", (unsigned long)data.length],
+    // AMP documents load their scripts with crossorigin="anonymous".
+    @"Access-Control-Allow-Origin" : @"*",
+  };
+  NSHTTPURLResponse *response =
+      [[NSHTTPURLResponse alloc] initWithURL:urlSchemeTask.request.URL
+                                  statusCode:statusCode
+                                 HTTPVersion:@"HTTP/1.1"
+                                headerFields:headerFields];
+  [urlSchemeTask didReceiveResponse:response];
+  [urlSchemeTask didReceiveData:data];
+  [urlSchemeTask didFinish];
+}
+#endif
+
+@end
+
+NS_ASSUME_NONNULL_END
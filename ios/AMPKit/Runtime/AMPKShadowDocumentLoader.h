@@ -0,0 +1,82 @@
+/**
+ * Copyright 2020 The AMP HTML Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS-IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * Fetches an AMP Doc natively so it can be streamed into a shadow document, see
+ * AMPKWebViewerViewController's usesShadowDocuments. The HTML is handed over as it arrives, in
+ * chunks that always end on a whole UTF-8 character.
+ *
+ * Only documents that can be attached are streamed: the load fails before the first chunk if the
+ * response isn't a successful text/html one, and the caller navigates to the document instead.
+ * Redirects aren't followed either, so the request's cookies only ever go to its own host.
+ *
+ * The loader doesn't use the shared cookie storage, which WKWebView doesn't see: the caller puts
+ * the web view's cookies on the request and stores the ones the response sets.
+ */
+@interface AMPKShadowDocumentLoader : NSObject
+
+/**
+ * The URL the shell for the document at @c documentURL is loaded under, the root of the
+ * document's own cache origin, e.g. https://www-example-com.cdn.ampproject.org/. Like a navigated
+ * document, an attached one then only shares cookies, storage and CORS origin with its publisher.
+ */
++ (NSURL *)shellURLForDocumentURL:(NSURL *)documentURL;
+
+/** The shadow AMP runtime on https://cdn.ampproject.org. */
++ (NSURL *)shadowRuntimeURL;
+
+/** The shell document, which loads the shadow AMP runtime from shadowRuntimeURL. */
++ (NSString *)shellHTML;
+
+/**
+ * The shell document, loading the shadow AMP runtime from @c runtimeURL, e.g. its
+ * AMPKRuntimeCache URL. If that fails the shell loads shadowRuntimeURL instead.
+ */
++ (NSString *)shellHTMLWithRuntimeURL:(NSURL *)runtimeURL;
+
+/**
+ * Starts loading @c request. The handlers are called on the main queue, and none once the load is
+ * cancelled.
+ * @param cookieHandler Called with the cookies the response sets, if any, before the first chunk.
+ * @param chunkHandler Called with each chunk of the document's HTML.
+ * @param completion Called once the whole document has been handed over, or with an error.
+ */
+- (instancetype)initWithRequest:(NSURLRequest *)request
+                  cookieHandler:(void (^)(NSArray<NSHTTPCookie *> *cookies))cookieHandler
+                   chunkHandler:(void (^)(NSString *html))chunkHandler
+                     completion:(void (^)(NSError *_Nullable error))completion
+    NS_DESIGNATED_INITIALIZER;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+/** Stops the load. */
+- (void)cancel;
+
+/** The cookies of @c cookies a browser would send with a request for @c url. */
++ (NSArray<NSHTTPCookie *> *)cookiesForURL:(NSURL *)url
+                               fromCookies:(NSArray<NSHTTPCookie *> *)cookies;
+
+/** The length of the longest prefix of @c bytes that doesn't end in the middle of a character. */
++ (NSUInteger)lengthOfCompleteUTF8CharactersInBytes:(const uint8_t *)bytes
+                                             length:(NSUInteger)length;
+
+@end
+
+NS_ASSUME_NONNULL_END
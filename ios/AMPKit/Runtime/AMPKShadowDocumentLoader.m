@@ -0,0 +1,320 @@
+/**
+ * Copyright 2020 The AMP HTML Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS-IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#import "AMPKShadowDocumentLoader.h"
+
+#import "AMPKRuntimeUtilities.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+static NSString *const kAMPKShadowDocumentErrorDomain = @"AMPKShadowDocumentLoader";
+static NSString *const kAMPKShadowRuntimeURL = @"https://cdn.ampproject.org/shadow-v0.js";
+
+typedef NS_ENUM(NSInteger, AMPKShadowDocumentErrorCode) {
+  AMPKShadowDocumentErrorCodeUnexpectedResponse,
+  AMPKShadowDocumentErrorCodeInvalidEncoding,
+};
+
+@interface AMPKShadowDocumentLoader ()
+
+- (void)didReceiveResponse:(NSURLResponse *)response
+         completionHandler:(void (^)(NSURLSessionResponseDisposition disposition))completionHandler;
+- (void)didReceiveCookiesFromResponse:(NSURLResponse *)response;
+- (void)didReceiveData:(NSData *)data;
+- (void)didCompleteWithError:(nullable NSError *)error;
+
+@end
+
+// Hands the callbacks of the session all loaders share to the loader of each task, so documents
+// are fetched over the same connections.
+@interface AMPKShadowDocumentSessionDelegate : NSObject <NSURLSessionDataDelegate>
+@end
+
+@implementation AMPKShadowDocumentSessionDelegate {
+  NSMutableDictionary<NSNumber *, AMPKShadowDocumentLoader *> *_loaders;
+}
+
++ (instancetype)sharedDelegate {
+  static AMPKShadowDocumentSessionDelegate *sharedDelegate;
+  static dispatch_once_t onceToken;
+  dispatch_once(&onceToken, ^{
+    sharedDelegate = [[AMPKShadowDocumentSessionDelegate alloc] init];
+  });
+  return sharedDelegate;
+}
+
+- (instancetype)init {
+  self = [super init];
+  if (self) {
+    _loaders = [[NSMutableDictionary alloc] init];
+  }
+  return self;
+}
+
+- (NSURLSession *)session {
+  static NSURLSession *session;
+  static dispatch_once_t onceToken;
+  dispatch_once(&onceToken, ^{
+    // Cookies are the web view's, see initWithRequest:.
+    NSURLSessionConfiguration *configuration =
+        [NSURLSessionConfiguration defaultSessionConfiguration];
+    configuration.HTTPCookieStorage = nil;
+    configuration.HTTPCookieAcceptPolicy = NSHTTPCookieAcceptPolicyNever;
+    configuration.HTTPShouldSetCookies = NO;
+    session = [NSURLSession sessionWithConfiguration:configuration
+                                            delegate:self
+                                       delegateQueue:[NSOperationQueue mainQueue]];
+  });
+  return session;
+}
+
+- (void)setLoader:(nullable AMPKShadowDocumentLoader *)loader forTask:(NSURLSessionTask *)task {
+  _loaders[@(task.taskIdentifier)] = loader;
+}
+
+- (void)URLSession:(NSURLSession *)session
+              dataTask:(NSURLSessionDataTask *)dataTask
+    didReceiveResponse:(NSURLResponse *)response
+     completionHandler:(void (^)(NSURLSessionResponseDisposition))completionHandler {
+  AMPKShadowDocumentLoader *loader = _loaders[@(dataTask.taskIdentifier)];
+  if (loader) {
+    [loader didReceiveResponse:response completionHandler:completionHandler];
+  } else {
+    completionHandler(NSURLSessionResponseCancel);
+  }
+}
+
+// The redirect response is handed over instead, and fails the load as one that can't be attached.
+- (void)URLSession:(NSURLSession *)session
+                          task:(NSURLSessionTask *)task
+    willPerformHTTPRedirection:(NSHTTPURLResponse *)response
+                    newRequest:(NSURLRequest *)request
+             completionHandler:(void (^)(NSURLRequest *_Nullable))completionHandler {
+  completionHandler(nil);
+}
+
+- (void)URLSession:(NSURLSession *)session
+          dataTask:(NSURLSessionDataTask *)dataTask
+    didReceiveData:(NSData *)data {
+  [_loaders[@(dataTask.taskIdentifier)] didReceiveData:data];
+}
+
+- (void)URLSession:(NSURLSession *)session
+                    task:(NSURLSessionTask *)task
+    didCompleteWithError:(nullable NSError *)error {
+  [_loaders[@(task.taskIdentifier)] didCompleteWithError:error];
+}
+
+@end
+
+@implementation AMPKShadowDocumentLoader {
+  NSURLSessionDataTask *_task;
+  void (^_Nullable _cookieHandler)(NSArray<NSHTTPCookie *> *cookies);
+  void (^_Nullable _chunkHandler)(NSString *html);
+  void (^_Nullable _completion)(NSError *_Nullable error);
+  // Received bytes that end in the middle of a character.
+  NSMutableData *_pendingBytes;
+}
+
++ (NSURL *)shellURLForDocumentURL:(NSURL *)documentURL {
+  NSURLComponents *components = [[NSURLComponents alloc] init];
+  components.scheme = documentURL.scheme;
+  components.host = documentURL.host;
+  components.port = documentURL.port;
+  components.path = @"/";
+  return components.URL;
+}
+
++ (NSURL *)shadowRuntimeURL {
+  return [NSURL URLWithString:kAMPKShadowRuntimeURL];
+}
+
++ (NSString *)shellHTML {
+  return [self shellHTMLWithRuntimeURL:[self shadowRuntimeURL]];
+}
+
++ (NSString *)shellHTMLWithRuntimeURL:(NSURL *)runtimeURL {
+  // amp_shell.js, installed as a user script, defines ampkShell before this is parsed. A runtime
+  // that isn't the https one falls back to it if it fails to load.
+  NSString *fallback = @"";
+  if (![runtimeURL isEqual:[self shadowRuntimeURL]]) {
+    fallback = [NSString stringWithFormat:@"data-fallback-src=\"%@\" ", kAMPKShadowRuntimeURL];
+  }
+  return [NSString
+      stringWithFormat:
+          @"<!doctype html><html><head><meta charset=\"utf-8\">"
+          @"<meta name=\"viewport\" content=\"width=device-width,minimum-scale=1,initial-scale=1\">"
+          @"<script async src=\"%@\" %@onerror=\"ampkShell.runtimeFailed(this)\"></script>"
+          @"</head><body></body></html>",
+          runtimeURL.absoluteString, fallback];
+}
+
+- (instancetype)initWithRequest:(NSURLRequest *)request
+                  cookieHandler:(void (^)(NSArray<NSHTTPCookie *> *cookies))cookieHandler
+                   chunkHandler:(void (^)(NSString *html))chunkHandler
+                     completion:(void (^)(NSError *_Nullable error))completion {
+  self = [super init];
+  if (self) {
+    _cookieHandler = [cookieHandler copy];
+    _chunkHandler = [chunkHandler copy];
+    _completion = [completion copy];
+    _pendingBytes = [[NSMutableData alloc] init];
+
+    AMPKShadowDocumentSessionDelegate *delegate =
+        [AMPKShadowDocumentSessionDelegate sharedDelegate];
+    _task = [[delegate session] dataTaskWithRequest:request];
+    [delegate setLoader:self forTask:_task];
+    [_task resume];
+  }
+  return self;
+}
+
+- (void)cancel {
+  _cookieHandler = nil;
+  _chunkHandler = nil;
+  _completion = nil;
+  [[AMPKShadowDocumentSessionDelegate sharedDelegate] setLoader:nil forTask:_task];
+  [_task cancel];
+}
+
++ (NSArray<NSHTTPCookie *> *)cookiesForURL:(NSURL *)url
+                               fromCookies:(NSArray<NSHTTPCookie *> *)cookies {
+  NSString *host = url.host.lowercaseString;
+  NSString *path = url.path.length > 0 ? url.path : @"/";
+  BOOL secure = [url.scheme.lowercaseString isEqualToString:@"https"];
+  NSDate *now = [NSDate date];
+  NSMutableArray<NSHTTPCookie *> *matchingCookies = [[NSMutableArray alloc] init];
+  for (NSHTTPCookie *cookie in cookies) {
+    // A leading dot marks a cookie for the domain and its subdomains, see RFC 6265 5.1.3.
+    NSString *domain = cookie.domain.lowercaseString;
+    BOOL domainMatches = [domain hasPrefix:@"."] ?
+        [host hasSuffix:domain] || [host isEqualToString:[domain substringFromIndex:1]] :
+        [host isEqualToString:domain];
+    // See RFC 6265 5.1.4.
+    NSString *cookiePath = cookie.path.length > 0 ? cookie.path : @"/";
+    BOOL pathMatches = [path isEqualToString:cookiePath] ||
+        ([path hasPrefix:cookiePath] &&
+         ([cookiePath hasSuffix:@"/"] || [path characterAtIndex:cookiePath.length] == '/'));
+    BOOL expired = cookie.expiresDate && [cookie.expiresDate compare:now] != NSOrderedDescending;
+    if (domainMatches && pathMatches && !expired && (secure || !cookie.isSecure)) {
+      [matchingCookies addObject:cookie];
+    }
+  }
+  return matchingCookies;
+}
+
++ (NSUInteger)lengthOfCompleteUTF8CharactersInBytes:(const uint8_t *)bytes
+                                             length:(NSUInteger)length {
+  // A character is at most 4 bytes, so its lead byte is at most 3 bytes before the end.
+  for (NSUInteger lead = length; lead > 0 && length - lead < 4;) {
+    lead--;
+    uint8_t byte = bytes[lead];
+    if ((byte & 0xC0) == 0x80) {
+      continue;  // A continuation byte.
+    }
+    NSUInteger characterLength = byte < 0x80 ? 1 : byte >= 0xF0 ? 4 : byte >= 0xE0 ? 3 : 2;
+    return length - lead >= characterLength ? length : lead;
+  }
+  // No lead byte at all isn't UTF-8. Decoding it fails.
+  return length;
+}
+
+#pragma mark - Private
+
+- (void)didReceiveResponse:(NSURLResponse *)response
+         completionHandler:(void (^)(NSURLSessionResponseDisposition))completionHandler {
+  [self didReceiveCookiesFromResponse:response];
+  NSInteger statusCode = [response isKindOfClass:[NSHTTPURLResponse class]] ?
+      ((NSHTTPURLResponse *)response).statusCode : 0;
+  if (statusCode < 200 || statusCode >= 300 ||
+      ![response.MIMEType.lowercaseString isEqualToString:@"text/html"]) {
+    completionHandler(NSURLSessionResponseCancel);
+    NSString *description =
+        [NSString stringWithFormat:@"Can't attach a %@ response with status %ld",
+                                   response.MIMEType, (long)statusCode];
+    [self finishWithError:[NSError errorWithDomain:kAMPKShadowDocumentErrorDomain
+                                              code:AMPKShadowDocumentErrorCodeUnexpectedResponse
+                                          userInfo:@{ NSLocalizedDescriptionKey : description }]];
+    return;
+  }
+  completionHandler(NSURLSessionResponseAllow);
+}
+
+// Even a response that can't be attached sets its cookies, as it would in the web view, before the
+// caller navigates to the document.
+- (void)didReceiveCookiesFromResponse:(NSURLResponse *)response {
+  NSHTTPURLResponse *httpResponse = AMPK_VERIFY_CLASS(response, NSHTTPURLResponse);
+  if (!httpResponse || !response.URL || !_cookieHandler) {
+    return;
+  }
+  NSArray<NSHTTPCookie *> *cookies =
+      [NSHTTPCookie cookiesWithResponseHeaderFields:httpResponse.allHeaderFields
+                                             forURL:response.URL];
+  if (cookies.count > 0) {
+    _cookieHandler(cookies);
+  }
+}
+
+- (void)didReceiveData:(NSData *)data {
+  if (!_chunkHandler) {
+    return;
+  }
+  [_pendingBytes appendData:data];
+  NSUInteger length = [AMPKShadowDocumentLoader
+      lengthOfCompleteUTF8CharactersInBytes:_pendingBytes.bytes
+                                     length:_pendingBytes.length];
+  if (length == 0) {
+    return;
+  }
+  NSString *html = [[NSString alloc] initWithBytes:_pendingBytes.bytes
+                                            length:length
+                                          encoding:NSUTF8StringEncoding];
+  if (!html) {
+    [_task cancel];
+    [self finishWithError:[self invalidEncodingError]];
+    return;
+  }
+  [_pendingBytes replaceBytesInRange:NSMakeRange(0, length) withBytes:NULL length:0];
+  _chunkHandler(html);
+}
+
+- (void)didCompleteWithError:(nullable NSError *)error {
+  if (!error && _pendingBytes.length > 0) {
+    error = [self invalidEncodingError];
+  }
+  [self finishWithError:error];
+}
+
+- (void)finishWithError:(nullable NSError *)error {
+  void (^completion)(NSError *_Nullable) = _completion;
+  _cookieHandler = nil;
+  _chunkHandler = nil;
+  _completion = nil;
+  [[AMPKShadowDocumentSessionDelegate sharedDelegate] setLoader:nil forTask:_task];
+  if (completion) {
+    completion(error);
+  }
+}
+
+- (NSError *)invalidEncodingError {
+  return [NSError errorWithDomain:kAMPKShadowDocumentErrorDomain
+                             code:AMPKShadowDocumentErrorCodeInvalidEncoding
+                         userInfo:@{ NSLocalizedDescriptionKey : @"The document isn't UTF-8" }];
+}
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -22,12 +22,26 @@
 
 /** A controller that handles all the communication between AMP JS and AMP viewer. */
 @interface AMPKWebViewerMessageHandlerController : NSObject <WKScriptMessageHandler,
-                                                             WKNavigationDelegate>
+                                                             WKNavigationDelegate,
+                                                             WKUIDelegate>
 
 @property(nonatomic, weak) AMPKWebViewerViewController *ampWebViewerController;
 @property(nonatomic, weak) AMPKMessageBroadcaster *ampMessageBroadcaster;
 @property(nonatomic, copy) NSURL *source;
 
+/**
+ * Whether the web view holds the shell that AMP Docs are attached to as shadow documents, rather
+ * than the AMP Docs themselves. Decides which script is injected into the documents it loads next.
+ */
+@property(nonatomic) BOOL attachesShadowDocuments;
+
+/**
+ * Called when the system terminates the web view's content process, e.g. under memory pressure.
+ * Unlike messages it is called while ampWebViewerController is nil too, as a view waiting in a
+ * reuse pool still holds its last page.
+ */
+@property(nonatomic, copy) dispatch_block_t webContentProcessTerminationHandler;
+
 /** Send AMP page message via AMP JS channel. */
 - (void)sendAmpJsMessage:(AMPKWebViewerJsMessage *)message;
 
@@ -37,6 +51,12 @@
 /** Send a visibility state message of prerender to the webview. */
 - (void)sendPrefetched;
 
+/**
+ * Send a visibility state message of paused to the webview, which stops its media, animations and
+ * timers until it is sent another state.
+ */
+- (void)sendPaused;
+
 /** Forward a broadcast message from some other webview to this webview. */
 - (void)forwardBroadcast:(AMPKWebViewerJsMessage *)broadcast;
 
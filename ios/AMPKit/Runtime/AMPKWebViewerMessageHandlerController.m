@@ -20,37 +20,55 @@
 #import "AMPKDefines.h"
 #import "AMPKMessageBroadcaster.h"
 #import "AMPKPresenterProtocol.h"
+#import "AMPKViewer.h"
 #import "AMPKWebViewerJsMessage.h"
+#import "AMPKWebViewerLifecycle.h"
 #import "AMPKWebViewerMessageHandlerController_private.h"
 #import "AMPKWebViewerViewController.h"
 #import "AMPKWebViewerViewController_private.h"
 #import "NSURL+AMPK.h"
 
-typedef NS_ENUM(NSInteger, AMPKVisibilityState) {
-  AMPKVisibilityStatePrefetched,
-  AMPKVisibilityStateVisible,
-  AMPKVisibilityStateHidden,
-};
-
 static NSString * const AMPKJSBundle = @"AmpKit.bundle";
 static NSString * const AMPKJSName = @"amp_integration";
+// The same script without the Closure polyfills, for the WebKit of iOS 10 and later.
+static NSString * const AMPKJSModernName = @"amp_integration_modern";
 static NSString * const AMPKJSExtension = @"js";
 
+// The shell shadow documents are attached to, see AMPKShadowDocumentLoader.
+static NSString * const AMPKJSShellName = @"amp_shell";
+
+static NSString *AMPKLoadBundledScript(NSString *name) {
+  NSString *bundlePath = [[NSBundle mainBundle] pathForResource:@"AMPKit" ofType:@"bundle"];
+  NSBundle *bundle = [NSBundle bundleWithPath:bundlePath];
+  NSString *resourcePath = [bundle pathForResource:name ofType:AMPKJSExtension];
+  NSError *error;
+
+  NSString *jsContents = [[NSString alloc] initWithContentsOfFile:resourcePath
+                                                         encoding:NSUTF8StringEncoding
+                                                            error:&error];
+  if (error) {
+    NSLog(@"Error reading AMPKit script %@ from the Bundle\n%@\n", name, error);
+  }
+  return jsContents;
+}
+
 static NSString *AMPKLoadAmpIntegrationSource(void) {
   static dispatch_once_t onceToken;
   static NSString *jsContents;
   dispatch_once(&onceToken, ^{
-    NSString *bundlePath = [[NSBundle mainBundle] pathForResource:@"AMPKit" ofType:@"bundle"];
-    NSBundle *bundle = [NSBundle bundleWithPath:bundlePath];
-    NSString *resourcePath = [bundle pathForResource:AMPKJSName ofType:AMPKJSExtension];
-    NSError *error;
-
-    jsContents = [[NSString alloc] initWithContentsOfFile:resourcePath
-                                                 encoding:NSUTF8StringEncoding
-                                                    error:&error];
-    if (error) {
-      NSLog(@"Error reading AMPKit integration script from the Bundle\n%@\n",error);
-    }
+    NSOperatingSystemVersion iOS10 = {10, 0, 0};
+    NSString *name = [[NSProcessInfo processInfo] isOperatingSystemAtLeastVersion:iOS10] ?
+        AMPKJSModernName : AMPKJSName;
+    jsContents = AMPKLoadBundledScript(name);
+  });
+  return jsContents;
+};
+
+static NSString *AMPKLoadAmpShellSource(void) {
+  static dispatch_once_t onceToken;
+  static NSString *jsContents;
+  dispatch_once(&onceToken, ^{
+    jsContents = AMPKLoadBundledScript(AMPKJSShellName);
   });
   return jsContents;
 };
@@ -58,11 +76,13 @@ static NSString *AMPKLoadAmpIntegrationSource(void) {
 static NSDictionary *kAMPKVisibilityState(void) {
   return @{ @(AMPKVisibilityStateVisible) : @"visible",
             @(AMPKVisibilityStateHidden) : @"inactive",
+            @(AMPKVisibilityStatePaused) : @"paused",
             @(AMPKVisibilityStatePrefetched) : @"prerender" };
 }
 
 @implementation AMPKWebViewerMessageHandlerController {
   WKUserScript *_ampIntegrationScript;
+  WKUserScript *_ampShellScript;
 }
 
 - (instancetype)init {
@@ -81,13 +101,20 @@ static NSDictionary *kAMPKVisibilityState(void) {
     addEntry([AMPKWebViewerBroadcast class]);
     addEntry([AMPKWebViewerRequestFullOverlay class]);
     addEntry([AMPKWebViewerCancelFullOverlay class]);
+    addEntry([AMPKWebViewerShadowDocumentFailed class]);
 
     _messageHandlers = [handlers copy];
 
+    // The AMP Doc is always the main frame. Ads, embeds and analytics frames never talk to the
+    // viewer, so they don't need to parse the script.
     _ampIntegrationScript =
         [[WKUserScript alloc] initWithSource:AMPKLoadAmpIntegrationSource()
                                injectionTime:WKUserScriptInjectionTimeAtDocumentStart
-                            forMainFrameOnly:NO];
+                            forMainFrameOnly:YES];
+    _ampShellScript =
+        [[WKUserScript alloc] initWithSource:AMPKLoadAmpShellSource()
+                               injectionTime:WKUserScriptInjectionTimeAtDocumentStart
+                            forMainFrameOnly:YES];
   }
   return self;
 }
@@ -103,12 +130,23 @@ static NSDictionary *kAMPKVisibilityState(void) {
   _ampWebViewerController = ampWebViewerController;
 }
 
+- (void)setAttachesShadowDocuments:(BOOL)attachesShadowDocuments {
+  if (_attachesShadowDocuments == attachesShadowDocuments) {
+    return;
+  }
+  _attachesShadowDocuments = attachesShadowDocuments;
+  if (_ampWebViewerController) {
+    [self startMessageHandlingForWebView:_ampWebViewerController.webView];
+  }
+}
+
 - (void)startMessageHandlingForWebView:(WKWebView *)webView {
   [self stopMessageHandlingForWebView:webView];
 
   [webView.configuration.userContentController addScriptMessageHandler:self
                                                                   name:kAmpJsMessagePostName];
-  [webView.configuration.userContentController addUserScript:_ampIntegrationScript];
+  [webView.configuration.userContentController
+      addUserScript:_attachesShadowDocuments ? _ampShellScript : _ampIntegrationScript];
 }
 
 - (void)stopMessageHandlingForWebView:(WKWebView *)webView {
@@ -175,6 +213,15 @@ static NSDictionary *kAMPKVisibilityState(void) {
   [self sendVisibilityState:AMPKVisibilityStatePrefetched];
 }
 
+- (void)sendPaused {
+  // Until some message has been received, we could not have received the document loaded message.
+  // Therefore, don't even bother creating the message and requesting it be sent as it will not.
+  if (!_lastMessage) {
+    return;
+  }
+  [self sendVisibilityState:AMPKVisibilityStatePaused];
+}
+
 - (void)sendVisibilityState:(AMPKVisibilityState)visibilityState {
   NSString *state = kAMPKVisibilityState()[@(visibilityState)];
   AMPKWebViewerJsMessage *message =
@@ -230,20 +277,61 @@ static NSDictionary *kAMPKVisibilityState(void) {
   NSString *urlScheme = [navigationAction.request.URL.scheme lowercaseString];
   if (navigationAction.navigationType == WKNavigationTypeLinkActivated) {
     if ([urlScheme isEqualToString:@"http"] || [urlScheme isEqualToString:@"https"]) {
-      id<AMPKPresenterProtocol> presenter = self.ampWebViewerController.presenter;
-      [presenter presentEmbeddedLinkRequest:navigationAction.request
-                         fromViewController:self.ampWebViewerController];
+      AMPKWebViewerViewController *controller = self.ampWebViewerController;
+      // Links to AMP pages open in one of the viewer's AMP views, often already loaded.
+      if (![controller.viewer openAmpLinkURL:navigationAction.request.URL
+                          fromViewController:controller]) {
+        [controller.presenter presentEmbeddedLinkRequest:navigationAction.request
+                                      fromViewController:controller];
+      }
     } else {
       [UIApplication.sharedApplication openURL:navigationAction.request.URL];
     }
     policy = WKNavigationActionPolicyCancel;
+  } else if (navigationAction.targetFrame && !navigationAction.targetFrame.isMainFrame &&
+             [self.ampWebViewerController shouldBlockFrameRequest:navigationAction.request]) {
+    // Ad and analytics iframes of a viewer that isn't visible yet.
+    policy = WKNavigationActionPolicyCancel;
   }
 
   decisionHandler(policy);
 }
 
+- (void)webViewWebContentProcessDidTerminate:(WKWebView *)webView {
+  if (_webContentProcessTerminationHandler) {
+    _webContentProcessTerminationHandler();
+  }
+}
+
+#pragma mark - WKUIDelegate
+
+// Asked when the user long presses a link, well before they let go and maybe tap it. iOS 13 and
+// later ask for a context menu instead.
+- (BOOL)webView:(WKWebView *)webView shouldPreviewElement:(WKPreviewElementInfo *)elementInfo {
+  [self prefetchLinkURL:elementInfo.linkURL];
+  return YES;
+}
+
+#if __IPHONE_OS_VERSION_MAX_ALLOWED >= 130000
+- (void)webView:(WKWebView *)webView
+    contextMenuConfigurationForElement:(WKContextMenuElementInfo *)elementInfo
+                     completionHandler:
+                         (void (^)(UIContextMenuConfiguration *_Nullable))completionHandler
+    API_AVAILABLE(ios(13.0)) {
+  [self prefetchLinkURL:elementInfo.linkURL];
+  // The default menu.
+  completionHandler(nil);
+}
+#endif
+
 #pragma mark - Private Methods
 
+- (void)prefetchLinkURL:(nullable NSURL *)linkURL {
+  if (linkURL) {
+    [self.ampWebViewerController.viewer prefetchAmpLinkURL:linkURL];
+  }
+}
+
 - (BOOL)shouldSendMessage:(AMPKWebViewerJsMessage *)message {
   if (self.ampWebViewerController.ampJsReady ||
       [[message name] isEqualToString:kAmpChannelOpenMessageName]) {
@@ -432,3 +520,16 @@ static NSDictionary *kAMPKVisibilityState(void) {
 }
 
 @end
+
+@implementation AMPKWebViewerShadowDocumentFailed
+
+- (NSString *)messageName {
+  return kAmpShadowDocumentFailedMessageName;
+}
+
+- (void)handleAMPMessage:(AMPKWebViewerJsMessage *)ampMessage
+    forAmpWebViewerController:(AMPKWebViewerViewController *)ampWebViewerController {
+    [self.controller.ampWebViewerController shadowDocumentFailedWithMessage:ampMessage];
+}
+
+@end
@@ -0,0 +1,69 @@
+/**
+ * Copyright 2020 The AMP HTML Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS-IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/** What the viewer's header shows for an article. */
+@interface AMPKArticleMetadata : NSObject
+
++ (instancetype)metadataWithTitle:(nullable NSString *)title
+                     canonicalURL:(nullable NSURL *)canonicalURL
+                       sharingURL:(nullable NSURL *)sharingURL;
+
+@property(nonatomic, copy, readonly, nullable) NSString *title;
+@property(nonatomic, copy, readonly, nullable) NSURL *canonicalURL;
+@property(nonatomic, copy, readonly, nullable) NSURL *sharingURL;
+
+@end
+
+/**
+ * Remembers the header metadata of the articles the viewer showed, by publisher URL, across
+ * launches, so the header of an article opened again is filled in before its document loads.
+ * Only the most recently stored articles are kept. Use it from the main thread; the file is read
+ * in the background as soon as the cache is created, and changes are written back in the
+ * background shortly after they are made, or right away when the app moves to the background.
+ */
+@interface AMPKArticleMetadataCache : NSObject
+
+/** A cache in the app's caches directory. */
++ (instancetype)defaultCache;
+
+/**
+ * @param fileURL Where to keep the metadata. Read in the background right away and written back
+ * after it changes.
+ */
+- (instancetype)initWithFileURL:(NSURL *)fileURL NS_DESIGNATED_INITIALIZER;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+/** The most articles kept. Defaults to 500. */
+@property(nonatomic) NSUInteger maxCount;
+
+/** The metadata last stored for the article at @c publisherURL, if it's still kept. */
+- (nullable AMPKArticleMetadata *)metadataForPublisherURL:(NSURL *)publisherURL;
+
+/** Stores @c metadata for the article at @c publisherURL, replacing what was there. */
+- (void)setMetadata:(AMPKArticleMetadata *)metadata forPublisherURL:(NSURL *)publisherURL;
+
+/** Writes the changes not on disk yet now. Called when the app moves to the background. */
+- (void)flush;
+
+@end
+
+NS_ASSUME_NONNULL_END
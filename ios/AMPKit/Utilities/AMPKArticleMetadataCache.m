@@ -0,0 +1,241 @@
+/**
+ * Copyright 2020 The AMP HTML Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS-IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#import "AMPKArticleMetadataCache.h"
+
+#import <UIKit/UIKit.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+static const NSUInteger kDefaultMaxCount = 500;
+
+// How long changes wait before they are written, so opening a few articles writes the file once.
+static const NSTimeInterval kWriteDelay = 2;
+
+static NSString *const kPublisherURLKey = @"publisherURL";
+static NSString *const kTitleKey = @"title";
+static NSString *const kCanonicalURLKey = @"canonicalURL";
+static NSString *const kSharingURLKey = @"sharingURL";
+
+@implementation AMPKArticleMetadata
+
++ (instancetype)metadataWithTitle:(nullable NSString *)title
+                     canonicalURL:(nullable NSURL *)canonicalURL
+                       sharingURL:(nullable NSURL *)sharingURL {
+  AMPKArticleMetadata *metadata = [[self alloc] init];
+  metadata->_title = [title copy];
+  metadata->_canonicalURL = [canonicalURL copy];
+  metadata->_sharingURL = [sharingURL copy];
+  return metadata;
+}
+
+- (BOOL)isEqual:(id)object {
+  if (![object isKindOfClass:[AMPKArticleMetadata class]]) {
+    return NO;
+  }
+  AMPKArticleMetadata *other = object;
+  return (_title == other.title || [_title isEqualToString:other.title]) &&
+         (_canonicalURL == other.canonicalURL || [_canonicalURL isEqual:other.canonicalURL]) &&
+         (_sharingURL == other.sharingURL || [_sharingURL isEqual:other.sharingURL]);
+}
+
+- (NSUInteger)hash {
+  return _title.hash ^ _canonicalURL.hash ^ _sharingURL.hash;
+}
+
+@end
+
+@implementation AMPKArticleMetadataCache {
+  NSURL *_fileURL;
+  // Nil until the file has been read.
+  NSMutableDictionary<NSString *, AMPKArticleMetadata *> *_metadata;
+  // The keys of _metadata, least recently stored first.
+  NSMutableArray<NSString *> *_order;
+  // Reads the file, then writes it back.
+  dispatch_queue_t _fileQueue;
+  // What was read from the file on _fileQueue, until readIfNeeded takes it over.
+  NSMutableDictionary<NSString *, AMPKArticleMetadata *> *_readMetadata;
+  NSMutableArray<NSString *> *_readOrder;
+}
+
++ (instancetype)defaultCache {
+  static AMPKArticleMetadataCache *defaultCache;
+  static dispatch_once_t onceToken;
+  dispatch_once(&onceToken, ^{
+    NSURL *cachesURL = [[NSFileManager defaultManager] URLsForDirectory:NSCachesDirectory
+                                                              inDomains:NSUserDomainMask][0];
+    defaultCache = [[AMPKArticleMetadataCache alloc]
+        initWithFileURL:[cachesURL URLByAppendingPathComponent:@"AMPKArticleMetadata.plist"]];
+  });
+  return defaultCache;
+}
+
+- (instancetype)initWithFileURL:(NSURL *)fileURL {
+  self = [super init];
+  if (self) {
+    _fileURL = [fileURL copy];
+    _maxCount = kDefaultMaxCount;
+    _fileQueue = dispatch_queue_create("com.google.ampkit.metadata-cache", DISPATCH_QUEUE_SERIAL);
+    // Read ahead of the first lookup, which is made on the main thread as an article opens.
+    dispatch_async(_fileQueue, ^{
+      [self readFile];
+    });
+    [[NSNotificationCenter defaultCenter] addObserver:self
+                                             selector:@selector(flush)
+                                                 name:UIApplicationDidEnterBackgroundNotification
+                                               object:nil];
+  }
+  return self;
+}
+
+- (void)dealloc {
+  [[NSNotificationCenter defaultCenter] removeObserver:self];
+  [NSObject cancelPreviousPerformRequestsWithTarget:self];
+}
+
+- (void)setMaxCount:(NSUInteger)maxCount {
+  _maxCount = MAX(maxCount, 1);
+  if (_metadata && [self evictIfNeeded]) {
+    [self scheduleWrite];
+  }
+}
+
+- (nullable AMPKArticleMetadata *)metadataForPublisherURL:(NSURL *)publisherURL {
+  [self readIfNeeded];
+  return _metadata[publisherURL.absoluteString];
+}
+
+- (void)setMetadata:(AMPKArticleMetadata *)metadata forPublisherURL:(NSURL *)publisherURL {
+  [self readIfNeeded];
+  NSString *key = publisherURL.absoluteString;
+  if ([_metadata[key] isEqual:metadata]) {
+    return;
+  }
+  if (_metadata[key]) {
+    [_order removeObject:key];
+  }
+  _metadata[key] = metadata;
+  [_order addObject:key];
+  [self evictIfNeeded];
+  [self scheduleWrite];
+}
+
+- (void)flush {
+  [NSObject cancelPreviousPerformRequestsWithTarget:self selector:@selector(write) object:nil];
+  [self write];
+  // Waits for the write to finish.
+  dispatch_sync(_fileQueue, ^{
+  });
+}
+
+#pragma mark - Private
+
+- (void)readIfNeeded {
+  if (_metadata) {
+    return;
+  }
+  // Usually the read has long finished.
+  dispatch_sync(_fileQueue, ^{
+    _metadata = _readMetadata;
+    _order = _readOrder;
+    _readMetadata = nil;
+    _readOrder = nil;
+  });
+  [self evictIfNeeded];
+}
+
+// Only called on _fileQueue.
+- (void)readFile {
+  NSMutableDictionary<NSString *, AMPKArticleMetadata *> *metadata =
+      [NSMutableDictionary dictionary];
+  NSMutableArray<NSString *> *order = [NSMutableArray array];
+  NSArray *entries = [NSArray arrayWithContentsOfURL:_fileURL];
+  for (NSDictionary *entry in entries) {
+    if (![entry isKindOfClass:[NSDictionary class]]) {
+      continue;
+    }
+    NSString *key = entry[kPublisherURLKey];
+    if (![key isKindOfClass:[NSString class]] || metadata[key]) {
+      continue;
+    }
+    metadata[key] = [AMPKArticleMetadata metadataWithTitle:[self stringInEntry:entry
+                                                                        forKey:kTitleKey]
+                                              canonicalURL:[self URLInEntry:entry
+                                                                     forKey:kCanonicalURLKey]
+                                                sharingURL:[self URLInEntry:entry
+                                                                     forKey:kSharingURLKey]];
+    [order addObject:key];
+  }
+  _readMetadata = metadata;
+  _readOrder = order;
+}
+
+- (nullable NSString *)stringInEntry:(NSDictionary *)entry forKey:(NSString *)key {
+  NSString *value = entry[key];
+  return [value isKindOfClass:[NSString class]] ? value : nil;
+}
+
+- (nullable NSURL *)URLInEntry:(NSDictionary *)entry forKey:(NSString *)key {
+  NSString *value = [self stringInEntry:entry forKey:key];
+  return value ? [NSURL URLWithString:value] : nil;
+}
+
+// Returns whether any articles were dropped.
+- (BOOL)evictIfNeeded {
+  if (_order.count <= _maxCount) {
+    return NO;
+  }
+  NSRange evicted = NSMakeRange(0, _order.count - _maxCount);
+  [_metadata removeObjectsForKeys:[_order subarrayWithRange:evicted]];
+  [_order removeObjectsInRange:evicted];
+  return YES;
+}
+
+- (void)scheduleWrite {
+  [NSObject cancelPreviousPerformRequestsWithTarget:self selector:@selector(write) object:nil];
+  [self performSelector:@selector(write) withObject:nil afterDelay:kWriteDelay];
+}
+
+- (void)write {
+  if (!_metadata) {
+    return;
+  }
+  NSMutableArray<NSDictionary *> *entries = [NSMutableArray arrayWithCapacity:_order.count];
+  for (NSString *key in _order) {
+    AMPKArticleMetadata *metadata = _metadata[key];
+    NSMutableDictionary *entry = [NSMutableDictionary dictionaryWithObject:key
+                                                                    forKey:kPublisherURLKey];
+    entry[kTitleKey] = metadata.title;
+    entry[kCanonicalURLKey] = metadata.canonicalURL.absoluteString;
+    entry[kSharingURLKey] = metadata.sharingURL.absoluteString;
+    [entries addObject:entry];
+  }
+  NSURL *fileURL = _fileURL;
+  dispatch_async(_fileQueue, ^{
+    [[NSFileManager defaultManager] createDirectoryAtURL:[fileURL URLByDeletingLastPathComponent]
+                             withIntermediateDirectories:YES
+                                              attributes:nil
+                                                   error:nil];
+    if (![entries writeToURL:fileURL atomically:YES]) {
+      NSLog(@"Could not write the AMP article metadata to %@", fileURL);
+    }
+  });
+}
+
+@end
+
+NS_ASSUME_NONNULL_END
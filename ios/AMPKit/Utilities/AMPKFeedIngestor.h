@@ -0,0 +1,44 @@
+/**
+ * Copyright 2020 The AMP HTML Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS-IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#import <Foundation/Foundation.h>
+
+@class AMPKFeedSnapshot;
+@protocol AMPKArticleProtocol;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * Builds AMPKFeedSnapshots on a background queue, so validating a large feed and computing its
+ * URLs doesn't hold up the main thread. Feeds are ingested in order; when a newer feed is
+ * submitted before an older one has been delivered, the older one is dropped.
+ */
+@interface AMPKFeedIngestor : NSObject
+
+/**
+ * Builds a snapshot of @c articles and calls @c completion with it on the main queue, unless
+ * another feed was submitted in the meantime, in which case @c completion is never called.
+ * @param articles The articles are copied in the background, so don't change them until
+ * @c completion is called.
+ */
+- (void)ingestArticles:(NSArray<id<AMPKArticleProtocol>> *)articles
+               headers:(nullable NSDictionary<NSString *, NSString *> *)headers
+            domainName:(NSURL *)domainName
+            completion:(void (^)(AMPKFeedSnapshot *snapshot))completion;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,65 @@
+/**
+ * Copyright 2020 The AMP HTML Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS-IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#import "AMPKFeedIngestor.h"
+
+#import "AMPKFeedSnapshot.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+@implementation AMPKFeedIngestor {
+  dispatch_queue_t _queue;
+  // Only touched on the main queue.
+  NSUInteger _generation;
+}
+
+- (instancetype)init {
+  self = [super init];
+  if (self) {
+    dispatch_queue_attr_t attributes =
+        dispatch_queue_attr_make_with_qos_class(DISPATCH_QUEUE_SERIAL, QOS_CLASS_USER_INITIATED, 0);
+    _queue = dispatch_queue_create("com.google.ampkit.feed-ingestion", attributes);
+  }
+  return self;
+}
+
+- (void)ingestArticles:(NSArray<id<AMPKArticleProtocol>> *)articles
+               headers:(nullable NSDictionary<NSString *, NSString *> *)headers
+            domainName:(NSURL *)domainName
+            completion:(void (^)(AMPKFeedSnapshot *snapshot))completion {
+  NSAssert([NSThread isMainThread], @"Feeds must be submitted on the main thread");
+  NSUInteger generation = ++_generation;
+  articles = [articles copy];
+  headers = [headers copy];
+  domainName = [domainName copy];
+  completion = [completion copy];
+  __weak AMPKFeedIngestor *weakSelf = self;
+  dispatch_async(_queue, ^{
+    AMPKFeedSnapshot *snapshot = [[AMPKFeedSnapshot alloc] initWithArticles:articles
+                                                                    headers:headers
+                                                                 domainName:domainName];
+    dispatch_async(dispatch_get_main_queue(), ^{
+      AMPKFeedIngestor *strongSelf = weakSelf;
+      if (strongSelf && strongSelf->_generation == generation) {
+        completion(snapshot);
+      }
+    });
+  });
+}
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,84 @@
+/**
+ * Copyright 2020 The AMP HTML Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS-IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/** How urgently an article is needed. Lower values load first. */
+typedef NS_ENUM(NSInteger, AMPKLoadPriority) {
+  /** The article the reader is looking at, or about to. */
+  AMPKLoadPriorityVisible,
+  /** The articles on either side of it. */
+  AMPKLoadPriorityNeighbour,
+  /** Articles further away, loaded in case the reader keeps swiping. */
+  AMPKLoadPriorityPrefetch,
+};
+
+/**
+ * Starts loads in stages so the article the reader is waiting for doesn't compete for the network
+ * and CPU with the ones they might read next. A load starts straight away unless a load of a
+ * higher priority is in flight, in which case it waits until that one finishes or has been in
+ * flight for stageTimeout. Loads are identified by a key, e.g. the view controller they load into,
+ * and a load that hasn't started yet can be cancelled or made more urgent.
+ */
+@interface AMPKLoadScheduler : NSObject
+
+/**
+ * How long, in seconds, a load holds back loads of lower priority. Defaults to 1; 0 starts every
+ * load as soon as it is scheduled.
+ */
+@property(nonatomic) NSTimeInterval stageTimeout;
+
+/**
+ * The time loads are measured with, in seconds. The system uptime by default; simulations that
+ * drive time themselves replace it and call startDueLoads.
+ */
+@property(nonatomic, copy) NSTimeInterval (^clock)(void);
+
+/** When the next load held back by stageTimeout is due, or 0 if none is. */
+@property(nonatomic, readonly) NSTimeInterval nextDueTime;
+
+/**
+ * Schedules @c block to load into @c key. Does nothing if a load for @c key is in flight. A load
+ * for @c key that hasn't started is replaced, keeping the higher of the two priorities.
+ */
+- (void)scheduleLoadWithKey:(id)key
+                   priority:(AMPKLoadPriority)priority
+                      block:(dispatch_block_t)block;
+
+/** Makes the load for @c key at least as urgent as @c priority, starting it if it can now. */
+- (void)raisePriorityOfLoadWithKey:(id)key toPriority:(AMPKLoadPriority)priority;
+
+/** Reports that the load for @c key has finished, which may start loads held back by it. */
+- (void)loadDidFinishWithKey:(id)key;
+
+/** Forgets the load for @c key: drops it if it hasn't started, or stops waiting on it if it has. */
+- (void)cancelLoadWithKey:(id)key;
+
+/** Whether a load for @c key is scheduled but hasn't started. */
+- (BOOL)hasPendingLoadWithKey:(id)key;
+
+/**
+ * Starts the held back loads that are due by now. Called on a timer; simulations with their own
+ * clock call it themselves.
+ */
+- (void)startDueLoads;
+
+@end
+
+NS_ASSUME_NONNULL_END
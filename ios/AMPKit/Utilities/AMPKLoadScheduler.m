@@ -0,0 +1,185 @@
+/**
+ * Copyright 2020 The AMP HTML Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS-IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#import "AMPKLoadScheduler.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+static const NSTimeInterval kDefaultStageTimeout = 1;
+
+// A load that is waiting to start, or in flight.
+@interface AMPKScheduledLoad : NSObject
+@property(nonatomic) id key;
+@property(nonatomic) AMPKLoadPriority priority;
+@property(nonatomic, copy, nullable) dispatch_block_t block;
+// When the load started, or -1 while it is waiting.
+@property(nonatomic) NSTimeInterval startTime;
+@end
+
+@implementation AMPKScheduledLoad
+@end
+
+@implementation AMPKLoadScheduler {
+  // In the order they were scheduled, so loads of the same priority start first come first served.
+  NSMutableArray<AMPKScheduledLoad *> *_loads;
+  // Guards against a load's block scheduling more loads while the queue is being walked.
+  BOOL _startingLoads;
+}
+
+- (instancetype)init {
+  self = [super init];
+  if (self) {
+    _loads = [[NSMutableArray alloc] init];
+    _stageTimeout = kDefaultStageTimeout;
+    _clock = ^NSTimeInterval {
+      return [NSProcessInfo processInfo].systemUptime;
+    };
+  }
+  return self;
+}
+
+- (void)dealloc {
+  [NSObject cancelPreviousPerformRequestsWithTarget:self];
+}
+
+- (void)setStageTimeout:(NSTimeInterval)stageTimeout {
+  _stageTimeout = MAX(stageTimeout, 0);
+  [self startDueLoads];
+}
+
+- (void)scheduleLoadWithKey:(id)key
+                   priority:(AMPKLoadPriority)priority
+                      block:(dispatch_block_t)block {
+  AMPKScheduledLoad *load = [self loadWithKey:key];
+  if (load && load.startTime >= 0) {
+    return;
+  }
+  if (load) {
+    load.priority = MIN(load.priority, priority);
+  } else {
+    load = [[AMPKScheduledLoad alloc] init];
+    load.key = key;
+    load.priority = priority;
+    load.startTime = -1;
+    [_loads addObject:load];
+  }
+  load.block = block;
+  [self startDueLoads];
+}
+
+- (void)raisePriorityOfLoadWithKey:(id)key toPriority:(AMPKLoadPriority)priority {
+  AMPKScheduledLoad *load = [self loadWithKey:key];
+  if (!load || load.priority <= priority) {
+    return;
+  }
+  load.priority = priority;
+  [self startDueLoads];
+}
+
+- (void)loadDidFinishWithKey:(id)key {
+  [self cancelLoadWithKey:key];
+}
+
+- (void)cancelLoadWithKey:(id)key {
+  AMPKScheduledLoad *load = [self loadWithKey:key];
+  if (!load) {
+    return;
+  }
+  [_loads removeObjectIdenticalTo:load];
+  [self startDueLoads];
+}
+
+- (BOOL)hasPendingLoadWithKey:(id)key {
+  AMPKScheduledLoad *load = [self loadWithKey:key];
+  return load && load.startTime < 0;
+}
+
+- (void)startDueLoads {
+  if (_startingLoads) {
+    return;
+  }
+  _startingLoads = YES;
+  AMPKScheduledLoad *load;
+  while ((load = [self nextLoadToStart])) {
+    load.startTime = _clock();
+    dispatch_block_t block = load.block;
+    load.block = nil;
+    block();
+  }
+  _startingLoads = NO;
+  [self scheduleTimer];
+}
+
+#pragma mark - Private
+
+- (nullable AMPKScheduledLoad *)loadWithKey:(id)key {
+  for (AMPKScheduledLoad *load in _loads) {
+    if (load.key == key) {
+      return load;
+    }
+  }
+  return nil;
+}
+
+// The most urgent waiting load, the first scheduled of those as urgent.
+- (nullable AMPKScheduledLoad *)mostUrgentWaitingLoad {
+  AMPKScheduledLoad *next = nil;
+  for (AMPKScheduledLoad *load in _loads) {
+    if (load.startTime < 0 && (!next || load.priority < next.priority)) {
+      next = load;
+    }
+  }
+  return next;
+}
+
+// The most urgent waiting load if nothing holds it back. Less urgent ones are held back too.
+- (nullable AMPKScheduledLoad *)nextLoadToStart {
+  AMPKScheduledLoad *next = [self mostUrgentWaitingLoad];
+  if (next && [self releaseTimeForPriority:next.priority] > _clock()) {
+    return nil;
+  }
+  return next;
+}
+
+// When loads in flight stop holding back a load of @c priority: the latest time one of a higher
+// priority started, plus stageTimeout.
+- (NSTimeInterval)releaseTimeForPriority:(AMPKLoadPriority)priority {
+  NSTimeInterval releaseTime = 0;
+  for (AMPKScheduledLoad *load in _loads) {
+    if (load.startTime >= 0 && load.priority < priority) {
+      releaseTime = MAX(releaseTime, load.startTime + _stageTimeout);
+    }
+  }
+  return releaseTime;
+}
+
+- (void)scheduleTimer {
+  [NSObject cancelPreviousPerformRequestsWithTarget:self
+                                           selector:@selector(startDueLoads)
+                                             object:nil];
+  AMPKScheduledLoad *next = [self mostUrgentWaitingLoad];
+  _nextDueTime = next ? [self releaseTimeForPriority:next.priority] : 0;
+  if (_nextDueTime > 0) {
+    [self performSelector:@selector(startDueLoads)
+               withObject:nil
+               afterDelay:MAX(_nextDueTime - _clock(), 0)];
+  }
+}
+
+@end
+
+NS_ASSUME_NONNULL_END
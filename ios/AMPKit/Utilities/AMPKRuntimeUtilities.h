@@ -24,3 +24,7 @@
 // Returns |object| if is kind of |expectedClass|. Returns nil otherwise.
 // Note: the return type is id.
 id AMPKVerifyClass(id object, Class expectedClass);
+
+// Returns the SHA-256 digest of |data| as a lowercase hexadecimal string. Unlike -hash, it is the
+// same across launches and devices, and doesn't collide for different data in practice.
+NSString *AMPKSHA256HexString(NSData *data);
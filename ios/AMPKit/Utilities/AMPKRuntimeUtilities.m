@@ -16,6 +16,18 @@
 
 #import "AMPKRuntimeUtilities.h"
 
+#import <CommonCrypto/CommonDigest.h>
+
 id AMPKVerifyClass(id object, Class expectedClass) {
   return ([object isKindOfClass:expectedClass] ? object : nil);
 }
+
+NSString *AMPKSHA256HexString(NSData *data) {
+  unsigned char digest[CC_SHA256_DIGEST_LENGTH];
+  CC_SHA256(data.bytes, (CC_LONG)data.length, digest);
+  NSMutableString *hexString = [NSMutableString stringWithCapacity:CC_SHA256_DIGEST_LENGTH * 2];
+  for (NSUInteger i = 0; i < CC_SHA256_DIGEST_LENGTH; i++) {
+    [hexString appendFormat:@"%02x", digest[i]];
+  }
+  return [hexString copy];
+}
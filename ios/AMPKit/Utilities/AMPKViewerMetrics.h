@@ -0,0 +1,84 @@
+/**
+ * Copyright 2020 The AMP HTML Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS-IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * What readers of an AMPKViewerDataSource waited for. Time to visible is how long an article that
+ * became the current one took to be shown: 0 if it had loaded already, e.g. as a neighbour, and
+ * otherwise the time until its AMP runtime reported documentLoaded. Articles left before they were
+ * shown aren't counted. Only the most recent samples are kept.
+ *
+ * It also counts how often the system terminated the web content process of an AMP view, e.g.
+ * under memory pressure, and how often the article was loaded again afterwards, and how many of
+ * the scripts AMP views asked the data source's runtime cache for were on disk.
+ */
+@interface AMPKViewerMetrics : NSObject
+
+/** The number of time to visible samples kept. */
+@property(nonatomic, readonly) NSUInteger timeToVisibleCount;
+
+/** How many of those articles had loaded before they became the current one. */
+@property(nonatomic, readonly) NSUInteger instantlyVisibleCount;
+
+/** How many times the web content process of an AMP view was terminated. */
+@property(nonatomic, readonly) NSUInteger webContentTerminationCount;
+
+/**
+ * How many articles were loaded again after their web content process was terminated: straight
+ * away if they were on screen, otherwise once they were needed again.
+ */
+@property(nonatomic, readonly) NSUInteger webContentReloadCount;
+
+/** How many scripts the runtime cache answered from disk. */
+@property(nonatomic, readonly) NSUInteger runtimeCacheHitCount;
+
+/** How many scripts the runtime cache had to download. */
+@property(nonatomic, readonly) NSUInteger runtimeCacheMissCount;
+
+/** The bytes the runtime cache answered from disk rather than downloaded. */
+@property(nonatomic, readonly) unsigned long long runtimeCacheBytesSaved;
+
+/**
+ * The time to visible, in seconds, that @c percentile percent of the samples kept are at or
+ * under, e.g. 50 for the median. 0 if there are no samples.
+ */
+- (NSTimeInterval)timeToVisibleAtPercentile:(double)percentile;
+
+/** Adds a time to visible sample, in seconds. */
+- (void)recordTimeToVisible:(NSTimeInterval)timeToVisible;
+
+/** Counts a web content process termination. */
+- (void)recordWebContentTermination;
+
+/** Counts an article loaded again after its web content process was terminated. */
+- (void)recordWebContentReload;
+
+/** Counts a script of @c length bytes answered from disk by the runtime cache. */
+- (void)recordRuntimeCacheHitWithLength:(NSUInteger)length;
+
+/** Counts a script the runtime cache had to download. */
+- (void)recordRuntimeCacheMiss;
+
+/** Drops every sample and count. */
+- (void)reset;
+
+@end
+
+NS_ASSUME_NONNULL_END
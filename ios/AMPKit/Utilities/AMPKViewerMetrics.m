@@ -0,0 +1,97 @@
+/**
+ * Copyright 2020 The AMP HTML Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS-IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#import "AMPKViewerMetrics.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+// Enough for stable percentiles over the last few reading sessions.
+static const NSUInteger kMaxTimeToVisibleSamples = 256;
+
+@implementation AMPKViewerMetrics {
+  // The samples kept, oldest first.
+  NSMutableArray<NSNumber *> *_timesToVisible;
+}
+
+- (instancetype)init {
+  self = [super init];
+  if (self) {
+    _timesToVisible = [[NSMutableArray alloc] init];
+  }
+  return self;
+}
+
+- (NSUInteger)timeToVisibleCount {
+  return _timesToVisible.count;
+}
+
+- (NSUInteger)instantlyVisibleCount {
+  NSUInteger count = 0;
+  for (NSNumber *timeToVisible in _timesToVisible) {
+    if (timeToVisible.doubleValue <= 0) {
+      count++;
+    }
+  }
+  return count;
+}
+
+- (NSTimeInterval)timeToVisibleAtPercentile:(double)percentile {
+  if (!_timesToVisible.count) {
+    return 0;
+  }
+  NSArray<NSNumber *> *sorted = [_timesToVisible sortedArrayUsingSelector:@selector(compare:)];
+  double rank = ceil(MIN(MAX(percentile, 0), 100) / 100 * sorted.count);
+  NSUInteger index = rank > 0 ? (NSUInteger)rank - 1 : 0;
+  return sorted[index].doubleValue;
+}
+
+- (void)recordTimeToVisible:(NSTimeInterval)timeToVisible {
+  if (_timesToVisible.count == kMaxTimeToVisibleSamples) {
+    [_timesToVisible removeObjectAtIndex:0];
+  }
+  [_timesToVisible addObject:@(MAX(timeToVisible, 0))];
+}
+
+- (void)recordWebContentTermination {
+  _webContentTerminationCount++;
+}
+
+- (void)recordWebContentReload {
+  _webContentReloadCount++;
+}
+
+- (void)recordRuntimeCacheHitWithLength:(NSUInteger)length {
+  _runtimeCacheHitCount++;
+  _runtimeCacheBytesSaved += length;
+}
+
+- (void)recordRuntimeCacheMiss {
+  _runtimeCacheMissCount++;
+}
+
+- (void)reset {
+  [_timesToVisible removeAllObjects];
+  _webContentTerminationCount = 0;
+  _webContentReloadCount = 0;
+  _runtimeCacheHitCount = 0;
+  _runtimeCacheMissCount = 0;
+  _runtimeCacheBytesSaved = 0;
+}
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,70 @@
+/**
+ * Copyright 2020 The AMP HTML Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS-IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/** The articles were replaced. The event's @c count is the number of articles. */
+extern NSString *const AMPKTraceEventFeed;
+/** The user started swiping towards the article at @c index. */
+extern NSString *const AMPKTraceEventSwipeBegin;
+/** A swipe ended on the article at @c index; @c completed is NO if it snapped back. */
+extern NSString *const AMPKTraceEventSwipeEnd;
+/** The article at @c index was opened directly, e.g. by tapping it in the feed. */
+extern NSString *const AMPKTraceEventJump;
+/** The viewer left the screen. */
+extern NSString *const AMPKTraceEventBackground;
+/** The viewer came back on screen. */
+extern NSString *const AMPKTraceEventForeground;
+
+/** Keys of a trace event. @c time is in seconds since the recorder was created. */
+extern NSString *const AMPKTraceKeyTime;
+extern NSString *const AMPKTraceKeyType;
+extern NSString *const AMPKTraceKeyIndex;
+extern NSString *const AMPKTraceKeyCount;
+extern NSString *const AMPKTraceKeyCompleted;
+
+/**
+ * Records how a reader moves through an AMPKViewer: swipes, taps, feed refreshes and backgrounding.
+ * Set one as the viewer's traceRecorder and write the trace out when done. Traces are JSON, one
+ * event object per line, and can be replayed against different viewer configurations.
+ */
+@interface AMPKViewerTraceRecorder : NSObject
+
+/** The events recorded so far. */
+@property(nonatomic, readonly) NSArray<NSDictionary<NSString *, id> *> *events;
+
+- (void)recordFeedWithCount:(NSUInteger)count;
+- (void)recordSwipeBeginToIndex:(NSInteger)index;
+- (void)recordSwipeEndAtIndex:(NSInteger)index completed:(BOOL)completed;
+- (void)recordJumpToIndex:(NSInteger)index;
+- (void)recordBackground;
+- (void)recordForeground;
+
+/** The trace in its file format. */
+- (NSData *)traceData;
+
+/** Writes the trace to a file at @c url. */
+- (BOOL)writeToURL:(NSURL *)url error:(NSError **)error;
+
+/** Parses a trace file. Returns nil if any line isn't a valid event. */
++ (nullable NSArray<NSDictionary<NSString *, id> *> *)eventsFromTraceData:(NSData *)data
+                                                                     error:(NSError **)error;
+
+@end
+
+NS_ASSUME_NONNULL_END
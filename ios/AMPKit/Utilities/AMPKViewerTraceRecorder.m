@@ -0,0 +1,138 @@
+/**
+ * Copyright 2020 The AMP HTML Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS-IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#import "AMPKViewerTraceRecorder.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+NSString *const AMPKTraceEventFeed = @"feed";
+NSString *const AMPKTraceEventSwipeBegin = @"swipeBegin";
+NSString *const AMPKTraceEventSwipeEnd = @"swipeEnd";
+NSString *const AMPKTraceEventJump = @"jump";
+NSString *const AMPKTraceEventBackground = @"background";
+NSString *const AMPKTraceEventForeground = @"foreground";
+
+NSString *const AMPKTraceKeyTime = @"time";
+NSString *const AMPKTraceKeyType = @"type";
+NSString *const AMPKTraceKeyIndex = @"index";
+NSString *const AMPKTraceKeyCount = @"count";
+NSString *const AMPKTraceKeyCompleted = @"completed";
+
+static NSString *const kAMPKTraceErrorDomain = @"AMPKViewerTraceRecorder";
+
+@implementation AMPKViewerTraceRecorder {
+  NSMutableArray<NSDictionary<NSString *, id> *> *_events;
+  NSTimeInterval _startTime;
+}
+
+- (instancetype)init {
+  self = [super init];
+  if (self) {
+    _events = [[NSMutableArray alloc] init];
+    _startTime = [NSProcessInfo processInfo].systemUptime;
+  }
+  return self;
+}
+
+- (NSArray<NSDictionary<NSString *, id> *> *)events {
+  return [_events copy];
+}
+
+- (void)recordFeedWithCount:(NSUInteger)count {
+  [self recordEvent:AMPKTraceEventFeed attributes:@{ AMPKTraceKeyCount : @(count) }];
+}
+
+- (void)recordSwipeBeginToIndex:(NSInteger)index {
+  [self recordEvent:AMPKTraceEventSwipeBegin attributes:@{ AMPKTraceKeyIndex : @(index) }];
+}
+
+- (void)recordSwipeEndAtIndex:(NSInteger)index completed:(BOOL)completed {
+  [self recordEvent:AMPKTraceEventSwipeEnd
+         attributes:@{ AMPKTraceKeyIndex : @(index), AMPKTraceKeyCompleted : @(completed) }];
+}
+
+- (void)recordJumpToIndex:(NSInteger)index {
+  [self recordEvent:AMPKTraceEventJump attributes:@{ AMPKTraceKeyIndex : @(index) }];
+}
+
+- (void)recordBackground {
+  [self recordEvent:AMPKTraceEventBackground attributes:nil];
+}
+
+- (void)recordForeground {
+  [self recordEvent:AMPKTraceEventForeground attributes:nil];
+}
+
+- (NSData *)traceData {
+  NSMutableData *data = [[NSMutableData alloc] init];
+  for (NSDictionary *event in _events) {
+    [data appendData:[NSJSONSerialization dataWithJSONObject:event options:0 error:nil]];
+    [data appendBytes:"\n" length:1];
+  }
+  return data;
+}
+
+- (BOOL)writeToURL:(NSURL *)url error:(NSError **)error {
+  return [[self traceData] writeToURL:url options:NSDataWritingAtomic error:error];
+}
+
++ (nullable NSArray<NSDictionary<NSString *, id> *> *)eventsFromTraceData:(NSData *)data
+                                                                     error:(NSError **)error {
+  NSString *trace = [[NSString alloc] initWithData:data encoding:NSUTF8StringEncoding];
+  NSMutableArray<NSDictionary<NSString *, id> *> *events = [[NSMutableArray alloc] init];
+  NSUInteger lineNumber = 0;
+  for (NSString *line in [trace componentsSeparatedByString:@"\n"]) {
+    lineNumber++;
+    if (line.length == 0) {
+      continue;
+    }
+    NSDictionary *event =
+        [NSJSONSerialization JSONObjectWithData:[line dataUsingEncoding:NSUTF8StringEncoding]
+                                        options:0
+                                          error:nil];
+    if (![event isKindOfClass:[NSDictionary class]] ||
+        ![event[AMPKTraceKeyType] isKindOfClass:[NSString class]] ||
+        ![event[AMPKTraceKeyTime] isKindOfClass:[NSNumber class]]) {
+      if (error) {
+        NSString *description = [NSString
+            stringWithFormat:@"Invalid trace event on line %lu", (unsigned long)lineNumber];
+        *error = [NSError errorWithDomain:kAMPKTraceErrorDomain
+                                     code:0
+                                 userInfo:@{ NSLocalizedDescriptionKey : description }];
+      }
+      return nil;
+    }
+    [events addObject:event];
+  }
+  return events;
+}
+
+#pragma mark - Private
+
+- (void)recordEvent:(NSString *)type
+         attributes:(nullable NSDictionary<NSString *, id> *)attributes {
+  NSMutableDictionary<NSString *, id> *event = [[NSMutableDictionary alloc] init];
+  event[AMPKTraceKeyTime] = @([NSProcessInfo processInfo].systemUptime - _startTime);
+  event[AMPKTraceKeyType] = type;
+  if (attributes) {
+    [event addEntriesFromDictionary:attributes];
+  }
+  [_events addObject:event];
+}
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,112 @@
+/**
+ * Copyright 2020 The AMP HTML Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS-IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/** The visibility states the AMP runtime of a viewer is told about. */
+typedef NS_ENUM(NSInteger, AMPKVisibilityState) {
+  /** Shown ahead of being swiped to, see AMPKViewer's prefetched. */
+  AMPKVisibilityStatePrefetched,
+  AMPKVisibilityStateVisible,
+  /** Off screen but still running, e.g. as a neighbour of the current article. */
+  AMPKVisibilityStateHidden,
+  /** Off screen with its media, animations and timers stopped. */
+  AMPKVisibilityStatePaused,
+};
+
+@class AMPKWebViewerLifecycle;
+
+/** What an AMPKWebViewerLifecycle drives: the web view and the AMP runtime in it. */
+@protocol AMPKWebViewerLifecycleDelegate <NSObject>
+
+/** Whether the viewer is prefetched, which shows its article without making it visible. */
+- (BOOL)webViewerLifecycleIsPrefetched:(AMPKWebViewerLifecycle *)lifecycle;
+
+/**
+ * Tells the AMP runtime it is now in @c visibilityState. The viewer should take its view out of
+ * sight when it is paused.
+ */
+- (void)webViewerLifecycle:(AMPKWebViewerLifecycle *)lifecycle
+    didEnterVisibilityState:(AMPKVisibilityState)visibilityState;
+
+/** Loads the current article again after its web content process was terminated. */
+- (void)webViewerLifecycleNeedsReload:(AMPKWebViewerLifecycle *)lifecycle;
+
+/** Called after visible, paused or webContentTerminated may have changed. */
+- (void)webViewerLifecycleDidChange:(AMPKWebViewerLifecycle *)lifecycle;
+
+@end
+
+/**
+ * Decides when the article of an AMPKWebViewerViewController is visible, hidden, prefetched or
+ * paused, pauses it once it has been hidden for inactiveTimeout, and when to reload it after the
+ * system terminated its web content process. The view controller does what it decides through the
+ * delegate, which lets the benchmarks drive the same logic without a web view.
+ */
+@interface AMPKWebViewerLifecycle : NSObject
+
+@property(nonatomic, weak, nullable) id<AMPKWebViewerLifecycleDelegate> delegate;
+
+/** Whether the article is on screen. A prefetched viewer's isn't. */
+@property(nonatomic, readonly, getter=isVisible) BOOL visible;
+
+/** Whether the AMP runtime has been told to pause. It resumes when the viewer is made visible. */
+@property(nonatomic, readonly, getter=isPaused) BOOL paused;
+
+/**
+ * Whether the web content process was terminated since the current article was loaded, leaving
+ * the web view blank until reloadAfterWebContentTermination.
+ */
+@property(nonatomic, readonly, getter=isWebContentTerminated) BOOL webContentTerminated;
+
+/** The state the AMP runtime was last told about, or is about to be. */
+@property(nonatomic, readonly) AMPKVisibilityState visibilityState;
+
+/** How long the article can stay hidden but running before it is paused. Zero never pauses it. */
+@property(nonatomic) NSTimeInterval inactiveTimeout;
+
+/**
+ * Whether a terminated article is reloaded once the viewer is visible. YES by default; viewers
+ * that decide themselves when to reload turn it off.
+ */
+@property(nonatomic) BOOL reloadsWhenVisible;
+
+/** Shows or hides the article, or shows it as prefetched if the viewer is. */
+- (void)setVisible:(BOOL)visible;
+
+/** Pauses the article until it is made visible again. */
+- (void)pause;
+
+/** Starts a new article, which runs until it has been hidden for inactiveTimeout. */
+- (void)articleWillLoad;
+
+/** Stops the pending pause of an article that is going away. */
+- (void)cancelScheduledPause;
+
+/** Tells the AMP runtime its state again, e.g. once the document has loaded. */
+- (void)resendVisibilityState;
+
+/** Records that the web content process was terminated, reloading if the article is visible. */
+- (void)webContentProcessDidTerminate;
+
+/** Asks the delegate to reload the article if its web content process was terminated. */
+- (void)reloadAfterWebContentTermination;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,147 @@
+/**
+ * Copyright 2020 The AMP HTML Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS-IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#import "AMPKWebViewerLifecycle.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+@implementation AMPKWebViewerLifecycle {
+  // Whether pauseAfterInactiveTimeout is scheduled, i.e. the article is hidden but not yet paused.
+  BOOL _pauseScheduled;
+}
+
+- (instancetype)init {
+  self = [super init];
+  if (self) {
+    _reloadsWhenVisible = YES;
+  }
+  return self;
+}
+
+- (AMPKVisibilityState)visibilityState {
+  if (_visible) {
+    return AMPKVisibilityStateVisible;
+  }
+  if ([_delegate webViewerLifecycleIsPrefetched:self]) {
+    return AMPKVisibilityStatePrefetched;
+  }
+  return _paused ? AMPKVisibilityStatePaused : AMPKVisibilityStateHidden;
+}
+
+- (void)setVisible:(BOOL)visible {
+  if ([_delegate webViewerLifecycleIsPrefetched:self]) {
+    [self cancelScheduledPause];
+    _paused = NO;
+    _visible = NO;
+    [_delegate webViewerLifecycle:self didEnterVisibilityState:AMPKVisibilityStatePrefetched];
+  } else if (visible) {
+    [self cancelScheduledPause];
+    _paused = NO;
+    _visible = YES;
+    if (_webContentTerminated && _reloadsWhenVisible) {
+      [self reloadAfterWebContentTermination];
+    }
+    [_delegate webViewerLifecycle:self didEnterVisibilityState:AMPKVisibilityStateVisible];
+  } else {
+    _visible = NO;
+    if (!_paused) {
+      [_delegate webViewerLifecycle:self didEnterVisibilityState:AMPKVisibilityStateHidden];
+      [self schedulePause];
+    }
+  }
+  [_delegate webViewerLifecycleDidChange:self];
+}
+
+- (void)pause {
+  [self cancelScheduledPause];
+  if (_paused) {
+    return;
+  }
+  _paused = YES;
+  // A viewer that was jumped away from is never told it is hidden.
+  _visible = NO;
+  [_delegate webViewerLifecycle:self didEnterVisibilityState:AMPKVisibilityStatePaused];
+  [_delegate webViewerLifecycleDidChange:self];
+}
+
+- (void)articleWillLoad {
+  // The new document starts out inactive.
+  _paused = NO;
+  _webContentTerminated = NO;
+  if (!_visible) {
+    [self schedulePause];
+  }
+  [_delegate webViewerLifecycleDidChange:self];
+}
+
+- (void)cancelScheduledPause {
+  if (!_pauseScheduled) {
+    return;
+  }
+  _pauseScheduled = NO;
+  [NSObject cancelPreviousPerformRequestsWithTarget:self
+                                           selector:@selector(pauseAfterInactiveTimeout)
+                                             object:nil];
+}
+
+- (void)resendVisibilityState {
+  AMPKVisibilityState visibilityState = self.visibilityState;
+  // The AMP runtime starts out hidden.
+  if (visibilityState != AMPKVisibilityStateHidden) {
+    [_delegate webViewerLifecycle:self didEnterVisibilityState:visibilityState];
+  }
+}
+
+- (void)webContentProcessDidTerminate {
+  _webContentTerminated = YES;
+  [_delegate webViewerLifecycleDidChange:self];
+  if (_reloadsWhenVisible && _visible) {
+    [self reloadAfterWebContentTermination];
+  }
+}
+
+- (void)reloadAfterWebContentTermination {
+  if (!_webContentTerminated) {
+    return;
+  }
+  _webContentTerminated = NO;
+  [_delegate webViewerLifecycleDidChange:self];
+  [_delegate webViewerLifecycleNeedsReload:self];
+}
+
+#pragma mark - Private
+
+- (void)schedulePause {
+  if (_pauseScheduled || _inactiveTimeout <= 0) {
+    return;
+  }
+  _pauseScheduled = YES;
+  [self performSelector:@selector(pauseAfterInactiveTimeout)
+             withObject:nil
+             afterDelay:_inactiveTimeout];
+}
+
+- (void)pauseAfterInactiveTimeout {
+  _pauseScheduled = NO;
+  // The current article of a prefetched viewer is hidden too, but is about to be shown.
+  if (![_delegate webViewerLifecycleIsPrefetched:self]) {
+    [self pause];
+  }
+}
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -28,6 +28,12 @@ NS_ASSUME_NONNULL_BEGIN
 - (void)ampViewerDataSourceDidChange:(AMPKViewerDataSource *)dataSource;
 @end
 
+@class AMPKArticleMetadataCache;
+@class AMPKContentBlockingPolicy;
+@class AMPKFeedSnapshot;
+@class AMPKLoadScheduler;
+@class AMPKRuntimeCache;
+@class AMPKViewerMetrics;
 @class AMPKWebViewerViewController;
 
 @interface AMPKViewerDataSource : NSObject <UIPageViewControllerDataSource, NSCoding, NSCopying>
@@ -47,6 +53,34 @@ NS_ASSUME_NONNULL_BEGIN
  */
 @property(nonatomic, readonly) NSSet <AMPKWebViewerViewController *> *allLoadedViewControllers;
 
+/**
+ * Third-party requests to block in AMP views that are loaded but not visible, e.g. the prefetched
+ * neighbours of the current article. Nil by default, which blocks nothing.
+ */
+@property(nonatomic, nullable) AMPKContentBlockingPolicy *contentBlockingPolicy;
+
+/**
+ * Serves the AMP runtime from disk to the AMP views this data source creates, see AMPKRuntimeCache.
+ * Set it before the first article is requested: views that already exist keep what they had. The
+ * cache is refreshed when it is set, and its hits and misses are counted in metrics.
+ */
+@property(nonatomic, nullable) AMPKRuntimeCache *runtimeCache;
+
+/**
+ * Fills in the header of articles that were shown before straight away, rather than once their
+ * document has loaded, see AMPKArticleMetadataCache. Nil by default.
+ */
+@property(nonatomic, nullable) AMPKArticleMetadataCache *metadataCache;
+
+/**
+ * Whether the AMP views this data source creates attach articles to a warm shell as shadow
+ * documents rather than navigating to them, see AMPKWebViewerViewController. NO by default.
+ */
+@property(nonatomic) BOOL usesShadowDocuments;
+
+/** How long readers waited for the articles of this data source to be shown. */
+@property(nonatomic, readonly) AMPKViewerMetrics *metrics;
+
 /**
  * Designated init method.
  * @param domainName form as https://xxx.google.com/.
@@ -55,6 +89,9 @@ NS_ASSUME_NONNULL_BEGIN
 
 - (instancetype)init NS_UNAVAILABLE;
 
+/** The viewer domain given to initWithDomainName:. */
+@property(nonatomic, readonly) NSURL *domainName;
+
 /**
  * Sets the current AMP Articles being used by this datasource to provide to the WebViews.
  * @param articles The articles to set.
@@ -65,6 +102,14 @@ NS_ASSUME_NONNULL_BEGIN
 - (void)setAmpArticles:(NSArray<id<AMPKArticleProtocol>> *)articles
           usingHeaders:(nullable NSDictionary *)headers;
 
+/**
+ * Sets the current AMP Articles to those of @c snapshot, which is adopted as is: the articles are
+ * not copied again and the URLs it computed are the ones loaded. Like setAmpArticles:usingHeaders:
+ * nothing is reloaded if the articles are the same as the current ones.
+ * @param snapshot A snapshot built for this data source's @c domainName, e.g. by AMPKFeedIngestor.
+ */
+- (void)setFeedSnapshot:(AMPKFeedSnapshot *)snapshot;
+
 /** Updates current index for visible view controller. */
 - (void)setCurrentVisibleIndex:(NSInteger)index;
 
@@ -85,6 +130,49 @@ NS_ASSUME_NONNULL_BEGIN
  */
 - (AMPKWebViewerViewController *)objectAtIndexedSubscript:(NSInteger)index;
 
+/**
+ * Returns an AMP view for @c article, an AMP page linked from one of the articles, taken from the
+ * reuse pool when there is one. The same view is returned while the linked article stays the same;
+ * asking for another one puts it back in the pool. Unless @c visible, the article loads after the
+ * current one and its neighbours, like a prefetch.
+ */
+- (AMPKWebViewerViewController *)viewControllerForLinkedArticle:(id<AMPKArticleProtocol>)article
+                                                        visible:(BOOL)visible;
+
+/**
+ * Puts the view of a linked article back in the reuse pool once it has been dismissed. Does nothing
+ * if @c viewController isn't the current linked view.
+ */
+- (void)releaseLinkedViewController:(AMPKWebViewerViewController *)viewController;
+
+@end
+
+/** Class extension for tuning how many AMP views are kept loaded, and how long they run. */
+@interface AMPKViewerDataSource ()
+
+/**
+ * The most AMP views kept loaded at once, counting the ones waiting in the reuse pool. Views beyond
+ * the current article, its neighbours and the prefetched one stay in the pool so they don't need
+ * a new web view. Defaults to 4, and can't go below 3, the current article and its neighbours;
+ * with 3 nothing is prefetched.
+ */
+@property(nonatomic) NSInteger maxLoadedViewControllers;
+
+/**
+ * How long, in seconds, a loaded AMP view that isn't visible stays active before its AMP runtime is
+ * paused, stopping its media, carousels and timers until it is next swiped to. Views that leave
+ * the current article's neighbourhood are paused straight away. Defaults to 10; 0 only pauses
+ * those.
+ */
+@property(nonatomic) NSTimeInterval inactiveViewerTimeout;
+
+/**
+ * How long, in seconds, the neighbours of the current article wait for it to be shown before they
+ * start loading anyway. Prefetched articles wait for the neighbours the same way. Defaults to 1;
+ * 0 starts loading them all at once.
+ */
+@property(nonatomic) NSTimeInterval stagedLoadTimeout;
+
 @end
 
 /** Private header to expose internal methods for unit tests. */
@@ -92,6 +180,9 @@ NS_ASSUME_NONNULL_BEGIN
 
 - (BOOL)areArticlesSimilar:(NSArray<id<AMPKArticleProtocol>> *)articles;
 
+/** Orders the loads of the AMP views; the trace simulator drives its clock. */
+@property(nonatomic, readonly) AMPKLoadScheduler *loadScheduler;
+
 @end
 
 NS_ASSUME_NONNULL_END
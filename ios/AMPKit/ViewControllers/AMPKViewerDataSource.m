@@ -16,13 +16,27 @@
 
 #import "AMPKViewerDataSource.h"
 
+#import "AMPKFeedSnapshot.h"
+#import "AMPKLoadScheduler.h"
+#import "AMPKRuntimeCache.h"
+#import "AMPKViewerMetrics.h"
 #import "AMPKWebViewerViewController.h"
 #import "AMPKWebViewerViewController_private.h"
 
 NS_ASSUME_NONNULL_BEGIN
 
+// The current article, its neighbours on either side and the one being prefetched.
 static const NSInteger kMaxAmpViewsToLoad = 4;
 
+// The current article and its neighbours, which the page view controller swipes to.
+static const NSInteger kMinAmpViewsToLoad = 3;
+
+// How long a neighbour of the current article stays active after it was last on screen.
+static const NSTimeInterval kInactiveViewerTimeout = 10;
+
+// How long the current article gets the network to itself before its neighbours start loading.
+static const NSTimeInterval kStagedLoadTimeout = 1;
+
 @implementation AMPKViewerDataSource {
   NSArray<id<AMPKArticleProtocol>> *_ampArticles;
   NSMutableSet<AMPKWebViewerViewController *> *_viewControllers;
@@ -31,8 +45,17 @@ static const NSInteger kMaxAmpViewsToLoad = 4;
   NSInteger _currentVisibleIndex;
   NSInteger _prefetchIndex;
 
-  NSURL *_domainName;
   NSDictionary *_headers;
+  // Set when the articles came from setFeedSnapshot:, to load the URLs it computed.
+  AMPKFeedSnapshot *_feedSnapshot;
+
+  // The current article while it hasn't been shown yet, and when it became the current one.
+  AMPKWebViewerViewController *_timedViewController;
+  NSTimeInterval _timedSince;
+
+  // The view of the AMP page last linked to, see viewControllerForLinkedArticle:visible:.
+  AMPKWebViewerViewController *_linkedViewController;
+  id<AMPKArticleProtocol> _linkedArticle;
 }
 
 - (instancetype)initWithDomainName:(NSURL *)domainName {
@@ -44,6 +67,11 @@ static const NSInteger kMaxAmpViewsToLoad = 4;
     _recordedContentOffset = [NSMutableDictionary dictionary];
     _currentVisibleIndex = NSNotFound;
     _prefetchIndex = NSNotFound;
+    _maxLoadedViewControllers = kMaxAmpViewsToLoad;
+    _inactiveViewerTimeout = kInactiveViewerTimeout;
+    _metrics = [[AMPKViewerMetrics alloc] init];
+    _loadScheduler = [[AMPKLoadScheduler alloc] init];
+    self.stagedLoadTimeout = kStagedLoadTimeout;
   }
   return self;
 }
@@ -61,6 +89,24 @@ static const NSInteger kMaxAmpViewsToLoad = 4;
   [aCoder encodeObject:_ampArticles forKey:@"_ampArticles"];
 }
 
+- (void)setMaxLoadedViewControllers:(NSInteger)maxLoadedViewControllers {
+  _maxLoadedViewControllers = MAX(maxLoadedViewControllers, kMinAmpViewsToLoad);
+}
+
+- (void)setStagedLoadTimeout:(NSTimeInterval)stagedLoadTimeout {
+  _stagedLoadTimeout = MAX(stagedLoadTimeout, 0);
+  _loadScheduler.stageTimeout = _stagedLoadTimeout;
+}
+
+- (void)setRuntimeCache:(nullable AMPKRuntimeCache *)runtimeCache {
+  if (runtimeCache == _runtimeCache) {
+    return;
+  }
+  _runtimeCache = runtimeCache;
+  // A new runtime is served once all of its scripts are on disk, see AMPKRuntimeCache.
+  [runtimeCache refreshWithCompletion:nil];
+}
+
 - (NSUInteger)count {
   return [_ampArticles count];
 }
@@ -71,15 +117,39 @@ static const NSInteger kMaxAmpViewsToLoad = 4;
     return;
   }
 
-  _ampArticles = [[NSArray alloc] initWithArray:articles copyItems:YES];
+  _feedSnapshot = nil;
+  [self replaceArticles:[[NSArray alloc] initWithArray:articles copyItems:YES] headers:headers];
+}
+
+- (void)setFeedSnapshot:(AMPKFeedSnapshot *)snapshot {
+  NSAssert([snapshot.domainName isEqual:_domainName],
+           @"The snapshot was built for %@ rather than %@", snapshot.domainName, _domainName);
+  if ([self areArticlesSimilar:snapshot.articles]) {
+    // Keep the snapshot's URLs for the articles that are loaded from now on.
+    _ampArticles = snapshot.articles;
+    _feedSnapshot = snapshot;
+    return;
+  }
+
+  _feedSnapshot = snapshot;
+  [self replaceArticles:snapshot.articles headers:snapshot.headers];
+}
+
+- (void)replaceArticles:(NSArray<id<AMPKArticleProtocol>> *)articles
+                headers:(nullable NSDictionary *)headers {
+  _ampArticles = articles;
   _headers = headers;
   [_viewControllers enumerateObjectsUsingBlock:
        ^(AMPKWebViewerViewController *ampViewer, BOOL *stop) {
+         [self cancelLoadOfViewController:ampViewer];
          [ampViewer prepareForReuse];
        }];
   [_recordedContentOffset removeAllObjects];
-  [_reuseableViewControllerPool unionSet:_viewControllers];
+  [_reuseableViewControllerPool unionSet:[self liveViewControllers:_viewControllers]];
   [_viewControllers removeAllObjects];
+  // Whichever article is current next is a new one, even at the same index.
+  _currentVisibleIndex = NSNotFound;
+  _prefetchIndex = NSNotFound;
 
   [_delegate ampViewerDataSourceDidChange:self];
 }
@@ -112,9 +182,11 @@ static const NSInteger kMaxAmpViewsToLoad = 4;
   if (_currentVisibleIndex != index) {
     _currentVisibleIndex = index;
 
-    AMPKWebViewerViewController *before = self[index - 1];
+    // The current article first, so it starts loading ahead of its neighbours.
     AMPKWebViewerViewController *current = self[index];
+    AMPKWebViewerViewController *before = self[index - 1];
     AMPKWebViewerViewController *after = self[index + 1];
+    [self startTimingViewController:current];
 
     NSMutableSet *viewControllers = [NSMutableSet setWithCapacity:3];
     if (before) {
@@ -129,13 +201,16 @@ static const NSInteger kMaxAmpViewsToLoad = 4;
 
     // Determine which view controllers do not overlap with the 3 that will be active.
     [_viewControllers minusSet:viewControllers];
+    for (AMPKWebViewerViewController *ampViewer in _viewControllers) {
+      [self cancelLoadOfViewController:ampViewer];
+    }
 
     NSSet *viewControllersToRecycle;
     // Keep a reference to these excess view controllers. We need them to determine after resetting
     // the |_viewControllers| set how many of them should be added to the reuse pool.
     NSUInteger totalCurrentViewControllers =
         _viewControllers.count + _reuseableViewControllerPool.count;
-    if (_viewControllers.count > 0 && totalCurrentViewControllers < kMaxAmpViewsToLoad) {
+    if (_viewControllers.count > 0 && totalCurrentViewControllers < _maxLoadedViewControllers) {
       viewControllersToRecycle = [_viewControllers copy];
     }
     _viewControllers = viewControllers;
@@ -146,7 +221,8 @@ static const NSInteger kMaxAmpViewsToLoad = 4;
 
     _prefetchIndex = NSNotFound;
 
-    NSAssert(_viewControllers.count + _reuseableViewControllerPool.count <= kMaxAmpViewsToLoad,
+    NSAssert(_viewControllers.count + _reuseableViewControllerPool.count <=
+                 _maxLoadedViewControllers,
              @"total view out of sync");
   }
 }
@@ -159,6 +235,12 @@ static const NSInteger kMaxAmpViewsToLoad = 4;
 // TODO(stephen-deg): refactor the AMP view creation, re-use pool, and pre-fetching to exact it from
 // the subscript support.
 - (void)prefetchItemAtIndex:(NSInteger)index {
+  // The reader is swiping to |index|, so it is the most urgent load if it hasn't started yet.
+  AMPKWebViewerViewController *swipeTarget = [self loadedViewControllerAtIndex:index];
+  if (swipeTarget) {
+    [_loadScheduler raisePriorityOfLoadWithKey:swipeTarget toPriority:AMPKLoadPriorityVisible];
+  }
+
   NSInteger prefetchIndex = _currentVisibleIndex + (index < _currentVisibleIndex ? -2 : 2);
   if (prefetchIndex != _prefetchIndex) {
     AMPKWebViewerViewController *prefetchView = self[_prefetchIndex];
@@ -166,6 +248,11 @@ static const NSInteger kMaxAmpViewsToLoad = 4;
       [_viewControllers removeObject:prefetchView];
       [self addToReusePool:[NSSet setWithObject:prefetchView]];
     }
+    // Without room beside the current article and its neighbours, nothing is prefetched.
+    if (_viewControllers.count >= _maxLoadedViewControllers) {
+      _prefetchIndex = NSNotFound;
+      return;
+    }
     _prefetchIndex = prefetchIndex;
 
     // Here, we use the lazy loading trick described above to start the loading of the amp view that
@@ -174,8 +261,9 @@ static const NSInteger kMaxAmpViewsToLoad = 4;
     // accessing that object index. Wrapping it in a void cast is simply to prevent any warnings.
     ((void)self[_prefetchIndex]);
 
-    NSAssert(_viewControllers.count + _reuseableViewControllerPool.count <= kMaxAmpViewsToLoad,
-            @"total view out of sync");
+    NSAssert(_viewControllers.count + _reuseableViewControllerPool.count <=
+                 _maxLoadedViewControllers,
+             @"total view out of sync");
   }
 }
 
@@ -183,11 +271,18 @@ static const NSInteger kMaxAmpViewsToLoad = 4;
 // number of AMP views that should be kept alive.
 - (void)addToReusePool:(NSSet<AMPKWebViewerViewController *>*)addToPool {
   [addToPool enumerateObjectsUsingBlock:^(AMPKWebViewerViewController *ampViewer, BOOL *stop) {
-    _recordedContentOffset[@(ampViewer.viewerDataSourceIndex)] =
-        [NSValue valueWithCGPoint:ampViewer.viewerContentOffset];
+    if (ampViewer.viewerDataSourceIndex != NSNotFound) {
+      _recordedContentOffset[@(ampViewer.viewerDataSourceIndex)] =
+          [NSValue valueWithCGPoint:ampViewer.viewerContentOffset];
+    }
+    [self cancelLoadOfViewController:ampViewer];
+    // The article stays loaded, and running, until the view is reused for another one.
+    [ampViewer pause];
   }];
 
-  NSInteger totalPoolSize = kMaxAmpViewsToLoad - _viewControllers.count;
+  // Dead views have nothing loaded worth keeping.
+  addToPool = [self liveViewControllers:addToPool];
+  NSInteger totalPoolSize = _maxLoadedViewControllers - _viewControllers.count;
   NSInteger totalFreePoolSize = totalPoolSize - _reuseableViewControllerPool.count;
 
   // Only add views to the reuse pool if it's not already at capacity.
@@ -198,8 +293,9 @@ static const NSInteger kMaxAmpViewsToLoad = 4;
     }];
     [_reuseableViewControllerPool unionSet:addToPool];
 
-    NSAssert(_viewControllers.count + _reuseableViewControllerPool.count <= kMaxAmpViewsToLoad,
-              @"total view out of sync");
+    NSAssert(_viewControllers.count + _reuseableViewControllerPool.count <=
+                 _maxLoadedViewControllers,
+             @"total view out of sync");
   }
 }
 
@@ -227,6 +323,14 @@ static const NSInteger kMaxAmpViewsToLoad = 4;
   return [prunedSet copy];
 }
 
+// The view controllers of |set| whose web content process wasn't terminated.
+- (NSSet<AMPKWebViewerViewController *> *)liveViewControllers:
+        (NSSet<AMPKWebViewerViewController *> *)set {
+  return [set objectsPassingTest:^BOOL(AMPKWebViewerViewController *viewController, BOOL *stop) {
+    return !viewController.isWebContentTerminated;
+  }];
+}
+
 - (NSSet<AMPKWebViewerViewController *> *)allLoadedViewControllers {
   return [_viewControllers copy];
 }
@@ -259,31 +363,17 @@ static const NSInteger kMaxAmpViewsToLoad = 4;
     return nil;
   }
 
-  __block BOOL needsToResetContentOffset = YES;
-  __block AMPKWebViewerViewController *ampWebViewController;
-  [_viewControllers enumerateObjectsUsingBlock:
-      ^(AMPKWebViewerViewController *viewController, BOOL *stop) {
-        if (viewController.viewerDataSourceIndex == index) {
-          *stop = YES;
-          ampWebViewController = viewController;
-          needsToResetContentOffset = NO;
-        }
-  }];
+  AMPKWebViewerViewController *ampWebViewController = [self loadedViewControllerAtIndex:index];
+  BOOL needsToResetContentOffset = !ampWebViewController;
 
   if (!ampWebViewController) {
-    ampWebViewController = [_reuseableViewControllerPool anyObject];
-    if (ampWebViewController) {
-      [_reuseableViewControllerPool removeObject:ampWebViewController];
-    }
-  }
-
-  if (!ampWebViewController) {
-    ampWebViewController = [[AMPKWebViewerViewController alloc] initWithDomainName:_domainName];
+    ampWebViewController = [self dequeueViewController];
   }
 
   ampWebViewController.viewerDataSourceIndex = index;
+  [self configureViewController:ampWebViewController];
   [_viewControllers addObject:ampWebViewController];
-  [ampWebViewController loadAmpArticle:_ampArticles[index] withHeaders:_headers];
+  [self scheduleLoadOfViewController:ampWebViewController atIndex:index];
 
   if (_recordedContentOffset[@(index)] && needsToResetContentOffset) {
     ampWebViewController.viewerContentOffset = [_recordedContentOffset[@(index)] CGPointValue];
@@ -296,9 +386,214 @@ static const NSInteger kMaxAmpViewsToLoad = 4;
   AMPKViewerDataSource *dataSource =
       [[[self class] alloc] initWithDomainName:_domainName];
   dataSource->_ampArticles = [_ampArticles copy];
+  dataSource->_maxLoadedViewControllers = _maxLoadedViewControllers;
+  dataSource->_contentBlockingPolicy = _contentBlockingPolicy;
+  dataSource->_inactiveViewerTimeout = _inactiveViewerTimeout;
+  dataSource.stagedLoadTimeout = _stagedLoadTimeout;
+  dataSource->_feedSnapshot = _feedSnapshot;
+  dataSource->_runtimeCache = _runtimeCache;
+  dataSource->_metadataCache = _metadataCache;
+  dataSource->_usesShadowDocuments = _usesShadowDocuments;
   return dataSource;
 }
 
+- (AMPKWebViewerViewController *)viewControllerForLinkedArticle:(id<AMPKArticleProtocol>)article
+                                                        visible:(BOOL)visible {
+  AMPKLoadPriority priority = visible ? AMPKLoadPriorityVisible : AMPKLoadPriorityPrefetch;
+  if (_linkedViewController && [_linkedArticle.publisherURL isEqual:article.publisherURL]) {
+    if (_linkedViewController.isWebContentTerminated) {
+      [self scheduleReloadOfViewController:_linkedViewController priority:priority];
+    } else {
+      [_loadScheduler raisePriorityOfLoadWithKey:_linkedViewController toPriority:priority];
+    }
+    return _linkedViewController;
+  }
+
+  if (_linkedViewController) {
+    [self addToReusePool:[NSSet setWithObject:_linkedViewController]];
+  }
+  AMPKWebViewerViewController *viewController = [self dequeueViewController];
+  // Not one of the articles, so it never has an index.
+  viewController.viewerDataSourceIndex = NSNotFound;
+  [self configureViewController:viewController];
+  _linkedViewController = viewController;
+  _linkedArticle = article;
+
+  NSDictionary *headers = _headers;
+  [_loadScheduler scheduleLoadWithKey:viewController
+                             priority:priority
+                                block:^{
+                                  [viewController loadAmpArticle:article withHeaders:headers];
+                                }];
+  return viewController;
+}
+
+- (void)releaseLinkedViewController:(AMPKWebViewerViewController *)viewController {
+  if (viewController != _linkedViewController) {
+    return;
+  }
+  _linkedViewController = nil;
+  _linkedArticle = nil;
+  [self addToReusePool:[NSSet setWithObject:viewController]];
+}
+
+#pragma mark - Reuse
+
+// A view from the reuse pool, or a new one if it is empty.
+- (AMPKWebViewerViewController *)dequeueViewController {
+  AMPKWebViewerViewController *viewController = [_reuseableViewControllerPool anyObject];
+  if (viewController) {
+    [_reuseableViewControllerPool removeObject:viewController];
+    // Set again by AMPKViewer if it becomes the current article. A linked page has no viewer.
+    viewController.viewer = nil;
+    return viewController;
+  }
+
+  viewController = [[AMPKWebViewerViewController alloc] initWithDomainName:_domainName];
+  viewController.runtimeCache = _runtimeCache;
+  __weak AMPKViewerDataSource *weakSelf = self;
+  viewController.revealHandler = ^(AMPKWebViewerViewController *viewer) {
+    [weakSelf viewControllerDidReveal:viewer];
+  };
+  viewController.terminationHandler = ^(AMPKWebViewerViewController *viewer) {
+    [weakSelf viewControllerDidTerminate:viewer];
+  };
+  AMPKViewerMetrics *metrics = _metrics;
+  viewController.runtimeCacheHandler = ^(BOOL hit, NSUInteger length) {
+    if (hit) {
+      [metrics recordRuntimeCacheHitWithLength:length];
+    } else {
+      [metrics recordRuntimeCacheMiss];
+    }
+  };
+  return viewController;
+}
+
+- (void)configureViewController:(AMPKWebViewerViewController *)viewController {
+  viewController.contentBlockingPolicy = _contentBlockingPolicy;
+  viewController.inactiveTimeout = _inactiveViewerTimeout;
+  viewController.usesShadowDocuments = _usesShadowDocuments;
+  viewController.metadataCache = _metadataCache;
+}
+
+#pragma mark - Load Scheduling
+
+// The view controller at |index| among the current article, its neighbours and the prefetched one.
+- (nullable AMPKWebViewerViewController *)loadedViewControllerAtIndex:(NSInteger)index {
+  for (AMPKWebViewerViewController *viewController in _viewControllers) {
+    if (viewController.viewerDataSourceIndex == index) {
+      return viewController;
+    }
+  }
+  return nil;
+}
+
+- (AMPKLoadPriority)loadPriorityForIndex:(NSInteger)index {
+  if (_currentVisibleIndex == NSNotFound || index == _currentVisibleIndex) {
+    return AMPKLoadPriorityVisible;
+  }
+  if (index == _currentVisibleIndex - 1 || index == _currentVisibleIndex + 1) {
+    return AMPKLoadPriorityNeighbour;
+  }
+  return AMPKLoadPriorityPrefetch;
+}
+
+// Loads the article at |index| into |viewController| once the load scheduler lets it: the current
+// article straight away, its neighbours once it is shown and the prefetched one after them.
+- (void)scheduleLoadOfViewController:(AMPKWebViewerViewController *)viewController
+                             atIndex:(NSInteger)index {
+  id<AMPKArticleProtocol> article = _ampArticles[index];
+  if ([viewController.article.publisherURL isEqual:article.publisherURL]) {
+    if (viewController.isWebContentTerminated) {
+      [self scheduleReloadOfViewController:viewController
+                                  priority:[self loadPriorityForIndex:index]];
+    }
+    return;
+  }
+
+  NSDictionary *headers = _headers;
+  AMPKFeedSnapshot *feedSnapshot = _feedSnapshot;
+  [_loadScheduler scheduleLoadWithKey:viewController
+                             priority:[self loadPriorityForIndex:index]
+                                block:^{
+                                  if (feedSnapshot) {
+                                    [viewController
+                                        loadAmpArticle:article
+                                           withHeaders:headers
+                                            proxiedURL:[feedSnapshot proxiedURLAtIndex:index]
+                                               loadURL:[feedSnapshot loadURLAtIndex:index]];
+                                  } else {
+                                    [viewController loadAmpArticle:article withHeaders:headers];
+                                  }
+                                }];
+}
+
+- (void)cancelLoadOfViewController:(AMPKWebViewerViewController *)viewController {
+  [_loadScheduler cancelLoadWithKey:viewController];
+  if (viewController == _timedViewController) {
+    // Left before it was shown.
+    _timedViewController = nil;
+  }
+}
+
+- (void)viewControllerDidReveal:(AMPKWebViewerViewController *)viewController {
+  [_loadScheduler loadDidFinishWithKey:viewController];
+  if (viewController == _timedViewController) {
+    [_metrics recordTimeToVisible:_loadScheduler.clock() - _timedSince];
+    _timedViewController = nil;
+  }
+}
+
+// Starts timing how long the new current article takes to be shown, see AMPKViewerMetrics.
+- (void)startTimingViewController:(nullable AMPKWebViewerViewController *)viewController {
+  _timedViewController = nil;
+  if (!viewController) {
+    return;
+  }
+  if (viewController.isRevealed) {
+    [_metrics recordTimeToVisible:0];
+    return;
+  }
+  _timedViewController = viewController;
+  _timedSince = _loadScheduler.clock();
+}
+
+#pragma mark - Web Content Process Termination
+
+// The system terminated the web content process of |viewController|, e.g. under memory pressure,
+// which left its web view blank. A pooled view is dropped, the view on screen is reloaded straight
+// away and the others are reloaded once they are asked for again.
+- (void)viewControllerDidTerminate:(AMPKWebViewerViewController *)viewController {
+  [_metrics recordWebContentTermination];
+  if ([_reuseableViewControllerPool containsObject:viewController]) {
+    [_reuseableViewControllerPool removeObject:viewController];
+    return;
+  }
+
+  // A load in flight won't finish. Unlike cancelLoadOfViewController:, the time to visible of the
+  // current article keeps running.
+  [_loadScheduler cancelLoadWithKey:viewController];
+  NSInteger index = viewController.viewerDataSourceIndex;
+  BOOL isCurrent = index != NSNotFound && index == _currentVisibleIndex &&
+                   [_viewControllers containsObject:viewController];
+  if (viewController.visible || isCurrent) {
+    [self scheduleReloadOfViewController:viewController priority:AMPKLoadPriorityVisible];
+  }
+}
+
+- (void)scheduleReloadOfViewController:(AMPKWebViewerViewController *)viewController
+                              priority:(AMPKLoadPriority)priority {
+  AMPKViewerMetrics *metrics = _metrics;
+  [_loadScheduler scheduleLoadWithKey:viewController
+                             priority:priority
+                                block:^{
+                                  if (viewController.isWebContentTerminated) {
+                                    [metrics recordWebContentReload];
+                                    [viewController reloadAfterWebContentTermination];
+                                  }
+                                }];
+}
+
 #pragma mark - Debug
 
 - (NSString *)description {
@@ -19,6 +19,9 @@
 
 NS_ASSUME_NONNULL_BEGIN
 
+@class AMPKArticleMetadataCache;
+@class AMPKContentBlockingPolicy;
+@class AMPKRuntimeCache;
 @class AMPKViewer;
 @class AMPKWebViewerMessageHandlerController;
 @class AMPKWebViewerJsMessage;
@@ -29,7 +32,10 @@ NS_ASSUME_NONNULL_BEGIN
 
 @optional
 
-/** Notify delegate that current AMP viewer's header information has been changed. */
+/**
+ * Notify delegate that current AMP viewer's header information has been changed. Called once the
+ * changes of a run loop turn are in, and only if the title or sharing URL actually changed.
+ */
 - (void)ampWebViewerDidChangeHeaderInfo:(AMPKWebViewerViewController *)ampWebViewController;
 
 /** Notify delegate that current AMP viewer did finish loading. */
@@ -60,6 +66,9 @@ NS_ASSUME_NONNULL_BEGIN
  */
 @property(nonatomic, readonly, nullable) id<AMPKArticleProtocol> article;
 
+/** The URL to share the article with: its canonical URL once known, else its AMP viewer URL. */
+@property(nonatomic, readonly, nullable) NSURL *sharingURL;
+
 /**
  * This is used to hide the web view. Generally, users should call setVisible rather than directly
  * set the hidden property on the web view. This will send the appropriate visibility state
@@ -68,6 +77,54 @@ NS_ASSUME_NONNULL_BEGIN
  */
 @property(nonatomic) BOOL visible;
 
+/**
+ * Whether the AMP runtime has been told to pause this viewer, stopping its media, carousels and
+ * timers. A paused viewer stays paused when it is hidden again and resumes when it is made visible.
+ */
+@property(nonatomic, readonly, getter=isPaused) BOOL paused;
+
+/**
+ * How long the viewer can stay hidden but active, e.g. as a neighbour of the current article,
+ * before it is paused. Zero, the default, leaves it active. Set by AMPKViewerDataSource.
+ */
+@property(nonatomic) NSTimeInterval inactiveTimeout;
+
+/**
+ * Third-party requests to block while this viewer isn't visible, e.g. while it is prefetched next
+ * to the current article. Set by AMPKViewerDataSource; nil, the default, blocks nothing.
+ */
+@property(nonatomic, nullable) AMPKContentBlockingPolicy *contentBlockingPolicy;
+
+/**
+ * The number of frames the content blocking policy stopped from loading in the current article.
+ * Reset when a new article is loaded.
+ */
+@property(nonatomic, readonly) NSUInteger blockedRequestCount;
+
+/**
+ * Whether articles are attached as shadow documents to a shell page that keeps the AMP runtime
+ * loaded, rather than navigated to. Switching articles then only costs parsing and rendering the
+ * new document: the runtime isn't fetched and compiled again and there is no new messaging
+ * handshake. The document is fetched natively, with the web view's cookies, and streamed into the
+ * shell. The shell is loaded under the article's cache subdomain, so it is only kept for the next
+ * article from the same publisher. Articles that can't be attached, those whose publisher has no
+ * plain cache subdomain (see ampk_CacheSubdomainURL) and all articles before iOS 11 are navigated
+ * to as usual. NO by default; set by AMPKViewerDataSource.
+ */
+@property(nonatomic) BOOL usesShadowDocuments;
+
+/**
+ * Serves ampk-runtime:// script URLs to the web view on iOS 11 and later. Only takes effect if set
+ * before the view loads, which AMPKViewerDataSource takes care of.
+ */
+@property(nonatomic, nullable) AMPKRuntimeCache *runtimeCache;
+
+/**
+ * Fills in the title and sharing URL of articles seen before as soon as they start loading, and
+ * remembers them once their document has loaded. Set by AMPKViewerDataSource.
+ */
+@property(nonatomic, nullable) AMPKArticleMetadataCache *metadataCache;
+
 /**
  * Designated init method.
  * @param domainName form as https://xxx.google.com/.
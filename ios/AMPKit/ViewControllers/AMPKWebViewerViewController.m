@@ -18,8 +18,14 @@
 
 #import <WebKit/WebKit.h>
 
+#import "AMPKArticleMetadataCache.h"
+#import "AMPKContentBlockingPolicy.h"
+#import "AMPKRuntimeCache.h"
+#import "AMPKRuntimeCache_private.h"
+#import "AMPKShadowDocumentLoader.h"
 #import "AMPKViewer.h"
 #import "AMPKWebViewerJsMessage.h"
+#import "AMPKWebViewerLifecycle.h"
 #import "AMPKWebViewerMessageHandlerController.h"
 #import "AMPKRuntimeUtilities.h"
 #import "AMPKWebViewerViewController_private.h"
@@ -32,12 +38,26 @@ NS_ASSUME_NONNULL_BEGIN
 static void * kAMPKWebViewerKVOContext = &kAMPKWebViewerKVOContext;
 static NSString *const kLinkRelsDocumentLoaded = @"linkRels";
 static NSString *const kCanonicalDocumentLoaded = @"canonical";
+static NSString *const kTitleDocumentLoaded = @"title";
 NSString * const AMPKHeaderNameField = @"X-AMP-VIEWER";
 
-@interface AMPKWebViewerViewController ()
+// Where the shell shadow documents are attached to is, see usesShadowDocuments.
+typedef NS_ENUM(NSInteger, AMPKShellState) {
+  AMPKShellStateNone,
+  AMPKShellStateLoading,
+  AMPKShellStateReady,
+};
+
+@interface AMPKWebViewerViewController () <AMPKWebViewerLifecycleDelegate>
 @property(nonatomic, nullable) id<AMPKArticleProtocol> article;
 
 @property(nonatomic, readwrite, nullable) NSURL *sharingURL;
+
+#if __IPHONE_OS_VERSION_MAX_ALLOWED >= 110000
+- (void)loadShadowDocumentWithID:(NSInteger)documentID
+                         cookies:(NSArray<NSHTTPCookie *> *)cookies
+                     cookieStore:(WKHTTPCookieStore *)cookieStore API_AVAILABLE(ios(11.0));
+#endif
 @end
 
 @implementation AMPKWebViewerViewController {
@@ -49,9 +69,43 @@ NSString * const AMPKHeaderNameField = @"X-AMP-VIEWER";
   // currentItem.initURL and use a ivar to keep track of it.
   BOOL _canGoBackward;
 
+  // Whether the current article has been shown. It is revealed as soon as the AMP runtime reports
+  // documentLoaded, which happens once the document first renders, rather than when the web view
+  // stops loading, which waits for every ad and analytics request. The loading KVO is a fallback
+  // for pages that never talk to the viewer.
+  BOOL _revealed;
+
+  // Whether contentBlockingPolicy's rules are applied to the web view, i.e. a policy is set and the
+  // viewer isn't visible.
+  BOOL _contentBlocked;
+
+  // Whether the article is visible, paused or terminated, and what the AMP runtime is told of it.
+  AMPKWebViewerLifecycle *_lifecycle;
+
+  // The shell and the article attached to it, if usesShadowDocuments. The shell is loaded under
+  // the article's cache origin and only reused for articles from the same one. The request is
+  // kept to navigate to the article if it can't be attached. The ID tells the shell's calls and
+  // the loader's callbacks for the current article from ones for an article that has since gone.
+  AMPKShellState _shellState;
+  NSURL *_shellURL;
+  NSInteger _shadowDocumentID;
+  NSURLRequest *_shadowDocumentRequest;
+  NSURL *_shadowDocumentURL;
+  BOOL _shadowDocumentStarted;
+  AMPKShadowDocumentLoader *_shadowDocumentLoader;
+
+  // What the current article was loaded with, to load it again if the web content process is
+  // terminated.
+  NSURLRequest *_articleRequest;
+  NSURL *_articleProxiedURL;
+
   AMPKWebViewerMessageHandlerController *_messageHandlerController;
 
   NSURL *_domainName;
+
+  // The header the delegate was last told about, so it hears about each change once.
+  NSString *_notifiedTitle;
+  NSURL *_notifiedSharingURL;
 }
 
 - (instancetype)initWithDomainName:(NSURL *)domainName {
@@ -59,16 +113,24 @@ NSString * const AMPKHeaderNameField = @"X-AMP-VIEWER";
   if (self) {
     _messageHandlerController = [[AMPKWebViewerMessageHandlerController alloc] init];
     _messageHandlerController.ampWebViewerController = self;
+    __weak AMPKWebViewerViewController *weakSelf = self;
+    _messageHandlerController.webContentProcessTerminationHandler = ^{
+      [weakSelf webContentProcessDidTerminate];
+    };
     _domainName = [domainName copy];
+    _lifecycle = [[AMPKWebViewerLifecycle alloc] init];
+    _lifecycle.delegate = self;
   }
   return self;
 }
 
 - (void)dealloc {
+  [_lifecycle cancelScheduledPause];
   [_webView removeObserver:self forKeyPath:@"loading"];
   [_webView removeObserver:self forKeyPath:@"title"];
   [_webView removeObserver:self forKeyPath:@"URL"];
   _webView.navigationDelegate = nil;
+  _webView.UIDelegate = nil;
   _webView.scrollView.delegate = nil;
 }
 
@@ -76,7 +138,18 @@ NSString * const AMPKHeaderNameField = @"X-AMP-VIEWER";
   [super viewDidLoad];
 
   WKWebViewConfiguration *config = [[WKWebViewConfiguration alloc] init];
+#if __IPHONE_OS_VERSION_MAX_ALLOWED >= 110000
+  if (@available(iOS 11.0, *)) {
+    if (_runtimeCache) {
+      [config setURLSchemeHandler:(id<WKURLSchemeHandler>)_runtimeCache
+                     forURLScheme:AMPKRuntimeCacheURLScheme];
+    }
+  }
+#endif
   _webView = [[WKWebView alloc] initWithFrame:self.view.bounds configuration:config];
+  if (_runtimeCache && _runtimeCacheHandler) {
+    [_runtimeCache setScriptHandler:_runtimeCacheHandler forWebView:_webView];
+  }
   _webView.autoresizingMask = UIViewAutoresizingFlexibleHeight | UIViewAutoresizingFlexibleWidth;
 
   [_webView addObserver:self forKeyPath:@"loading" options:0 context:&kAMPKWebViewerKVOContext];
@@ -84,6 +157,7 @@ NSString * const AMPKHeaderNameField = @"X-AMP-VIEWER";
   [_webView addObserver:self forKeyPath:@"URL" options:0 context:&kAMPKWebViewerKVOContext];
 
   _webView.navigationDelegate = _messageHandlerController;
+  _webView.UIDelegate = _messageHandlerController;
 
   _activityIndicator = [[MDCActivityIndicator alloc] initWithFrame:CGRectZero];
   [_activityIndicator sizeToFit];
@@ -96,7 +170,7 @@ NSString * const AMPKHeaderNameField = @"X-AMP-VIEWER";
 - (void)viewWillLayoutSubviews {
   [super viewWillLayoutSubviews];
 
-  _webView.hidden = _webView.loading;
+  _webView.hidden = !_revealed;
 
   CGRect bounds = self.view.bounds;
   _activityIndicator.center = CGPointMake(CGRectGetMidX(bounds), CGRectGetMidY(bounds));
@@ -105,7 +179,7 @@ NSString * const AMPKHeaderNameField = @"X-AMP-VIEWER";
 - (void)viewWillAppear:(BOOL)animated {
   [super viewWillAppear:animated];
 
-  if (_webView.loading) {
+  if (!_revealed && _webView.loading) {
     [_activityIndicator startAnimating];
   }
 }
@@ -121,7 +195,7 @@ NSString * const AMPKHeaderNameField = @"X-AMP-VIEWER";
 - (void)setViewerContentOffset:(CGPoint)viewerContentOffset {
   if (!CGPointEqualToPoint(_initialContentOffset, viewerContentOffset)) {
     _initialContentOffset = viewerContentOffset;
-    if (!_webView.loading) {
+    if (_revealed) {
       self.webScrollView.contentOffset = _initialContentOffset;
     } else {
       _hasInitialContentOffset = YES;
@@ -130,6 +204,10 @@ NSString * const AMPKHeaderNameField = @"X-AMP-VIEWER";
 }
 
 - (CGPoint)viewerContentOffset {
+  // A blank web view has lost where the reader was.
+  if (_lifecycle.webContentTerminated && _hasInitialContentOffset) {
+    return _initialContentOffset;
+  }
   return self.webScrollView.contentOffset;
 }
 
@@ -138,25 +216,68 @@ NSString * const AMPKHeaderNameField = @"X-AMP-VIEWER";
 }
 
 - (NSURL *)webURL {
-  return _webView.URL;
+  return _shadowDocumentURL ?: _webView.URL;
+}
+
+- (BOOL)visible {
+  return _lifecycle.visible;
 }
 
 - (void)setVisible:(BOOL)visible {
-  if (self.viewer.isPrefetched) {
-    [_messageHandlerController sendPrefetched];
-    _visible = NO;
-    self.view.hidden = NO;
-  } else {
-    [_messageHandlerController sendVisible:visible];
-    _visible = visible;
-    // We should hide the entire view controller when it's not being presented. The view
-    // controller's main view will have hidden set to NO as soon as the page view controller begins
-    // to page but before the view is ever shown to the user so there is no visible difference.
-    // This, however, resolves an issue where the view was visible because we force it into the
-    // hierarchy for pre-fetching and was visible "behind" the current view controller if you
-    // attempt to swipe beyond the view controller at the end (either index 0 or n-1).
-    self.view.hidden = !visible;
+  [_lifecycle setVisible:visible];
+  // We should hide the entire view controller when it's not being presented. The view controller's
+  // main view will have hidden set to NO as soon as the page view controller begins to page but
+  // before the view is ever shown to the user so there is no visible difference. This, however,
+  // resolves an issue where the view was visible because we force it into the hierarchy for
+  // pre-fetching and was visible "behind" the current view controller if you attempt to swipe
+  // beyond the view controller at the end (either index 0 or n-1).
+  self.view.hidden = !_lifecycle.visible && !self.viewer.isPrefetched;
+}
+
+- (BOOL)isPaused {
+  return _lifecycle.paused;
+}
+
+- (void)pause {
+  [_lifecycle pause];
+}
+
+- (NSTimeInterval)inactiveTimeout {
+  return _lifecycle.inactiveTimeout;
+}
+
+- (void)setInactiveTimeout:(NSTimeInterval)inactiveTimeout {
+  _lifecycle.inactiveTimeout = inactiveTimeout;
+}
+
+- (BOOL)isWebContentTerminated {
+  return _lifecycle.webContentTerminated;
+}
+
+- (void)setTerminationHandler:(nullable void (^)(AMPKWebViewerViewController *))terminationHandler {
+  _terminationHandler = [terminationHandler copy];
+  _lifecycle.reloadsWhenVisible = !_terminationHandler;
+}
+
+- (void)setContentBlockingPolicy:(nullable AMPKContentBlockingPolicy *)contentBlockingPolicy {
+  if (_contentBlockingPolicy == contentBlockingPolicy) {
+    return;
+  }
+  if (_contentBlocked) {
+    WKUserContentController *userContentController = _webView.configuration.userContentController;
+    [_contentBlockingPolicy removeFromUserContentController:userContentController];
+    _contentBlocked = NO;
+  }
+  _contentBlockingPolicy = contentBlockingPolicy;
+  [self updateContentBlocking];
+}
+
+- (BOOL)shouldBlockFrameRequest:(NSURLRequest *)request {
+  if (!_contentBlocked || ![_contentBlockingPolicy blocksURL:request.URL]) {
+    return NO;
   }
+  _blockedRequestCount++;
+  return YES;
 }
 
 - (void)loadAmpArticle:(id<AMPKArticleProtocol>)article
@@ -165,20 +286,37 @@ NSString * const AMPKHeaderNameField = @"X-AMP-VIEWER";
     return;
   }
 
+  NSAssert(article.publisherURL.host,
+             @"Must have a valid Host for AMP URL: %@",
+             article.publisherURL);
+  NSURL *proxiedURL = article.cdnURL ?: [article.publisherURL ampk_ProxiedURL];
+  [self loadAmpArticle:article
+           withHeaders:headers
+            proxiedURL:proxiedURL
+               loadURL:[proxiedURL URLBySettingProxyHashFragmentsForDomain:_domainName]];
+}
+
+- (void)loadAmpArticle:(id<AMPKArticleProtocol>)article
+           withHeaders:(nullable NSDictionary<NSString *, NSString *> *)headers
+            proxiedURL:(NSURL *)proxiedURL
+               loadURL:(NSURL *)loadURL {
+  if ([self.article.publisherURL isEqual:article.publisherURL]) {
+    return;
+  }
+
   self.article = [article copyWithZone:nil];
+  [self resetHeaderInfo];
 
   _canGoBackward = YES;
+  _revealed = NO;
+  _blockedRequestCount = 0;
 
   ((void)([self view]));  // Force to load view.
+  _webView.hidden = YES;
 
-  NSAssert(self.article.publisherURL.host,
-             @"Must have a valid Host for AMP URL: %@",
-             self.article.publisherURL);
-  _messageHandlerController.source = [self proxiedURL];
   _messageHandlerController.ampWebViewerController = self;
 
-  NSURL *url = [[self proxiedURL] URLBySettingProxyHashFragmentsForDomain:_domainName];
-  NSMutableURLRequest *urlRequest = [NSMutableURLRequest requestWithURL:url];
+  NSMutableURLRequest *urlRequest = [NSMutableURLRequest requestWithURL:loadURL];
   if (!headers[AMPKHeaderNameField]) {
     [urlRequest setValue:[NSBundle mainBundle].bundleIdentifier
       forHTTPHeaderField:AMPKHeaderNameField];
@@ -193,16 +331,30 @@ NSString * const AMPKHeaderNameField = @"X-AMP-VIEWER";
       [urlRequest setValue:obj forHTTPHeaderField:key];
     }
   }];
-  [_webView loadRequest:urlRequest];
+
+  _articleRequest = [urlRequest copy];
+  _articleProxiedURL = proxiedURL;
+  [_lifecycle articleWillLoad];
+  [self detachShadowDocument];
+  [self loadArticleRequest];
 }
 
+- (void)reloadAfterWebContentTermination {
+  [_lifecycle reloadAfterWebContentTermination];
+}
 
 - (void)prepareForReuse {
   self.webView.hidden = YES;
-  self.title = nil;
+  _revealed = NO;
+  _blockedRequestCount = 0;
   self.article = nil;
+  [self resetHeaderInfo];
   _canGoBackward = NO;
   _viewerDataSourceIndex = NSNotFound;
+  [_lifecycle cancelScheduledPause];
+  [self detachShadowDocument];
+  _articleRequest = nil;
+  _articleProxiedURL = nil;
 
   _initialContentOffset = CGPointZero;
   _hasInitialContentOffset = NO;
@@ -213,6 +365,7 @@ NSString * const AMPKHeaderNameField = @"X-AMP-VIEWER";
 
   _presenter = nil;
   _delegate = nil;
+  _viewer = nil;
 }
 
 #pragma mark - Paywall Access
@@ -248,23 +401,36 @@ NSString * const AMPKHeaderNameField = @"X-AMP-VIEWER";
 
 - (void)AMPDocumentLoadedWithMessage:(AMPKWebViewerJsMessage *)message {
   self.ampJsReady = YES;
+  [self revealIfNeeded];
   // It's possible we attempted to set the visible message before the document was loaded if the
   // user is swiping very quickly. In this case, we need to re-send the visible message after the
   // document loaded has been received so that the runtime can load all the elements (ads, pictures
   // videos, ect). This also ensures we don't attempt to re-send a visibility status of "visible" to
   // an AMP article that was quickly scrolled off before the documentLoaded was received as such
   // views will be hidden as soon as they are swiped away.
-  if (self.visible) {
-    [_messageHandlerController sendVisible:YES];
-  } else if (self.viewer.isPrefetched) {
-    [_messageHandlerController sendPrefetched];
-  }
+  [_lifecycle resendVisibilityState];
 
   NSDictionary *data = AMPK_VERIFY_CLASS(message.data, NSDictionary);
   NSDictionary *linkRels = AMPK_VERIFY_CLASS(data[kLinkRelsDocumentLoaded], NSDictionary);
   NSString *canonicalURL = AMPK_VERIFY_CLASS(linkRels[kCanonicalDocumentLoaded], NSString);
   if (canonicalURL) {
     self.article.canonicalURL = [NSURL URLWithString:canonicalURL];
+    self.sharingURL = self.article.canonicalURL;
+  }
+  // The shell's own title isn't the article's.
+  NSString *title = AMPK_VERIFY_CLASS(data[kTitleDocumentLoaded], NSString);
+  if (_shadowDocumentURL && title) {
+    self.title = title;
+  }
+  [self storeMetadata];
+  [self notifyDelegateDidChangeHeaderInfoIfNeeded];
+}
+
+- (void)shadowDocumentFailedWithMessage:(AMPKWebViewerJsMessage *)message {
+  NSDictionary *data = AMPK_VERIFY_CLASS(message.data, NSDictionary);
+  NSNumber *documentID = AMPK_VERIFY_CLASS(data[@"id"], NSNumber);
+  if (documentID && documentID.integerValue == _shadowDocumentID) {
+    [self fallBackToNavigation];
   }
 }
 
@@ -286,17 +452,25 @@ NSString * const AMPKHeaderNameField = @"X-AMP-VIEWER";
                        context:(nullable void *)context {
   if (object == _webView && context == kAMPKWebViewerKVOContext) {
     if ([keyPath isEqualToString:@"loading"]) {
-      if (_webView.loading) {
+      if (!_webView.loading && _shellState == AMPKShellStateLoading) {
+        [self shellDidLoad];
+      } else if (!_webView.loading && _shellState == AMPKShellStateNone) {
+        [self revealIfNeeded];
+      } else if (_webView.loading && !_revealed) {
         [_activityIndicator startAnimating];
-      } else {
-        [_activityIndicator stopAnimating];
-        [self loadingFinishedAnimation];
       }
       return;
     }
 
     if ([keyPath isEqualToString:@"title"]) {
+      // A page that hasn't got its title yet shouldn't blank the one from the metadata cache.
+      if (_shellState != AMPKShellStateNone || !_webView.title.length) {
+        return;
+      }
       self.title = _webView.title;
+      if (_ampJsReady) {
+        [self storeMetadata];
+      }
       [self notifyDelegateDidChangeHeaderInfoIfNeeded];
       return;
     }
@@ -312,6 +486,18 @@ NSString * const AMPKHeaderNameField = @"X-AMP-VIEWER";
 
 #pragma mark - Spinner
 
+- (void)revealIfNeeded {
+  if (_revealed) {
+    return;
+  }
+  _revealed = YES;
+  [_activityIndicator stopAnimating];
+  [self loadingFinishedAnimation];
+  if (_revealHandler) {
+    _revealHandler(self);
+  }
+}
+
 - (void)loadingFinishedAnimation {
   if (_hasInitialContentOffset) {
     self.webScrollView.contentOffset = _initialContentOffset;
@@ -329,24 +515,296 @@ NSString * const AMPKHeaderNameField = @"X-AMP-VIEWER";
   };
 
   _webView.hidden = NO;
-  _webView.alpha = 0.0;
 
+  // A page revealed while it is off screen, e.g. prefetched next to the current one, is shown
+  // straight away when swiped to rather than fading in.
+  if (!_lifecycle.visible) {
+    _webView.alpha = 1.0;
+    animationCompletion(YES);
+    return;
+  }
+
+  _webView.alpha = 0.0;
   [UIView animateWithDuration:0.25 animations:animatingBlock completion:animationCompletion];
 }
 
+#pragma mark - Shadow Documents
+
+- (void)attachShadowDocumentWithRequest:(NSURLRequest *)request proxiedURL:(NSURL *)proxiedURL {
+  _shadowDocumentRequest = [request copy];
+  _shadowDocumentURL = proxiedURL;
+  _ampJsReady = NO;
+  NSURL *shellURL = [AMPKShadowDocumentLoader shellURLForDocumentURL:proxiedURL];
+  if (![shellURL isEqual:_shellURL]) {
+    // Another publisher's shell.
+    _shellState = AMPKShellStateNone;
+  }
+  _messageHandlerController.attachesShadowDocuments = YES;
+  _messageHandlerController.source = shellURL;
+
+  switch (_shellState) {
+    case AMPKShellStateNone:
+      _shellState = AMPKShellStateLoading;
+      _shellURL = shellURL;
+      [_webView loadHTMLString:[self shellHTML] baseURL:shellURL];
+      break;
+    case AMPKShellStateLoading:
+      // Started by shellDidLoad.
+      break;
+    case AMPKShellStateReady:
+      [self startShadowDocument];
+      break;
+  }
+}
+
+// Loads the shadow runtime from the runtime cache when it is registered with the web view, see
+// viewDidLoad.
+- (NSString *)shellHTML {
+  NSURL *runtimeURL = [AMPKShadowDocumentLoader shadowRuntimeURL];
+#if __IPHONE_OS_VERSION_MAX_ALLOWED >= 110000
+  if (@available(iOS 11.0, *)) {
+    if ([_webView.configuration urlSchemeHandlerForURLScheme:AMPKRuntimeCacheURLScheme]) {
+      runtimeURL = [AMPKRuntimeCache runtimeCacheURLForScriptURL:runtimeURL];
+    }
+  }
+#endif
+  return [AMPKShadowDocumentLoader shellHTMLWithRuntimeURL:runtimeURL];
+}
+
+- (void)shellDidLoad {
+  if (![_webView.URL.host isEqualToString:_shellURL.host]) {
+    // The end of whatever the web view was loading before the shell.
+    return;
+  }
+  _shellState = AMPKShellStateReady;
+  if (_shadowDocumentRequest && !_shadowDocumentStarted) {
+    [self startShadowDocument];
+  }
+}
+
+- (void)startShadowDocument {
+  _shadowDocumentStarted = YES;
+  NSInteger documentID = _shadowDocumentID;
+  NSURLRequest *request = _shadowDocumentRequest;
+
+  // The viewer's init params, which a navigation would pass in the hash fragment.
+  NSMutableDictionary<NSString *, NSString *> *params = [[NSMutableDictionary alloc] init];
+  for (NSString *pair in [request.URL.fragment componentsSeparatedByString:@"&"]) {
+    NSRange separator = [pair rangeOfString:@"="];
+    if (separator.location != NSNotFound) {
+      NSString *key = [pair substringToIndex:separator.location];
+      NSString *value = [pair substringFromIndex:NSMaxRange(separator)];
+      params[key.stringByRemovingPercentEncoding ?: key] =
+          value.stringByRemovingPercentEncoding ?: value;
+    }
+  }
+  [self callShell:@"attach"
+        arguments:@[ @(documentID), _shadowDocumentURL.absoluteString, params ]
+       completion:^(NSError *_Nullable error) {
+         if (error) {
+           [self fallBackToNavigationForDocumentID:documentID];
+         }
+       }];
+
+  // The document is fetched with the web view's cookies, and the ones it sets are stored there, as
+  // if the web view had loaded it. See loadArticleRequest for why this is always available.
+#if __IPHONE_OS_VERSION_MAX_ALLOWED >= 110000
+  if (@available(iOS 11.0, *)) {
+    WKHTTPCookieStore *cookieStore = _webView.configuration.websiteDataStore.httpCookieStore;
+    __weak AMPKWebViewerViewController *weakSelf = self;
+    [cookieStore getAllCookies:^(NSArray<NSHTTPCookie *> *cookies) {
+      [weakSelf loadShadowDocumentWithID:documentID cookies:cookies cookieStore:cookieStore];
+    }];
+  }
+#endif
+}
+
+#if __IPHONE_OS_VERSION_MAX_ALLOWED >= 110000
+- (void)loadShadowDocumentWithID:(NSInteger)documentID
+                         cookies:(NSArray<NSHTTPCookie *> *)cookies
+                     cookieStore:(WKHTTPCookieStore *)cookieStore {
+  if (documentID != _shadowDocumentID) {
+    return;
+  }
+  NSMutableURLRequest *request = [_shadowDocumentRequest mutableCopy];
+  request.HTTPShouldHandleCookies = NO;
+  NSArray<NSHTTPCookie *> *requestCookies =
+      [AMPKShadowDocumentLoader cookiesForURL:request.URL fromCookies:cookies];
+  [[NSHTTPCookie requestHeaderFieldsWithCookies:requestCookies]
+      enumerateKeysAndObjectsUsingBlock:^(NSString *key, NSString *value, BOOL *stop) {
+        [request setValue:value forHTTPHeaderField:key];
+      }];
+
+  __weak AMPKWebViewerViewController *weakSelf = self;
+  _shadowDocumentLoader = [[AMPKShadowDocumentLoader alloc]
+      initWithRequest:request
+        cookieHandler:^(NSArray<NSHTTPCookie *> *responseCookies) {
+          for (NSHTTPCookie *cookie in responseCookies) {
+            [cookieStore setCookie:cookie completionHandler:nil];
+          }
+        }
+         chunkHandler:^(NSString *html) {
+           [weakSelf callShell:@"write" arguments:@[ @(documentID), html ] completion:nil];
+         }
+           completion:^(NSError *_Nullable error) {
+             [weakSelf shadowDocumentLoadedWithID:documentID error:error];
+           }];
+}
+#endif
+
+- (void)shadowDocumentLoadedWithID:(NSInteger)documentID error:(nullable NSError *)error {
+  if (documentID != _shadowDocumentID) {
+    return;
+  }
+  _shadowDocumentLoader = nil;
+  if (error) {
+    [self fallBackToNavigation];
+    return;
+  }
+  [self callShell:@"close"
+        arguments:@[ @(documentID) ]
+       completion:^(NSError *_Nullable closeError) {
+         // The document has been parsed. Like the end of a navigation, this reveals pages that
+         // never report documentLoaded.
+         if (documentID == _shadowDocumentID) {
+           [self revealIfNeeded];
+         }
+       }];
+}
+
+- (void)fallBackToNavigationForDocumentID:(NSInteger)documentID {
+  if (documentID == _shadowDocumentID) {
+    [self fallBackToNavigation];
+  }
+}
+
+- (void)fallBackToNavigation {
+  NSURLRequest *request = _shadowDocumentRequest;
+  NSURL *proxiedURL = _shadowDocumentURL;
+  if (!request) {
+    return;
+  }
+  [self detachShadowDocument];
+  [self navigateToRequest:request proxiedURL:proxiedURL];
+}
+
+// Drops the current article from the shell, which stays loaded for the next one.
+- (void)detachShadowDocument {
+  if (!_shadowDocumentRequest) {
+    return;
+  }
+  _shadowDocumentID++;
+  _shadowDocumentRequest = nil;
+  _shadowDocumentURL = nil;
+  _shadowDocumentStarted = NO;
+  [_shadowDocumentLoader cancel];
+  _shadowDocumentLoader = nil;
+  if (_shellState == AMPKShellStateReady) {
+    [self callShell:@"detach" arguments:@[] completion:nil];
+  }
+}
+
+// Calls ampkShell.<function>(arguments...), see amp_shell.js.
+- (void)callShell:(NSString *)function
+        arguments:(NSArray *)arguments
+       completion:(nullable void (^)(NSError *_Nullable error))completion {
+  NSData *json = [NSJSONSerialization dataWithJSONObject:arguments options:0 error:nil];
+  NSString *argumentList = [[NSString alloc] initWithData:json encoding:NSUTF8StringEncoding];
+  // JSON allows these two in strings but older JavaScript doesn't.
+  argumentList = [[argumentList stringByReplacingOccurrencesOfString:@"\u2028"
+                                                          withString:@"\\u2028"]
+      stringByReplacingOccurrencesOfString:@"\u2029"
+                                withString:@"\\u2029"];
+  NSString *script =
+      [NSString stringWithFormat:@"ampkShell.%@.apply(null, %@);", function, argumentList];
+  [_webView evaluateJavaScript:script
+             completionHandler:^(id _Nullable result, NSError *_Nullable error) {
+               if (completion) {
+                 completion(error);
+               }
+             }];
+}
+
+#pragma mark - Web Content Process Termination
+
+// The system terminated the web view's content process, e.g. under memory pressure, leaving it
+// blank. The shell and any article attached to it went with it.
+- (void)webContentProcessDidTerminate {
+  if (_revealed) {
+    _initialContentOffset = self.webScrollView.contentOffset;
+    _hasInitialContentOffset = YES;
+  }
+  _revealed = NO;
+  _ampJsReady = NO;
+  _webView.hidden = YES;
+  _shellState = AMPKShellStateNone;
+  [self detachShadowDocument];
+  [_messageHandlerController cancelPendingMessages];
+
+  [_lifecycle webContentProcessDidTerminate];
+  if (_terminationHandler) {
+    _terminationHandler(self);
+  }
+}
+
+#pragma mark - AMPKWebViewerLifecycleDelegate
+
+- (BOOL)webViewerLifecycleIsPrefetched:(AMPKWebViewerLifecycle *)lifecycle {
+  return self.viewer.isPrefetched;
+}
+
+- (void)webViewerLifecycle:(AMPKWebViewerLifecycle *)lifecycle
+    didEnterVisibilityState:(AMPKVisibilityState)visibilityState {
+  switch (visibilityState) {
+    case AMPKVisibilityStatePrefetched:
+      [_messageHandlerController sendPrefetched];
+      break;
+    case AMPKVisibilityStateVisible:
+      [_messageHandlerController sendVisible:YES];
+      break;
+    case AMPKVisibilityStateHidden:
+      [_messageHandlerController sendVisible:NO];
+      break;
+    case AMPKVisibilityStatePaused:
+      [_messageHandlerController sendPaused];
+      if (self.isViewLoaded) {
+        self.view.hidden = YES;
+      }
+      // AMPKViewer adds the neighbours of the current article to its view without making them
+      // child view controllers. It doesn't add paused ones back; the page view controller adds the
+      // view when it is swiped to, which resumes it.
+      if (!self.parentViewController && self.isViewLoaded) {
+        [self.view removeFromSuperview];
+      }
+      break;
+  }
+}
+
+- (void)webViewerLifecycleNeedsReload:(AMPKWebViewerLifecycle *)lifecycle {
+  if (_articleRequest) {
+    [self loadArticleRequest];
+  }
+}
+
+- (void)webViewerLifecycleDidChange:(AMPKWebViewerLifecycle *)lifecycle {
+  [self updateContentBlocking];
+}
+
 #pragma mark - Web Navigation support
 
+// The shell has no history of its own: going back or forward would leave it.
 - (BOOL)checkCanGoForward {
-  return self.article.publisherURL != nil && [_webView canGoForward];
+  return self.article.publisherURL != nil && _shellState == AMPKShellStateNone &&
+      [_webView canGoForward];
 }
 
 - (BOOL)goForwardIfPossible {
-  return self.article.publisherURL != nil && [_webView goForward] != nil;
+  return [self checkCanGoForward] && [_webView goForward] != nil;
 }
 
 - (BOOL)checkCanGoBack {
   NSURL *publisherURL = self.article.publisherURL;
-  return publisherURL && _canGoBackward &&
+  return publisherURL && _canGoBackward && _shellState == AMPKShellStateNone &&
       ![_webView.backForwardList.currentItem.initialURL isEqual:publisherURL] &&
       _webView.canGoBack;
 }
@@ -359,12 +817,116 @@ NSString * const AMPKHeaderNameField = @"X-AMP-VIEWER";
 
 #pragma mark - Private
 
+- (void)loadArticleRequest {
+  BOOL attachesShadowDocument = NO;
+#if __IPHONE_OS_VERSION_MAX_ALLOWED >= 110000
+  // Shadow DOM, which shadow documents are attached with, came with the WebKit of iOS 10, but the
+  // web view's cookies can only be read, to fetch the document with, from iOS 11.
+  if (@available(iOS 11.0, *)) {
+    attachesShadowDocument = _usesShadowDocuments;
+  }
+#endif
+  // The shell only runs under a cache subdomain, see amp_shell.js, and the document is fetched
+  // from the same one as the cache would redirect a navigation there.
+  NSURL *documentURL = attachesShadowDocument ? [_articleProxiedURL ampk_CacheSubdomainURL] : nil;
+  if (documentURL) {
+    NSMutableURLRequest *request = [_articleRequest mutableCopy];
+    if ([request.URL.host isEqualToString:_articleProxiedURL.host]) {
+      NSURLComponents *components = [NSURLComponents componentsWithURL:request.URL
+                                               resolvingAgainstBaseURL:NO];
+      components.host = documentURL.host;
+      request.URL = components.URL;
+    }
+    [self attachShadowDocumentWithRequest:request proxiedURL:documentURL];
+  } else {
+    [self navigateToRequest:_articleRequest proxiedURL:_articleProxiedURL];
+  }
+}
+
+- (void)navigateToRequest:(NSURLRequest *)request proxiedURL:(NSURL *)proxiedURL {
+  _shellState = AMPKShellStateNone;
+  _messageHandlerController.attachesShadowDocuments = NO;
+  _messageHandlerController.source = proxiedURL;
+  [_webView loadRequest:request];
+}
+
+- (void)updateContentBlocking {
+  if (!_webView) {
+    // Applied by loadAmpArticle:withHeaders: once the web view exists.
+    return;
+  }
+  BOOL shouldBlock = _contentBlockingPolicy && !_lifecycle.visible;
+  if (shouldBlock == _contentBlocked) {
+    return;
+  }
+  _contentBlocked = shouldBlock;
+  WKUserContentController *userContentController = _webView.configuration.userContentController;
+  if (shouldBlock) {
+    [_contentBlockingPolicy applyToUserContentController:userContentController];
+  } else {
+    [_contentBlockingPolicy removeFromUserContentController:userContentController];
+  }
+}
+
+// Starts the header of the new article, or of none, from what the metadata cache remembers.
+- (void)resetHeaderInfo {
+  [NSObject cancelPreviousPerformRequestsWithTarget:self
+                                           selector:@selector(notifyDelegateDidChangeHeaderInfo)
+                                             object:nil];
+  _notifiedTitle = nil;
+  _notifiedSharingURL = nil;
+
+  NSURL *publisherURL = self.article.publisherURL;
+  AMPKArticleMetadata *metadata =
+      publisherURL ? [_metadataCache metadataForPublisherURL:publisherURL] : nil;
+  if (metadata.canonicalURL && !self.article.canonicalURL) {
+    self.article.canonicalURL = metadata.canonicalURL;
+  }
+  self.title = metadata.title;
+  self.sharingURL = metadata.sharingURL ?: self.article.canonicalURL;
+  if (!self.sharingURL && publisherURL) {
+    self.sharingURL = [publisherURL ampk_WebViewerURLForDomain:_domainName];
+  }
+  [self notifyDelegateDidChangeHeaderInfoIfNeeded];
+}
+
+// Remembers the header for the next time the article is opened.
+- (void)storeMetadata {
+  NSURL *publisherURL = self.article.publisherURL;
+  if (!_metadataCache || !publisherURL || !self.title.length) {
+    return;
+  }
+  AMPKArticleMetadata *metadata =
+      [AMPKArticleMetadata metadataWithTitle:self.title
+                                canonicalURL:self.article.canonicalURL
+                                  sharingURL:self.sharingURL];
+  [_metadataCache setMetadata:metadata forPublisherURL:publisherURL];
+}
+
+// The title and URL KVO, and documentLoaded, often change the header in a burst; the delegate hears
+// about it once.
 - (void)notifyDelegateDidChangeHeaderInfoIfNeeded {
+  [NSObject cancelPreviousPerformRequestsWithTarget:self
+                                           selector:@selector(notifyDelegateDidChangeHeaderInfo)
+                                             object:nil];
+  [self performSelector:@selector(notifyDelegateDidChangeHeaderInfo) withObject:nil afterDelay:0];
+}
+
+- (void)notifyDelegateDidChangeHeaderInfo {
   BOOL delegateImplements =
       [self.delegate respondsToSelector:@selector(ampWebViewerDidChangeHeaderInfo:)];
-  if (delegateImplements && self.title && self.webURL) {
-    [_delegate ampWebViewerDidChangeHeaderInfo:self];
+  if (!delegateImplements || !self.title || !self.article) {
+    return;
   }
+  BOOL titleChanged = ![_notifiedTitle isEqualToString:self.title];
+  BOOL sharingURLChanged = _notifiedSharingURL != self.sharingURL &&
+                           ![_notifiedSharingURL isEqual:self.sharingURL];
+  if (!titleChanged && !sharingURLChanged) {
+    return;
+  }
+  _notifiedTitle = [self.title copy];
+  _notifiedSharingURL = self.sharingURL;
+  [_delegate ampWebViewerDidChangeHeaderInfo:self];
 }
 
 - (void)notifyDelegateDidFinishRenderingIfNeeded {
@@ -375,11 +937,6 @@ NSString * const AMPKHeaderNameField = @"X-AMP-VIEWER";
   }
 }
 
-- (nullable NSURL *)proxiedURL {
-  return (self.article.cdnURL ?
-          self.article.cdnURL : [self.article.publisherURL ampk_ProxiedURL]);
-}
-
 - (NSString *)description {
   return [NSString stringWithFormat:@"<%@: %p, index: %@, url: %@.>",
           NSStringFromClass([self class]),
@@ -0,0 +1,106 @@
+/**
+ * Copyright 2020 The AMP HTML Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS-IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#import "AMPKArticleMetadataCache.h"
+
+#import <UIKit/UIKit.h>
+#import <XCTest/XCTest.h>
+
+@interface AMPKArticleMetadataCacheTest : XCTestCase
+@property(nonatomic) NSURL *fileURL;
+@property(nonatomic) AMPKArticleMetadataCache *subject;
+@end
+
+@implementation AMPKArticleMetadataCacheTest
+
+- (void)setUp {
+  [super setUp];
+  NSString *path = [NSTemporaryDirectory()
+      stringByAppendingPathComponent:[[NSUUID UUID].UUIDString stringByAppendingString:@".plist"]];
+  self.fileURL = [NSURL fileURLWithPath:path];
+  self.subject = [[AMPKArticleMetadataCache alloc] initWithFileURL:self.fileURL];
+}
+
+- (void)tearDown {
+  [[NSFileManager defaultManager] removeItemAtURL:self.fileURL error:nil];
+  [super tearDown];
+}
+
+- (NSURL *)publisherURL:(NSInteger)index {
+  return [NSURL URLWithString:[NSString stringWithFormat:@"https://www.example.com/%ld",
+                                                         (long)index]];
+}
+
+- (AMPKArticleMetadata *)metadataTitled:(NSString *)title {
+  return [AMPKArticleMetadata
+      metadataWithTitle:title
+           canonicalURL:[NSURL URLWithString:@"https://www.example.com/story"]
+             sharingURL:[NSURL URLWithString:@"https://www.example.com/story?share"]];
+}
+
+/** Stored metadata is served by publisher URL. */
+- (void)testStoreAndLookUp {
+  XCTAssertNil([self.subject metadataForPublisherURL:[self publisherURL:0]]);
+
+  [self.subject setMetadata:[self metadataTitled:@"Story"] forPublisherURL:[self publisherURL:0]];
+
+  XCTAssertEqualObjects([self.subject metadataForPublisherURL:[self publisherURL:0]],
+                        [self metadataTitled:@"Story"]);
+  XCTAssertNil([self.subject metadataForPublisherURL:[self publisherURL:1]]);
+}
+
+/** Flushed metadata is read back by the next cache using the same file. */
+- (void)testPersistsAcrossInstances {
+  [self.subject setMetadata:[self metadataTitled:@"Story"] forPublisherURL:[self publisherURL:0]];
+  [self.subject flush];
+
+  AMPKArticleMetadataCache *cache = [[AMPKArticleMetadataCache alloc] initWithFileURL:self.fileURL];
+
+  AMPKArticleMetadata *metadata = [cache metadataForPublisherURL:[self publisherURL:0]];
+  XCTAssertEqualObjects(metadata.title, @"Story");
+  XCTAssertEqualObjects(metadata.canonicalURL.absoluteString, @"https://www.example.com/story");
+  XCTAssertEqualObjects(metadata.sharingURL.absoluteString,
+                        @"https://www.example.com/story?share");
+}
+
+/** Changes are written right away when the app moves to the background. */
+- (void)testFlushesInTheBackground {
+  [self.subject setMetadata:[self metadataTitled:@"Story"] forPublisherURL:[self publisherURL:0]];
+  [[NSNotificationCenter defaultCenter]
+      postNotificationName:UIApplicationDidEnterBackgroundNotification
+                    object:nil];
+
+  AMPKArticleMetadataCache *cache = [[AMPKArticleMetadataCache alloc] initWithFileURL:self.fileURL];
+  XCTAssertEqualObjects([cache metadataForPublisherURL:[self publisherURL:0]].title, @"Story");
+}
+
+/** Only the maxCount most recently stored articles are kept. */
+- (void)testEvictsLeastRecentlyStored {
+  self.subject.maxCount = 2;
+  [self.subject setMetadata:[self metadataTitled:@"0"] forPublisherURL:[self publisherURL:0]];
+  [self.subject setMetadata:[self metadataTitled:@"1"] forPublisherURL:[self publisherURL:1]];
+  [self.subject setMetadata:[self metadataTitled:@"0 again"]
+            forPublisherURL:[self publisherURL:0]];
+
+  [self.subject setMetadata:[self metadataTitled:@"2"] forPublisherURL:[self publisherURL:2]];
+
+  XCTAssertNotNil([self.subject metadataForPublisherURL:[self publisherURL:0]]);
+  XCTAssertNil([self.subject metadataForPublisherURL:[self publisherURL:1]]);
+  XCTAssertNotNil([self.subject metadataForPublisherURL:[self publisherURL:2]]);
+}
+
+@end
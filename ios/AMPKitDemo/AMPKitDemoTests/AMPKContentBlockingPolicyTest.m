@@ -0,0 +1,110 @@
+/**
+ * Copyright 2020 The AMP HTML Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS-IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#import "AMPKContentBlockingPolicy.h"
+
+#import <XCTest/XCTest.h>
+
+#import "AMPKArticle.h"
+#import "AMPKContentBlockingPolicy_private.h"
+#import "AMPKViewerDataSource.h"
+#import "AMPKWebViewerViewController.h"
+#import "AMPKWebViewerViewController_private.h"
+
+@interface AMPKContentBlockingPolicyTest : XCTestCase
+@property(nonatomic) AMPKContentBlockingPolicy *subject;
+@end
+
+@implementation AMPKContentBlockingPolicyTest
+
+- (void)setUp {
+  [super setUp];
+  NSArray<NSString *> *domains = @[ @"Ads.example", @"tracker.net" ];
+  self.subject = [[AMPKContentBlockingPolicy alloc] initWithBlockedDomains:domains];
+}
+
+- (void)testBlocksDomainsAndSubdomains {
+  XCTAssertTrue([self.subject blocksURL:[NSURL URLWithString:@"https://ads.example/ad.js"]]);
+  XCTAssertTrue([self.subject blocksURL:[NSURL URLWithString:@"https://a.b.TRACKER.net/pixel"]]);
+  XCTAssertFalse([self.subject blocksURL:[NSURL URLWithString:@"https://notads.example/"]]);
+  XCTAssertFalse([self.subject blocksURL:[NSURL URLWithString:@"https://tracker.net.example/"]]);
+  XCTAssertFalse([self.subject blocksURL:nil]);
+}
+
+- (void)testEncodedContentRuleList {
+  NSData *data = [self.subject.encodedContentRuleList dataUsingEncoding:NSUTF8StringEncoding];
+  NSArray<NSDictionary *> *rules = [NSJSONSerialization JSONObjectWithData:data
+                                                                   options:0
+                                                                     error:nil];
+  XCTAssertEqual(rules.count, 2);
+  XCTAssertEqualObjects(rules[0][@"trigger"][@"url-filter"],
+                        @"^https?://([^/]*\\.)?ads\\.example[:/]");
+  XCTAssertEqualObjects(rules[0][@"trigger"][@"load-type"], @[ @"third-party" ]);
+  XCTAssertEqualObjects(rules[1][@"action"][@"type"], @"block");
+}
+
+- (void)testKeepsTheRuleListsOfLivePolicies {
+  NSString *identifier = self.subject.ruleListIdentifier;
+  XCTAssertTrue([identifier hasPrefix:@"AMPKContentBlocking-"]);
+  XCTAssertTrue([AMPKContentBlockingPolicy isRuleListIdentifierLive:identifier]);
+
+  NSString *otherIdentifier;
+  @autoreleasepool {
+    AMPKContentBlockingPolicy *other =
+        [[AMPKContentBlockingPolicy alloc] initWithBlockedDomains:@[ @"other.example" ]];
+    otherIdentifier = other.ruleListIdentifier;
+    XCTAssertNotEqualObjects(otherIdentifier, identifier);
+    XCTAssertTrue([AMPKContentBlockingPolicy isRuleListIdentifierLive:otherIdentifier]);
+    XCTAssertTrue([AMPKContentBlockingPolicy isRuleListIdentifierLive:identifier]);
+  }
+  XCTAssertFalse([AMPKContentBlockingPolicy isRuleListIdentifierLive:otherIdentifier]);
+  XCTAssertTrue([AMPKContentBlockingPolicy isRuleListIdentifierLive:identifier]);
+}
+
+- (void)testBlocksFramesOnlyWhileHidden {
+  AMPKWebViewerViewController *controller = [[AMPKWebViewerViewController alloc]
+      initWithDomainName:[NSURL URLWithString:@"https://www.google.com"]];
+  controller.contentBlockingPolicy = self.subject;
+  [controller loadAmpArticle:[AMPKArticle articleWithURL:[NSURL URLWithString:@"https://a.com/"]]
+                 withHeaders:nil];
+  NSURLRequest *ad = [NSURLRequest requestWithURL:[NSURL URLWithString:@"https://ads.example/"]];
+  NSURLRequest *video =
+      [NSURLRequest requestWithURL:[NSURL URLWithString:@"https://video.example/"]];
+
+  XCTAssertTrue([controller shouldBlockFrameRequest:ad]);
+  XCTAssertFalse([controller shouldBlockFrameRequest:video]);
+  XCTAssertEqual(controller.blockedRequestCount, 1);
+
+  controller.visible = YES;
+  XCTAssertFalse([controller shouldBlockFrameRequest:ad]);
+  XCTAssertEqual(controller.blockedRequestCount, 1);
+
+  [controller prepareForReuse];
+  XCTAssertEqual(controller.blockedRequestCount, 0);
+}
+
+- (void)testDataSourceAssignsPolicy {
+  AMPKViewerDataSource *dataSource = [[AMPKViewerDataSource alloc]
+      initWithDomainName:[NSURL URLWithString:@"https://www.google.com"]];
+  dataSource.contentBlockingPolicy = self.subject;
+  AMPKArticle *article = [AMPKArticle articleWithURL:[NSURL URLWithString:@"https://a.com/"]];
+  [dataSource setAmpArticles:@[ article ] usingHeaders:nil];
+
+  XCTAssertEqual(dataSource[0].contentBlockingPolicy, self.subject);
+  XCTAssertEqual([dataSource copy].contentBlockingPolicy, self.subject);
+}
+
+@end
@@ -0,0 +1,107 @@
+/**
+ * Copyright 2020 The AMP HTML Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS-IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#import "AMPKFeedSnapshot.h"
+
+#import <XCTest/XCTest.h>
+
+#import "AMPKArticle.h"
+#import "AMPKFeedIngestor.h"
+#import "AMPKViewerDataSource.h"
+#import "AMPKWebViewerViewController.h"
+#import "NSURL+AMPK.h"
+
+@interface AMPKFeedSnapshotTest : XCTestCase
+@property(nonatomic) NSURL *domain;
+@end
+
+@implementation AMPKFeedSnapshotTest
+
+- (void)setUp {
+  [super setUp];
+  self.domain = [NSURL URLWithString:@"https://www.google.com"];
+}
+
+- (NSArray<AMPKArticle *> *)articlesWithPrefix:(NSString *)prefix count:(NSUInteger)count {
+  NSMutableArray<AMPKArticle *> *articles = [NSMutableArray array];
+  for (NSUInteger i = 0; i < count; i++) {
+    NSString *url = [NSString stringWithFormat:@"%@%lu", prefix, (unsigned long)i];
+    [articles addObject:[AMPKArticle articleWithURL:[NSURL URLWithString:url]]];
+  }
+  return articles;
+}
+
+- (void)testSnapshotSkipsInvalidArticlesAndPrecomputesURLs {
+  NSURL *cdnURL = [NSURL URLWithString:@"https://www-b-com.cdn.ampproject.org/c/s/www.b.com/"];
+  NSArray *articles = @[
+    [AMPKArticle articleWithURL:[NSURL URLWithString:@"https://www.a.com/story"]],
+    [AMPKArticle articleWithURL:[NSURL URLWithString:@"about:blank"]],
+    [AMPKArticle articleWithURL:[NSURL URLWithString:@"https://www.b.com/"] cdnURL:cdnURL],
+  ];
+  AMPKFeedSnapshot *snapshot = [[AMPKFeedSnapshot alloc] initWithArticles:articles
+                                                                  headers:@{ @"a" : @"b" }
+                                                               domainName:self.domain];
+
+  XCTAssertEqual(snapshot.articles.count, 2);
+  XCTAssertEqualObjects(snapshot.articles[1], articles[2]);
+  XCTAssertNotEqual(snapshot.articles[1], articles[2]);
+  XCTAssertEqualObjects(snapshot.headers, @{ @"a" : @"b" });
+
+  NSURL *publisherURL = [articles[0] publisherURL];
+  XCTAssertEqualObjects([snapshot proxiedURLAtIndex:0], [publisherURL ampk_ProxiedURL]);
+  XCTAssertEqualObjects([snapshot proxiedURLAtIndex:1], cdnURL);
+  XCTAssertEqualObjects([snapshot loadURLAtIndex:1],
+                        [cdnURL URLBySettingProxyHashFragmentsForDomain:self.domain]);
+  XCTAssertEqualObjects([snapshot viewerURLAtIndex:0].absoluteString,
+                        @"https://www.google.com/amp/s/www.a.com/story");
+}
+
+- (void)testDataSourceAdoptsSnapshot {
+  AMPKViewerDataSource *dataSource =
+      [[AMPKViewerDataSource alloc] initWithDomainName:self.domain];
+  AMPKFeedSnapshot *snapshot =
+      [[AMPKFeedSnapshot alloc] initWithArticles:[self articlesWithPrefix:@"https://a.com/" count:3]
+                                         headers:nil
+                                      domainName:self.domain];
+  [dataSource setFeedSnapshot:snapshot];
+
+  XCTAssertEqual(dataSource.count, 3);
+  XCTAssertEqualObjects(dataSource[1].article, snapshot.articles[1]);
+  XCTAssertEqualObjects(dataSource[1].article.publisherURL.absoluteString, @"https://a.com/1");
+}
+
+- (void)testIngestorDeliversOnlyTheLatestFeed {
+  AMPKFeedIngestor *ingestor = [[AMPKFeedIngestor alloc] init];
+  [ingestor ingestArticles:[self articlesWithPrefix:@"https://a.com/" count:2]
+                   headers:nil
+                domainName:self.domain
+                completion:^(AMPKFeedSnapshot *snapshot) {
+    XCTFail(@"A replaced feed was delivered");
+  }];
+
+  XCTestExpectation *delivered = [self expectationWithDescription:@"delivered"];
+  [ingestor ingestArticles:[self articlesWithPrefix:@"https://b.com/" count:3]
+                   headers:nil
+                domainName:self.domain
+                completion:^(AMPKFeedSnapshot *snapshot) {
+    XCTAssertTrue([NSThread isMainThread]);
+    XCTAssertEqual(snapshot.articles.count, 3);
+    [delivered fulfill];
+  }];
+  [self waitForExpectationsWithTimeout:5 handler:nil];
+}
+
+@end
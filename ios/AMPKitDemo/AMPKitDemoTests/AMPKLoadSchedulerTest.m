@@ -0,0 +1,118 @@
+/**
+ * Copyright 2020 The AMP HTML Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS-IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#import "AMPKLoadScheduler.h"
+
+#import <XCTest/XCTest.h>
+
+@interface AMPKLoadSchedulerTest : XCTestCase
+@property(nonatomic) AMPKLoadScheduler *subject;
+@property(nonatomic) NSTimeInterval now;
+@property(nonatomic) NSMutableArray<NSString *> *started;
+@end
+
+@implementation AMPKLoadSchedulerTest
+
+- (void)setUp {
+  [super setUp];
+  self.now = 100;
+  self.started = [NSMutableArray array];
+  self.subject = [[AMPKLoadScheduler alloc] init];
+  __weak AMPKLoadSchedulerTest *weakSelf = self;
+  self.subject.clock = ^NSTimeInterval {
+    return weakSelf.now;
+  };
+}
+
+- (void)schedule:(NSString *)key priority:(AMPKLoadPriority)priority {
+  [self.subject scheduleLoadWithKey:key
+                           priority:priority
+                              block:^{
+                                [self.started addObject:key];
+                              }];
+}
+
+- (void)testVisibleLoadStartsStraightAway {
+  [self schedule:@"current" priority:AMPKLoadPriorityVisible];
+  [self schedule:@"next" priority:AMPKLoadPriorityVisible];
+
+  XCTAssertEqualObjects(self.started, (@[ @"current", @"next" ]));
+  XCTAssertFalse([self.subject hasPendingLoadWithKey:@"current"]);
+}
+
+- (void)testNeighboursWaitForTheCurrentArticle {
+  [self schedule:@"current" priority:AMPKLoadPriorityVisible];
+  [self schedule:@"prefetch" priority:AMPKLoadPriorityPrefetch];
+  [self schedule:@"after" priority:AMPKLoadPriorityNeighbour];
+
+  XCTAssertEqualObjects(self.started, @[ @"current" ]);
+  XCTAssertTrue([self.subject hasPendingLoadWithKey:@"after"]);
+  XCTAssertEqual(self.subject.nextDueTime, 101);
+
+  [self.subject loadDidFinishWithKey:@"current"];
+  XCTAssertEqualObjects(self.started, (@[ @"current", @"after" ]));
+
+  [self.subject loadDidFinishWithKey:@"after"];
+  XCTAssertEqualObjects(self.started, (@[ @"current", @"after", @"prefetch" ]));
+  XCTAssertEqual(self.subject.nextDueTime, 0);
+}
+
+- (void)testStageTimeout {
+  self.subject.stageTimeout = 2;
+  [self schedule:@"current" priority:AMPKLoadPriorityVisible];
+  [self schedule:@"after" priority:AMPKLoadPriorityNeighbour];
+
+  self.now = 101;
+  [self.subject startDueLoads];
+  XCTAssertEqualObjects(self.started, @[ @"current" ]);
+
+  self.now = 102;
+  [self.subject startDueLoads];
+  XCTAssertEqualObjects(self.started, (@[ @"current", @"after" ]));
+}
+
+- (void)testZeroStageTimeoutStartsEverything {
+  self.subject.stageTimeout = 0;
+  [self schedule:@"current" priority:AMPKLoadPriorityVisible];
+  [self schedule:@"after" priority:AMPKLoadPriorityNeighbour];
+  [self schedule:@"prefetch" priority:AMPKLoadPriorityPrefetch];
+
+  XCTAssertEqualObjects(self.started, (@[ @"current", @"after", @"prefetch" ]));
+}
+
+- (void)testCancelledLoadNeverStarts {
+  [self schedule:@"current" priority:AMPKLoadPriorityVisible];
+  [self schedule:@"after" priority:AMPKLoadPriorityNeighbour];
+
+  [self.subject cancelLoadWithKey:@"after"];
+  [self.subject loadDidFinishWithKey:@"current"];
+
+  XCTAssertEqualObjects(self.started, @[ @"current" ]);
+  XCTAssertFalse([self.subject hasPendingLoadWithKey:@"after"]);
+}
+
+- (void)testRaisePriority {
+  [self schedule:@"current" priority:AMPKLoadPriorityVisible];
+  [self schedule:@"after" priority:AMPKLoadPriorityNeighbour];
+
+  // The reader started swiping to the neighbour.
+  [self.subject raisePriorityOfLoadWithKey:@"after" toPriority:AMPKLoadPriorityVisible];
+
+  XCTAssertEqualObjects(self.started, (@[ @"current", @"after" ]));
+}
+
+@end
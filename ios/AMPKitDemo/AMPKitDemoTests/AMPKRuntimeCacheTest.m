@@ -0,0 +1,127 @@
+/**
+ * Copyright 2020 The AMP HTML Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS-IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#import "AMPKRuntimeCache.h"
+
+#import <XCTest/XCTest.h>
+
+#import "AMPKRuntimeCache_private.h"
+#import "AMPKRuntimeUtilities.h"
+
+@interface AMPKRuntimeCacheTest : XCTestCase
+@property(nonatomic) NSURL *directoryURL;
+@property(nonatomic) NSURL *runtimeURL;
+@property(nonatomic) NSURL *extensionURL;
+@property(nonatomic) AMPKRuntimeCache *subject;
+@end
+
+@implementation AMPKRuntimeCacheTest
+
+- (void)setUp {
+  [super setUp];
+  NSString *directory =
+      [NSTemporaryDirectory() stringByAppendingPathComponent:[NSUUID UUID].UUIDString];
+  self.directoryURL = [NSURL fileURLWithPath:directory isDirectory:YES];
+  self.runtimeURL = [NSURL URLWithString:@"https://cdn.ampproject.org/v0.js"];
+  self.extensionURL = [NSURL URLWithString:@"https://cdn.ampproject.org/v0/amp-ad-0.1.js"];
+  self.subject = [self newCache];
+}
+
+- (void)tearDown {
+  [[NSFileManager defaultManager] removeItemAtURL:self.directoryURL error:nil];
+  [super tearDown];
+}
+
+- (AMPKRuntimeCache *)newCache {
+  return [[AMPKRuntimeCache alloc] initWithDirectoryURL:self.directoryURL
+                                             scriptURLs:@[ self.runtimeURL, self.extensionURL ]];
+}
+
+- (NSDictionary<NSURL *, NSData *> *)scriptsNamed:(NSString *)name {
+  return @{
+    self.runtimeURL : [[name stringByAppendingString:@"-runtime"]
+                          dataUsingEncoding:NSUTF8StringEncoding],
+    self.extensionURL : [[name stringByAppendingString:@"-ad"]
+                            dataUsingEncoding:NSUTF8StringEncoding],
+  };
+}
+
+- (void)testServesInstalledVersion {
+  XCTAssertNil(self.subject.version);
+  XCTAssertNil([self.subject scriptDataForURL:self.runtimeURL]);
+
+  NSError *error = nil;
+  XCTAssertTrue([self.subject installScripts:[self scriptsNamed:@"a"]
+                                     version:@"\"a\""
+                                       error:&error]);
+  XCTAssertNil(error);
+  XCTAssertEqualObjects(self.subject.version, @"\"a\"");
+
+  NSData *data = [self.subject scriptDataForURL:self.extensionURL];
+  XCTAssertEqualObjects(data, [self scriptsNamed:@"a"][self.extensionURL]);
+  XCTAssertNil([self.subject scriptDataForURL:[NSURL URLWithString:@"https://a.com/x.js"]]);
+  XCTAssertEqual(self.subject.hitCount, 1);
+  XCTAssertEqual(self.subject.missCount, 2);
+  XCTAssertEqual(self.subject.bytesSaved, data.length);
+}
+
+- (void)testNewVersionReplacesOldOneOnDisk {
+  [self.subject installScripts:[self scriptsNamed:@"a"] version:@"a" error:nil];
+  [self.subject installScripts:[self scriptsNamed:@"b"] version:@"b" error:nil];
+
+  AMPKRuntimeCache *reopened = [self newCache];
+  XCTAssertEqualObjects(reopened.version, @"b");
+  XCTAssertEqualObjects([reopened scriptDataForURL:self.runtimeURL],
+                        [self scriptsNamed:@"b"][self.runtimeURL]);
+  NSFileManager *fileManager = [NSFileManager defaultManager];
+  NSArray *contents = [fileManager contentsOfDirectoryAtPath:self.directoryURL.path error:nil];
+  // The version file and one version directory, named after a digest of the version.
+  XCTAssertEqual(contents.count, 2);
+  NSData *version = [@"b" dataUsingEncoding:NSUTF8StringEncoding];
+  NSString *directory = [@"v" stringByAppendingString:AMPKSHA256HexString(version)];
+  XCTAssertTrue([contents containsObject:directory]);
+}
+
+- (void)testStoresScriptsDownloadedOnAMiss {
+  NSHTTPURLResponse *response = [[NSHTTPURLResponse alloc] initWithURL:self.runtimeURL
+                                                            statusCode:200
+                                                           HTTPVersion:@"HTTP/1.1"
+                                                          headerFields:@{ @"ETag" : @"\"a\"" }];
+  NSDictionary<NSURL *, NSData *> *scripts = [self scriptsNamed:@"a"];
+  [self.subject storeScriptData:scripts[self.runtimeURL] forURL:self.runtimeURL response:response];
+  XCTAssertEqualObjects(self.subject.version, @"\"a\"");
+  XCTAssertEqualObjects([self.subject scriptDataForURL:self.runtimeURL], scripts[self.runtimeURL]);
+
+  // Other scripts join the runtime's version.
+  [self.subject storeScriptData:scripts[self.extensionURL]
+                         forURL:self.extensionURL
+                       response:response];
+  XCTAssertEqualObjects([self.subject scriptDataForURL:self.extensionURL],
+                        scripts[self.extensionURL]);
+}
+
+- (void)testDefaultCacheKeepsTheShadowRuntime {
+  NSArray<NSURL *> *scriptURLs = [AMPKRuntimeCache defaultCache].scriptURLs;
+  XCTAssertEqualObjects(scriptURLs,
+                        @[ [NSURL URLWithString:@"https://cdn.ampproject.org/shadow-v0.js"] ]);
+}
+
+- (void)testRuntimeCacheURL {
+  NSURL *url = [AMPKRuntimeCache runtimeCacheURLForScriptURL:self.extensionURL];
+  XCTAssertEqualObjects(url.absoluteString, @"ampk-runtime://cdn.ampproject.org/v0/amp-ad-0.1.js");
+}
+
+@end
@@ -0,0 +1,34 @@
+/**
+ * Copyright 2020 The AMP HTML Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS-IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#import "AMPKRuntimeUtilities.h"
+
+#import <XCTest/XCTest.h>
+
+@interface AMPKRuntimeUtilitiesTest : XCTestCase
+@end
+
+@implementation AMPKRuntimeUtilitiesTest
+
+- (void)testSHA256HexString {
+  NSData *data = [@"abc" dataUsingEncoding:NSUTF8StringEncoding];
+  XCTAssertEqualObjects(AMPKSHA256HexString(data),
+                        @"ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+  XCTAssertEqualObjects(AMPKSHA256HexString([NSData data]),
+                        @"e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855");
+}
+
+@end
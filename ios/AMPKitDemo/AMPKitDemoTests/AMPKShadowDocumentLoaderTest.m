@@ -0,0 +1,161 @@
+/**
+ * Copyright 2020 The AMP HTML Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS-IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#import "AMPKShadowDocumentLoader.h"
+
+#import <XCTest/XCTest.h>
+
+#import "AMPKArticle.h"
+#import "AMPKRuntimeCache.h"
+#import "AMPKWebViewerJsMessage.h"
+#import "AMPKWebViewerMessageHandlerController.h"
+#import "AMPKWebViewerViewController.h"
+#import "AMPKWebViewerViewController_private.h"
+
+@interface AMPKShadowDocumentLoaderTest : XCTestCase
+@end
+
+@implementation AMPKShadowDocumentLoaderTest
+
+- (void)testCompleteUTF8Characters {
+  // "a", "é" (2 bytes), "€" (3 bytes) and "😀" (4 bytes).
+  const uint8_t bytes[] = {0x61, 0xC3, 0xA9, 0xE2, 0x82, 0xAC, 0xF0, 0x9F, 0x98, 0x80};
+  XCTAssertEqual([self completeLengthOf:bytes length:10], 10);
+  XCTAssertEqual([self completeLengthOf:bytes length:1], 1);
+  XCTAssertEqual([self completeLengthOf:bytes length:2], 1);
+  XCTAssertEqual([self completeLengthOf:bytes length:3], 3);
+  XCTAssertEqual([self completeLengthOf:bytes length:5], 3);
+  XCTAssertEqual([self completeLengthOf:bytes length:6], 6);
+  XCTAssertEqual([self completeLengthOf:bytes length:9], 6);
+  XCTAssertEqual([self completeLengthOf:bytes length:0], 0);
+}
+
+- (void)testShellLoadsTheShadowRuntime {
+  NSString *html = [AMPKShadowDocumentLoader shellHTML];
+  XCTAssertTrue([html containsString:@"src=\"https://cdn.ampproject.org/shadow-v0.js\""]);
+  XCTAssertFalse([html containsString:@"data-fallback-src"]);
+}
+
+- (void)testShellLoadsTheShadowRuntimeFromTheCache {
+  NSURL *runtimeURL =
+      [AMPKRuntimeCache runtimeCacheURLForScriptURL:[AMPKShadowDocumentLoader shadowRuntimeURL]];
+  XCTAssertTrue([[AMPKRuntimeCache defaultCache].scriptURLs
+      containsObject:[AMPKShadowDocumentLoader shadowRuntimeURL]]);
+
+  NSString *html = [AMPKShadowDocumentLoader shellHTMLWithRuntimeURL:runtimeURL];
+  XCTAssertTrue([html containsString:@"src=\"ampk-runtime://cdn.ampproject.org/shadow-v0.js\""]);
+  XCTAssertTrue(
+      [html containsString:@"data-fallback-src=\"https://cdn.ampproject.org/shadow-v0.js\""]);
+}
+
+- (void)testShellIsLoadedUnderTheDocumentsCacheOrigin {
+  NSURL *documentURL =
+      [NSURL URLWithString:@"https://www-example-com.cdn.ampproject.org/c/s/www.example.com/a"];
+  NSURL *shellURL = [AMPKShadowDocumentLoader shellURLForDocumentURL:documentURL];
+  XCTAssertEqualObjects(shellURL.absoluteString, @"https://www-example-com.cdn.ampproject.org/");
+}
+
+- (void)testCookiesForURL {
+  NSArray<NSHTTPCookie *> *cookies = @[
+    [self cookieNamed:@"host" domain:@"www-example-com.cdn.ampproject.org" path:@"/" secure:NO],
+    [self cookieNamed:@"domain" domain:@".cdn.ampproject.org" path:@"/" secure:NO],
+    [self cookieNamed:@"path" domain:@"www-example-com.cdn.ampproject.org" path:@"/c" secure:YES],
+    [self cookieNamed:@"prefix" domain:@"www-example-com.cdn.ampproject.org" path:@"/c/s/w"
+               secure:NO],
+    [self cookieNamed:@"other" domain:@"www-other-com.cdn.ampproject.org" path:@"/" secure:NO],
+  ];
+  NSURL *url =
+      [NSURL URLWithString:@"https://www-example-com.cdn.ampproject.org/c/s/www.example.com"];
+  NSArray<NSHTTPCookie *> *matching =
+      [AMPKShadowDocumentLoader cookiesForURL:url fromCookies:cookies];
+  XCTAssertEqualObjects([matching valueForKey:@"name"], (@[ @"host", @"domain", @"path" ]));
+
+  NSURL *insecureURL = [NSURL URLWithString:@"http://www-example-com.cdn.ampproject.org/c/s"];
+  matching = [AMPKShadowDocumentLoader cookiesForURL:insecureURL fromCookies:cookies];
+  XCTAssertEqualObjects([matching valueForKey:@"name"], (@[ @"host", @"domain" ]));
+}
+
+/** An article the shell reports it couldn't attach is navigated to instead. */
+- (void)testFallsBackToNavigation {
+  AMPKWebViewerViewController *controller = [[AMPKWebViewerViewController alloc]
+      initWithDomainName:[NSURL URLWithString:@"https://www.google.com"]];
+  controller.usesShadowDocuments = YES;
+  AMPKArticle *article =
+      [AMPKArticle articleWithURL:[NSURL URLWithString:@"https://www.example.com/story"]];
+  [controller loadAmpArticle:article withHeaders:nil];
+
+  AMPKWebViewerMessageHandlerController *messageHandlerController =
+      controller.messageHandlerController;
+  XCTAssertTrue(messageHandlerController.attachesShadowDocuments);
+  XCTAssertEqualObjects(messageHandlerController.source.absoluteString,
+                        @"https://www-example-com.cdn.ampproject.org/");
+
+  // A report for an earlier article is ignored.
+  [controller shadowDocumentFailedWithMessage:[self shadowDocumentFailedMessageForID:-1]];
+  XCTAssertTrue(messageHandlerController.attachesShadowDocuments);
+
+  [controller shadowDocumentFailedWithMessage:[self shadowDocumentFailedMessageForID:0]];
+  XCTAssertFalse(messageHandlerController.attachesShadowDocuments);
+  XCTAssertEqualObjects(messageHandlerController.source.host,
+                        @"www-example-com.cdn.ampproject.org");
+}
+
+/** An article whose publisher has no plain cache subdomain is navigated to straight away. */
+- (void)testNavigatesWithoutACacheSubdomain {
+  AMPKWebViewerViewController *controller = [[AMPKWebViewerViewController alloc]
+      initWithDomainName:[NSURL URLWithString:@"https://www.google.com"]];
+  controller.usesShadowDocuments = YES;
+  AMPKArticle *article =
+      [AMPKArticle articleWithURL:[NSURL URLWithString:@"https://xn--bcher-kva.example/story"]];
+  [controller loadAmpArticle:article withHeaders:nil];
+
+  XCTAssertFalse(controller.messageHandlerController.attachesShadowDocuments);
+}
+
+#pragma mark - Private
+
+- (NSUInteger)completeLengthOf:(const uint8_t *)bytes length:(NSUInteger)length {
+  return [AMPKShadowDocumentLoader lengthOfCompleteUTF8CharactersInBytes:bytes length:length];
+}
+
+- (NSHTTPCookie *)cookieNamed:(NSString *)name
+                       domain:(NSString *)domain
+                         path:(NSString *)path
+                       secure:(BOOL)secure {
+  NSMutableDictionary<NSHTTPCookiePropertyKey, id> *properties = [@{
+    NSHTTPCookieName : name,
+    NSHTTPCookieValue : @"1",
+    NSHTTPCookieDomain : domain,
+    NSHTTPCookiePath : path,
+  } mutableCopy];
+  if (secure) {
+    properties[NSHTTPCookieSecure] = @"TRUE";
+  }
+  return [NSHTTPCookie cookieWithProperties:properties];
+}
+
+- (AMPKWebViewerJsMessage *)shadowDocumentFailedMessageForID:(NSInteger)documentID {
+  return [AMPKWebViewerJsMessage messageWithType:AMPKMessageTypeRequest
+                                            name:@"shadowDocumentFailed"
+                                       channelID:0
+                                       requestID:0
+                                responseRequired:NO
+                                            data:@{ @"id" : @(documentID) }
+                                   originMessage:nil
+                                           error:nil];
+}
+
+@end
@@ -20,7 +20,10 @@
 
 #import "AMPKArticle.h"
 #import "AMPKArticleProtocol.h"
+#import "AMPKLoadScheduler.h"
+#import "AMPKRuntimeCache.h"
 #import "AMPKTestHelper.h"
+#import "AMPKViewerMetrics.h"
 #import "AMPKWebViewerViewController.h"
 #import "AMPKWebViewerViewController_private.h"
 
@@ -195,6 +198,21 @@
   XCTAssertThrows([self.subject indexForViewController:recycle]);
 }
 
+/** Test that AmpViewerControllers leaving the current article's neighbours are paused. */
+- (void)testAmpViewerControllerPausedWhenRecycled {
+  [self.subject setAmpArticles:[self generateURLsWithCount:10] usingHeaders:nil];
+  [self.subject setCurrentVisibleIndex:0];
+
+  AMPKWebViewerViewController *recycle = self.subject[0];
+  AMPKWebViewerViewController *neighbour = self.subject[1];
+  XCTAssertEqual(recycle.inactiveTimeout, self.subject.inactiveViewerTimeout);
+
+  [self.subject setCurrentVisibleIndex:2];
+
+  XCTAssertTrue(recycle.paused);
+  XCTAssertFalse(neighbour.paused);
+}
+
 /** Test for AmpViewerController has not been recycled by the dataSource. */
 - (void)testAmpViewerControllerWillNotRecycle {
   [self.subject setAmpArticles:[self generateURLsWithCount:10] usingHeaders:nil];
@@ -220,6 +238,155 @@
   XCTAssertEqual([self.subject allLoadedViewControllers].count, 3);
 }
 
+/** Test that the neighbours of the current article start loading once it has been shown. */
+- (void)testNeighboursLoadAfterCurrentArticle {
+  __block NSTimeInterval now = 10;
+  self.subject.loadScheduler.clock = ^NSTimeInterval {
+    return now;
+  };
+  NSArray<id<AMPKArticleProtocol>> *ampURLs = [self generateURLsWithCount:10];
+  [self.subject setAmpArticles:ampURLs usingHeaders:nil];
+
+  [self.subject setCurrentVisibleIndex:4];
+  AMPKWebViewerViewController *current = self.subject[4];
+  AMPKWebViewerViewController *after = self.subject[5];
+  XCTAssertEqualObjects(current.article.publisherURL, ampURLs[4].publisherURL);
+  XCTAssertNil(after.article);
+  XCTAssertTrue([self.subject.loadScheduler hasPendingLoadWithKey:after]);
+
+  now = 10.5;
+  current.revealHandler(current);
+  XCTAssertEqualObjects(after.article.publisherURL, ampURLs[5].publisherURL);
+  XCTAssertEqual(self.subject.metrics.timeToVisibleCount, 1);
+  XCTAssertEqual([self.subject.metrics timeToVisibleAtPercentile:50], 0.5);
+}
+
+/** Test that the current article's neighbours load with it when staging is turned off. */
+- (void)testStagedLoadTimeoutOff {
+  self.subject.stagedLoadTimeout = 0;
+  XCTAssertEqual([[self.subject copy] stagedLoadTimeout], 0);
+  NSArray<id<AMPKArticleProtocol>> *ampURLs = [self generateURLsWithCount:10];
+  [self.subject setAmpArticles:ampURLs usingHeaders:nil];
+
+  [self.subject setCurrentVisibleIndex:4];
+  XCTAssertEqualObjects(self.subject[3].article.publisherURL, ampURLs[3].publisherURL);
+  XCTAssertEqualObjects(self.subject[5].article.publisherURL, ampURLs[5].publisherURL);
+}
+
+/** Test that the current article is reloaded as soon as its web content process is terminated. */
+- (void)testWebContentTerminationReloadsCurrentArticle {
+  self.subject.stagedLoadTimeout = 0;
+  [self.subject setAmpArticles:[self generateURLsWithCount:10] usingHeaders:nil];
+  [self.subject setCurrentVisibleIndex:4];
+  AMPKWebViewerViewController *current = self.subject[4];
+  AMPKWebViewerViewController *after = self.subject[5];
+
+  [current webContentProcessDidTerminate];
+  [after webContentProcessDidTerminate];
+
+  XCTAssertFalse(current.isWebContentTerminated);
+  XCTAssertTrue(after.isWebContentTerminated);
+  XCTAssertEqual(self.subject.metrics.webContentTerminationCount, 2);
+  XCTAssertEqual(self.subject.metrics.webContentReloadCount, 1);
+
+  // The neighbour is reloaded once it's asked for again.
+  XCTAssertEqual(self.subject[5], after);
+  XCTAssertFalse(after.isWebContentTerminated);
+  XCTAssertEqual(self.subject.metrics.webContentReloadCount, 2);
+}
+
+/** Test that the runtime cache is refreshed when it is set and its hits are counted. */
+- (void)testRuntimeCache {
+  id runtimeCache = OCMClassMock([AMPKRuntimeCache class]);
+  self.subject.runtimeCache = runtimeCache;
+  OCMVerify([runtimeCache refreshWithCompletion:nil]);
+
+  [self.subject setAmpArticles:[self generateURLsWithCount:10] usingHeaders:nil];
+  AMPKWebViewerViewController *viewController = self.subject[0];
+  XCTAssertEqual(viewController.runtimeCache, runtimeCache);
+  viewController.runtimeCacheHandler(YES, 100);
+  viewController.runtimeCacheHandler(NO, 0);
+
+  XCTAssertEqual(self.subject.metrics.runtimeCacheHitCount, 1);
+  XCTAssertEqual(self.subject.metrics.runtimeCacheMissCount, 1);
+  XCTAssertEqual(self.subject.metrics.runtimeCacheBytesSaved, 100);
+}
+
+/** Test that views whose web content process was terminated aren't reused. */
+- (void)testWebContentTerminationEvictsPooledViews {
+  [self.subject setAmpArticles:[self generateURLsWithCount:10] usingHeaders:nil];
+  [self.subject setCurrentVisibleIndex:0];
+  AMPKWebViewerViewController *first = self.subject[0];
+  AMPKWebViewerViewController *second = self.subject[1];
+  [self.subject setCurrentVisibleIndex:5];
+
+  [first webContentProcessDidTerminate];
+  [second webContentProcessDidTerminate];
+
+  AMPKWebViewerViewController *prefetched = self.subject[7];
+  XCTAssertNotEqual(prefetched, first);
+  XCTAssertNotEqual(prefetched, second);
+}
+
+/** Test that a linked article is prefetched in a pooled view and shown from the same view. */
+- (void)testLinkedArticle {
+  [self.subject setAmpArticles:[self generateURLsWithCount:10] usingHeaders:nil];
+  [self.subject setCurrentVisibleIndex:0];
+  [self.subject setCurrentVisibleIndex:5];
+  AMPKArticle *linked =
+      [AMPKArticle articleWithURL:[NSURL URLWithString:@"https://www.example.com/amp/linked"]];
+
+  AMPKWebViewerViewController *prefetched =
+      [self.subject viewControllerForLinkedArticle:linked visible:NO];
+  XCTAssertFalse([self.subject.allLoadedViewControllers containsObject:prefetched]);
+  XCTAssertTrue([self.subject.loadScheduler hasPendingLoadWithKey:prefetched]);
+
+  AMPKWebViewerViewController *shown = [self.subject viewControllerForLinkedArticle:linked
+                                                                            visible:YES];
+  XCTAssertEqual(shown, prefetched);
+  XCTAssertEqual(shown.viewerDataSourceIndex, NSNotFound);
+  XCTAssertEqualObjects(shown.article.publisherURL, linked.publisherURL);
+}
+
+/** Test that a dismissed linked view goes back to the pool and no longer belongs to a viewer. */
+- (void)testReleaseLinkedViewController {
+  self.subject.maxLoadedViewControllers = 6;
+  [self.subject setAmpArticles:[self generateURLsWithCount:10] usingHeaders:nil];
+  [self.subject setCurrentVisibleIndex:5];
+  AMPKArticle *linked =
+      [AMPKArticle articleWithURL:[NSURL URLWithString:@"https://www.example.com/amp/linked"]];
+  AMPKWebViewerViewController *shown = [self.subject viewControllerForLinkedArticle:linked
+                                                                            visible:YES];
+  [shown loadAmpArticle:linked withHeaders:nil];
+
+  [self.subject releaseLinkedViewController:shown];
+  XCTAssertTrue(shown.paused);
+  XCTAssertNil(shown.article);
+  XCTAssertNil(shown.viewer);
+}
+
+/** Test that the number of loaded AmpViewerControllers can't go below the swipeable ones. */
+- (void)testMaxLoadedViewControllers {
+  XCTAssertEqual(self.subject.maxLoadedViewControllers, 4);
+  self.subject.maxLoadedViewControllers = 6;
+  XCTAssertEqual(self.subject.maxLoadedViewControllers, 6);
+  XCTAssertEqual([[self.subject copy] maxLoadedViewControllers], 6);
+  self.subject.maxLoadedViewControllers = 2;
+  XCTAssertEqual(self.subject.maxLoadedViewControllers, 3);
+}
+
+/** Test that nothing is prefetched without room beside the current article's neighbours. */
+- (void)testAmpViewerPrefetchWithoutRoom {
+  self.subject.maxLoadedViewControllers = 3;
+  [self.subject setAmpArticles:[self generateURLsWithCount:10] usingHeaders:nil];
+
+  [self.subject setCurrentVisibleIndex:4];
+  [self.subject prefetchItemAtIndex:5];
+  XCTAssertEqual([self.subject allLoadedViewControllers].count, 3);
+  [self.subject setCurrentVisibleIndex:5];
+  XCTAssertEqual([self.subject allLoadedViewControllers].count, 3);
+}
+
 /** Test for AmpViewerController has been reused by the dataSource. */
 - (void)testAmpViewerControllerReuse {
   CGPoint originalOffset = CGPointMake(100, 100);
@@ -0,0 +1,103 @@
+/**
+ * Copyright 2020 The AMP HTML Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS-IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#import "AMPKViewer.h"
+
+#import <OCMock/OCMock.h>
+#import <WebKit/WebKit.h>
+#import <XCTest/XCTest.h>
+
+#import "AMPKArticle.h"
+#import "AMPKPresenterProtocol.h"
+#import "AMPKViewerDataSource.h"
+#import "AMPKWebViewerMessageHandlerController.h"
+#import "AMPKWebViewerViewController.h"
+#import "AMPKWebViewerViewController_private.h"
+
+@interface AMPKViewerTest : XCTestCase
+@property(nonatomic) AMPKViewerDataSource *dataSource;
+@property(nonatomic) AMPKViewer *subject;
+@end
+
+@implementation AMPKViewerTest
+
+- (void)setUp {
+  [super setUp];
+  NSURL *domain = [NSURL URLWithString:@"https://www.google.com"];
+  self.dataSource = [[AMPKViewerDataSource alloc] initWithDomainName:domain];
+  self.subject = [[AMPKViewer alloc] initWithViewerDataSource:self.dataSource];
+
+  NSMutableArray<AMPKArticle *> *articles = [NSMutableArray array];
+  for (NSUInteger i = 0; i < 5; i++) {
+    NSString *url = [NSString stringWithFormat:@"https://www.example.com/%lu", (unsigned long)i];
+    [articles addObject:[AMPKArticle articleWithURL:[NSURL URLWithString:url]]];
+  }
+  [self.dataSource setAmpArticles:articles usingHeaders:nil];
+}
+
+/** A paused neighbour isn't put back in the window, where WebKit would run it again. */
+- (void)testPausedNeighbourStaysOutOfTheView {
+  [self.subject setCurrentViewerIndex:1];
+  AMPKWebViewerViewController *neighbour = self.dataSource[2];
+  XCTAssertEqual(neighbour.view.superview, self.subject.view);
+
+  [neighbour pause];
+  XCTAssertNil(neighbour.view.superview);
+
+  [self.subject setCurrentViewerIndex:3];
+  XCTAssertEqual(self.dataSource[2], neighbour);
+  XCTAssertTrue(neighbour.paused);
+  XCTAssertNil(neighbour.view.superview);
+  XCTAssertEqual(self.dataSource[4].view.superview, self.subject.view);
+}
+
+/** A link tapped in a linked page goes to the presenter, not to the viewer behind the page. */
+- (void)testLinkInLinkedPage {
+  id presenter = OCMProtocolMock(@protocol(AMPKPresenterProtocol));
+  self.subject.presenter = presenter;
+  [self.subject setCurrentViewerIndex:1];
+  AMPKWebViewerViewController *current = self.subject.currentAmpWebViewerController;
+  XCTAssertEqual(current.viewer, self.subject);
+
+  NSURL *linkedURL = [NSURL URLWithString:@"https://www.example.com/amp/linked"];
+  XCTAssertTrue([self.subject openAmpLinkURL:linkedURL fromViewController:current]);
+  AMPKArticle *linkedArticle = [AMPKArticle articleWithURL:linkedURL];
+  AMPKWebViewerViewController *linked =
+      [self.dataSource viewControllerForLinkedArticle:linkedArticle visible:YES];
+  OCMVerify([presenter presentAmpWebViewerController:linked fromViewController:current]);
+  XCTAssertNil(linked.viewer);
+  XCTAssertEqual(linked.presenter, presenter);
+
+  OCMReject([presenter presentAmpWebViewerController:OCMOCK_ANY fromViewController:linked]);
+  [linked loadAmpArticle:linkedArticle withHeaders:nil];
+  NSURLRequest *request =
+      [NSURLRequest requestWithURL:[NSURL URLWithString:@"https://www.example.com/amp/other"]];
+  id action = OCMClassMock([WKNavigationAction class]);
+  OCMStub([action navigationType]).andReturn(WKNavigationTypeLinkActivated);
+  OCMStub([action request]).andReturn(request);
+  [linked.messageHandlerController webView:linked.webView
+           decidePolicyForNavigationAction:action
+                           decisionHandler:^(WKNavigationActionPolicy policy) {
+                             XCTAssertEqual(policy, WKNavigationActionPolicyCancel);
+                           }];
+
+  OCMVerify([presenter presentEmbeddedLinkRequest:request fromViewController:linked]);
+  OCMVerifyAll(presenter);
+  XCTAssertEqual(self.subject.currentAmpWebViewerController, current);
+  XCTAssertTrue([self.dataSource.allLoadedViewControllers containsObject:current]);
+}
+
+@end
@@ -0,0 +1,87 @@
+/**
+ * Copyright 2020 The AMP HTML Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS-IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#import "AMPKViewerTraceRecorder.h"
+
+#import <XCTest/XCTest.h>
+
+#import "AMPKArticle.h"
+#import "AMPKViewer.h"
+#import "AMPKViewer_private.h"
+#import "AMPKViewerDataSource.h"
+
+@interface AMPKViewerTraceRecorderTest : XCTestCase
+@property(nonatomic) AMPKViewerTraceRecorder *subject;
+@end
+
+@implementation AMPKViewerTraceRecorderTest
+
+- (void)setUp {
+  [super setUp];
+  self.subject = [[AMPKViewerTraceRecorder alloc] init];
+}
+
+- (void)testTraceDataRoundTrips {
+  [self.subject recordFeedWithCount:10];
+  [self.subject recordJumpToIndex:2];
+  [self.subject recordSwipeBeginToIndex:3];
+  [self.subject recordSwipeEndAtIndex:3 completed:YES];
+  [self.subject recordBackground];
+
+  NSError *error = nil;
+  NSArray *events =
+      [AMPKViewerTraceRecorder eventsFromTraceData:[self.subject traceData] error:&error];
+  XCTAssertNil(error);
+  XCTAssertEqual(events.count, 5);
+  XCTAssertEqualObjects(events[0][AMPKTraceKeyType], AMPKTraceEventFeed);
+  XCTAssertEqualObjects(events[0][AMPKTraceKeyCount], @10);
+  XCTAssertEqualObjects(events[3][AMPKTraceKeyIndex], @3);
+  XCTAssertEqualObjects(events[3][AMPKTraceKeyCompleted], @YES);
+  XCTAssertLessThanOrEqual([events[0][AMPKTraceKeyTime] doubleValue],
+                           [events[4][AMPKTraceKeyTime] doubleValue]);
+}
+
+- (void)testInvalidTraceData {
+  NSString *trace = @"{\"time\":0,\"type\":\"feed\"}\nnot json\n";
+  NSData *data = [trace dataUsingEncoding:NSUTF8StringEncoding];
+  NSError *error = nil;
+  XCTAssertNil([AMPKViewerTraceRecorder eventsFromTraceData:data error:&error]);
+  XCTAssertNotNil(error);
+}
+
+- (void)testViewerRecordsFeedAndJump {
+  NSURL *domain = [NSURL URLWithString:@"https://www.google.com"];
+  AMPKViewerDataSource *dataSource = [[AMPKViewerDataSource alloc] initWithDomainName:domain];
+  AMPKViewer *viewer = [[AMPKViewer alloc] initWithViewerDataSource:dataSource];
+  viewer.traceRecorder = self.subject;
+
+  NSMutableArray<AMPKArticle *> *articles = [NSMutableArray array];
+  for (NSUInteger i = 0; i < 3; i++) {
+    NSString *url = [NSString stringWithFormat:@"https://www.example.com/%lu", (unsigned long)i];
+    [articles addObject:[AMPKArticle articleWithURL:[NSURL URLWithString:url]]];
+  }
+  [dataSource setAmpArticles:articles usingHeaders:nil];
+  [viewer setCurrentViewerIndex:2];
+
+  NSArray<NSDictionary<NSString *, id> *> *events = self.subject.events;
+  XCTAssertEqual(events.count, 2);
+  XCTAssertEqualObjects(events[0][AMPKTraceKeyType], AMPKTraceEventFeed);
+  XCTAssertEqualObjects(events[0][AMPKTraceKeyCount], @3);
+  XCTAssertEqualObjects(events[1][AMPKTraceKeyType], AMPKTraceEventJump);
+  XCTAssertEqualObjects(events[1][AMPKTraceKeyIndex], @2);
+}
+
+@end
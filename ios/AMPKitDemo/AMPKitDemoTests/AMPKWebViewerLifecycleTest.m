@@ -0,0 +1,134 @@
+/**
+ * Copyright 2020 The AMP HTML Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS-IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#import "AMPKWebViewerLifecycle.h"
+
+#import <XCTest/XCTest.h>
+
+@interface AMPKWebViewerLifecycleTest : XCTestCase <AMPKWebViewerLifecycleDelegate>
+@property(nonatomic) AMPKWebViewerLifecycle *subject;
+@property(nonatomic) BOOL prefetched;
+@property(nonatomic) NSMutableArray<NSNumber *> *sentStates;
+@property(nonatomic) NSInteger reloadCount;
+@end
+
+@implementation AMPKWebViewerLifecycleTest
+
+- (void)setUp {
+  [super setUp];
+  self.sentStates = [NSMutableArray array];
+  self.subject = [[AMPKWebViewerLifecycle alloc] init];
+  self.subject.delegate = self;
+  [self.subject articleWillLoad];
+}
+
+/** A prefetched viewer is shown as prefetched, which isn't visible, whatever it is set to. */
+- (void)testPrefetched {
+  self.prefetched = YES;
+  [self.subject setVisible:YES];
+
+  XCTAssertFalse(self.subject.visible);
+  XCTAssertEqual(self.subject.visibilityState, AMPKVisibilityStatePrefetched);
+  XCTAssertEqualObjects(self.sentStates, (@[ @(AMPKVisibilityStatePrefetched) ]));
+}
+
+/** A paused viewer isn't told it is hidden, and is told it is visible when it is made so. */
+- (void)testPausedUntilVisible {
+  [self.subject setVisible:YES];
+  [self.subject pause];
+  [self.subject setVisible:NO];
+
+  XCTAssertTrue(self.subject.paused);
+  XCTAssertFalse(self.subject.visible);
+
+  [self.subject setVisible:YES];
+
+  XCTAssertFalse(self.subject.paused);
+  XCTAssertEqualObjects(self.sentStates, (@[
+                          @(AMPKVisibilityStateVisible), @(AMPKVisibilityStatePaused),
+                          @(AMPKVisibilityStateVisible)
+                        ]));
+}
+
+/** A hidden viewer is paused once it has been inactive for inactiveTimeout. */
+- (void)testPausedAfterInactiveTimeout {
+  self.subject.inactiveTimeout = 0.05;
+  [self.subject setVisible:YES];
+  [self.subject setVisible:NO];
+
+  [[NSRunLoop currentRunLoop] runUntilDate:[NSDate dateWithTimeIntervalSinceNow:0.2]];
+
+  XCTAssertTrue(self.subject.paused);
+}
+
+/** A terminated article is reloaded once the viewer is visible. */
+- (void)testReloadsWhenVisible {
+  [self.subject webContentProcessDidTerminate];
+  XCTAssertTrue(self.subject.webContentTerminated);
+  XCTAssertEqual(self.reloadCount, 0);
+
+  [self.subject setVisible:YES];
+
+  XCTAssertFalse(self.subject.webContentTerminated);
+  XCTAssertEqual(self.reloadCount, 1);
+}
+
+/** Without reloadsWhenVisible, a terminated article waits for reloadAfterWebContentTermination. */
+- (void)testReloadsWhenAsked {
+  self.subject.reloadsWhenVisible = NO;
+  [self.subject setVisible:YES];
+  [self.subject webContentProcessDidTerminate];
+  XCTAssertEqual(self.reloadCount, 0);
+
+  [self.subject reloadAfterWebContentTermination];
+  [self.subject reloadAfterWebContentTermination];
+
+  XCTAssertEqual(self.reloadCount, 1);
+}
+
+/** The runtime is told its state again, except when hidden, which it starts out as. */
+- (void)testResendVisibilityState {
+  [self.subject setVisible:NO];
+  [self.subject resendVisibilityState];
+  XCTAssertEqualObjects(self.sentStates, (@[ @(AMPKVisibilityStateHidden) ]));
+
+  [self.subject pause];
+  [self.subject resendVisibilityState];
+  XCTAssertEqualObjects(self.sentStates, (@[
+                          @(AMPKVisibilityStateHidden), @(AMPKVisibilityStatePaused),
+                          @(AMPKVisibilityStatePaused)
+                        ]));
+}
+
+#pragma mark - AMPKWebViewerLifecycleDelegate
+
+- (BOOL)webViewerLifecycleIsPrefetched:(AMPKWebViewerLifecycle *)lifecycle {
+  return self.prefetched;
+}
+
+- (void)webViewerLifecycle:(AMPKWebViewerLifecycle *)lifecycle
+    didEnterVisibilityState:(AMPKVisibilityState)visibilityState {
+  [self.sentStates addObject:@(visibilityState)];
+}
+
+- (void)webViewerLifecycleNeedsReload:(AMPKWebViewerLifecycle *)lifecycle {
+  self.reloadCount++;
+}
+
+- (void)webViewerLifecycleDidChange:(AMPKWebViewerLifecycle *)lifecycle {
+}
+
+@end
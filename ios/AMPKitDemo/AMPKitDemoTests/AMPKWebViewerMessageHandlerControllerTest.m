@@ -21,6 +21,7 @@
 #import "AMPKWebViewerJsMessage_private.h"
 #import "AMPKWebViewerMessageHandlerController_private.h"
 #import "AMPKTestHelper.h"
+#import "AMPKViewer.h"
 #import "AMPKWebViewerViewController.h"
 #import "AMPKWebViewerViewController_private.h"
 
@@ -216,6 +217,29 @@
   [ampViewerMock stopMocking];
 }
 
+/** A long press on a link prefetches it, through the context menu delegate from iOS 13. */
+- (void)testLongPressPrefetchesLink {
+  if (@available(iOS 13.0, *)) {
+    AMPKWebViewerViewController *ampViewer = [AMPKTestHelper setupWebViewerViewController];
+    id viewerMock = OCMClassMock([AMPKViewer class]);
+    ampViewer.viewer = viewerMock;
+    self.messageHandlerController.ampWebViewerController = ampViewer;
+    NSURL *linkURL = [NSURL URLWithString:@"https://www.example.com/amp/linked"];
+    id elementInfo = OCMClassMock([WKContextMenuElementInfo class]);
+    OCMStub([elementInfo linkURL]).andReturn(linkURL);
+
+    __block BOOL completed = NO;
+    [self.messageHandlerController webView:ampViewer.webView
+        contextMenuConfigurationForElement:elementInfo
+                         completionHandler:^(UIContextMenuConfiguration *configuration) {
+                           XCTAssertNil(configuration);
+                           completed = YES;
+                         }];
+    XCTAssertTrue(completed);
+    OCMVerify([viewerMock prefetchAmpLinkURL:linkURL]);
+  }
+}
+
 - (void)testStartHandlingMessagesForWebView {
   AMPKWebViewerViewController *ampViewer = [AMPKTestHelper setupWebViewerViewController];
 
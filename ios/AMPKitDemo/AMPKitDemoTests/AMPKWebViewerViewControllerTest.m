@@ -0,0 +1,126 @@
+/**
+ * Copyright 2020 The AMP HTML Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS-IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#import "AMPKWebViewerViewController.h"
+
+#import <OCMock/OCMock.h>
+#import <WebKit/WebKit.h>
+#import <XCTest/XCTest.h>
+
+#import "AMPKArticle.h"
+#import "AMPKWebViewerJsMessage.h"
+#import "AMPKWebViewerMessageHandlerController.h"
+#import "AMPKWebViewerViewController_private.h"
+
+@interface AMPKWebViewerViewControllerTest : XCTestCase
+@property(nonatomic) AMPKWebViewerViewController *subject;
+@end
+
+@implementation AMPKWebViewerViewControllerTest
+
+- (void)setUp {
+  [super setUp];
+  self.subject = [[AMPKWebViewerViewController alloc]
+      initWithDomainName:[NSURL URLWithString:@"https://www.google.com"]];
+  AMPKArticle *article =
+      [AMPKArticle articleWithURL:[NSURL URLWithString:@"https://www.example.com/story"]];
+  [self.subject loadAmpArticle:article withHeaders:nil];
+}
+
+/** The article is revealed when the runtime reports documentLoaded, not when loading finishes. */
+- (void)testRevealOnDocumentLoaded {
+  XCTAssertTrue(self.subject.webView.hidden);
+
+  [self.subject AMPDocumentLoadedWithMessage:[self documentLoadedMessage]];
+
+  XCTAssertFalse(self.subject.webView.hidden);
+}
+
+/** Reusing the view controller hides the web view until the next article is revealed. */
+- (void)testHiddenAgainAfterReuse {
+  [self.subject AMPDocumentLoadedWithMessage:[self documentLoadedMessage]];
+  [self.subject prepareForReuse];
+
+  XCTAssertTrue(self.subject.webView.hidden);
+
+  AMPKArticle *article =
+      [AMPKArticle articleWithURL:[NSURL URLWithString:@"https://www.example.com/other"]];
+  [self.subject loadAmpArticle:article withHeaders:nil];
+
+  XCTAssertTrue(self.subject.webView.hidden);
+}
+
+/** A paused viewer stays paused while it is hidden and resumes when it is made visible. */
+- (void)testPausedUntilVisible {
+  [self.subject setVisible:NO];
+  [self.subject pause];
+  XCTAssertTrue(self.subject.paused);
+
+  [self.subject setVisible:NO];
+  XCTAssertTrue(self.subject.paused);
+
+  [self.subject setVisible:YES];
+  XCTAssertFalse(self.subject.paused);
+}
+
+/** A viewer paused before its document loaded is paused once the runtime can be told. */
+- (void)testPausedAgainOnDocumentLoaded {
+  id messageHandlerMock = OCMPartialMock(self.subject.messageHandlerController);
+  [self.subject pause];
+
+  [self.subject AMPDocumentLoadedWithMessage:[self documentLoadedMessage]];
+
+  OCMVerify([messageHandlerMock sendPaused]);
+  [messageHandlerMock stopMocking];
+}
+
+/** A hidden viewer is paused once it has been inactive for inactiveTimeout. */
+- (void)testPausedAfterInactiveTimeout {
+  self.subject.inactiveTimeout = 0.05;
+  [self.subject setVisible:YES];
+  [self.subject setVisible:NO];
+  XCTAssertFalse(self.subject.paused);
+
+  [[NSRunLoop currentRunLoop] runUntilDate:[NSDate dateWithTimeIntervalSinceNow:0.2]];
+
+  XCTAssertTrue(self.subject.paused);
+}
+
+/** Making the viewer visible again before the timeout keeps it from being paused. */
+- (void)testVisibleCancelsInactiveTimeout {
+  self.subject.inactiveTimeout = 0.05;
+  [self.subject setVisible:NO];
+  [self.subject setVisible:YES];
+
+  [[NSRunLoop currentRunLoop] runUntilDate:[NSDate dateWithTimeIntervalSinceNow:0.2]];
+
+  XCTAssertFalse(self.subject.paused);
+}
+
+#pragma mark - Private
+
+- (AMPKWebViewerJsMessage *)documentLoadedMessage {
+  return [AMPKWebViewerJsMessage messageWithType:AMPKMessageTypeRequest
+                                            name:@"documentLoaded"
+                                       channelID:0
+                                       requestID:0
+                                responseRequired:NO
+                                            data:@{}
+                                   originMessage:nil
+                                           error:nil];
+}
+
+@end
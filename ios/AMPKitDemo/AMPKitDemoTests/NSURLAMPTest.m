@@ -133,6 +133,31 @@ static NSString *kDomainName = @"https://www.google.com";
   XCTAssert([[url ampk_ProxiedURL].absoluteString isEqualToString:cdnString]);
 }
 
+- (void)testCacheSubdomainURL {
+  NSURL *url = [NSURL URLWithString:@"https://cdn.ampproject.org/c/s/www.ex-ample.com/a?b=1#c"];
+  NSString *expectedURL =
+      @"https://www-ex--ample-com.cdn.ampproject.org/c/s/www.ex-ample.com/a?b=1#c";
+  XCTAssertEqualObjects([url ampk_CacheSubdomainURL].absoluteString, expectedURL);
+
+  url = [NSURL URLWithString:@"https://www-example-com.cdn.ampproject.org/c/s/www.example.com/a"];
+  XCTAssertEqualObjects([url ampk_CacheSubdomainURL], url);
+
+  // "--" as the third and fourth characters.
+  url = [NSURL URLWithString:@"https://cdn.ampproject.org/c/s/ab-cd.example.com/a"];
+  XCTAssertEqualObjects([url ampk_CacheSubdomainURL].host,
+                        @"0-ab--cd-example-com-0.cdn.ampproject.org");
+}
+
+- (void)testNoCacheSubdomainURL {
+  XCTAssertNil([[NSURL URLWithString:@"https://www.example.com/a"] ampk_CacheSubdomainURL]);
+  XCTAssertNil([[NSURL URLWithString:@"https://cdn.ampproject.org/c/s/xn--bcher-kva.example/a"]
+      ampk_CacheSubdomainURL]);
+  NSString *longHost = [[@"" stringByPaddingToLength:60 withString:@"a" startingAtIndex:0]
+      stringByAppendingString:@".com"];
+  NSString *longURL = [NSString stringWithFormat:@"https://cdn.ampproject.org/c/s/%@/a", longHost];
+  XCTAssertNil([[NSURL URLWithString:longURL] ampk_CacheSubdomainURL]);
+}
+
 - (void)testCDNMatchesForCURLS {
   NSString *url = @"https://www-theverge-com.cdn.ampproject.org/c/s/www.theverge.com/platform/amp/2016/4/25/11501484/what-in-the-world-is-obama-looking-at-in-virtual-reality";
   NSURL *CURLSCDN = [NSURL URLWithString:url];
@@ -257,4 +282,36 @@ static NSString *kDomainName = @"https://www.google.com";
   XCTAssertEqualObjects(expectedCDNURLString, outputCDNURL.absoluteString);
 }
 
+- (void)testAMPPublisherURLOfCDNURL {
+  NSURL *url = [NSURL
+      URLWithString:@"https://www-example-com.cdn.ampproject.org/c/s/www.example.com/a/story/?x=1"];
+  XCTAssertEqualObjects([url ampk_AMPPublisherURL].absoluteString,
+                        @"https://www.example.com/a/story/?x=1");
+
+  url = [NSURL
+      URLWithString:@"https://cdn.ampproject.org/v/www.example.com/story.html?amp_js_v=0.1"];
+  XCTAssertEqualObjects([url ampk_AMPPublisherURL].absoluteString,
+                        @"http://www.example.com/story.html");
+}
+
+- (void)testAMPPublisherURLOfViewerURL {
+  NSURL *url = [NSURL URLWithString:@"https://www.google.com/amp/s/www.example.com/story.html"];
+  XCTAssertEqualObjects([url ampk_AMPPublisherURL].absoluteString,
+                        @"https://www.example.com/story.html");
+  XCTAssertNil([[NSURL URLWithString:@"https://www.google.com/search?q=amp"] ampk_AMPPublisherURL]);
+}
+
+- (void)testAMPPublisherURLOfPublisherURL {
+  NSArray<NSString *> *ampURLs = @[
+    @"https://www.example.com/amp/story.html", @"https://www.example.com/story.amp.html",
+    @"https://www.example.com/story.html?amp", @"https://www.example.com/story?outputType=amp"
+  ];
+  for (NSString *ampURL in ampURLs) {
+    NSURL *url = [NSURL URLWithString:ampURL];
+    XCTAssertEqualObjects([url ampk_AMPPublisherURL], url);
+  }
+  XCTAssertNil([[NSURL URLWithString:@"https://www.example.com/story.html"] ampk_AMPPublisherURL]);
+  XCTAssertNil([[NSURL URLWithString:@"mailto:amp@example.com"] ampk_AMPPublisherURL]);
+}
+
 @end
@@ -0,0 +1,61 @@
+/**
+ * Copyright 2020 The AMP HTML Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS-IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * The body of a benchmark. It must run the measured operation @c iterations times; anything it
+ * needs should be set up before the benchmark is added so it isn't measured.
+ */
+typedef void (^AMPKBenchmarkBlock)(NSUInteger iterations);
+
+/**
+ * A set of benchmarks. Each one is run with a growing number of iterations until a run takes long
+ * enough to time reliably, then its time and Objective-C object allocations per iteration are
+ * reported.
+ */
+@interface AMPKBenchmarkSuite : NSObject
+
+/** The minimum duration of the run a benchmark is reported from, 0.2 seconds by default. */
+@property(nonatomic) NSTimeInterval minimumRunTime;
+
+- (void)addBenchmarkNamed:(NSString *)name block:(AMPKBenchmarkBlock)block;
+
+/**
+ * Runs the benchmarks and prints a table of the results.
+ * @param arguments The command line arguments: --filter=<substring> only runs the benchmarks
+ * whose name contains it, --json=<path> also writes the results to a JSON file.
+ * @return The exit code for main().
+ */
+- (int)runWithArguments:(NSArray<NSString *> *)arguments;
+
+@end
+
+/**
+ * Counts every Objective-C object allocated through +allocWithZone:, which +alloc and +new go
+ * through, from the first call on. Objects CoreFoundation creates directly aren't counted.
+ */
+void AMPKBenchmarkStartCountingAllocations(void);
+
+/** The number of allocations counted so far. */
+uint64_t AMPKBenchmarkAllocationCount(void);
+
+/** Keeps the compiler from optimizing away a result that is otherwise unused. */
+void AMPKBenchmarkUse(id _Nullable object);
+
+NS_ASSUME_NONNULL_END
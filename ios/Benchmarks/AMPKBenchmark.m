@@ -0,0 +1,195 @@
+/**
+ * Copyright 2020 The AMP HTML Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS-IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#import "AMPKBenchmark.h"
+
+#import <objc/runtime.h>
+#include <time.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+static const NSTimeInterval kDefaultMinimumRunTime = 0.2;
+static const NSUInteger kMaxIterations = 100000000;
+static const uint64_t kNanosecondsPerSecond = 1000000000ULL;
+
+static uint64_t gAllocationCount = 0;
+static volatile uintptr_t gUseSink = 0;
+
+@interface NSObject (AMPKBenchmark)
++ (id)ampkbench_allocWithZone:(nullable NSZone *)zone NS_RETURNS_RETAINED;
+@end
+
+@implementation NSObject (AMPKBenchmark)
+
+// Swapped with +allocWithZone:, so this calls the original implementation.
++ (id)ampkbench_allocWithZone:(nullable NSZone *)zone {
+  gAllocationCount++;
+  return [self ampkbench_allocWithZone:zone];
+}
+
+@end
+
+void AMPKBenchmarkStartCountingAllocations(void) {
+  static BOOL started = NO;
+  if (started) {
+    return;
+  }
+  started = YES;
+  Method original = class_getClassMethod([NSObject class], @selector(allocWithZone:));
+  Method counting = class_getClassMethod([NSObject class], @selector(ampkbench_allocWithZone:));
+  method_exchangeImplementations(original, counting);
+}
+
+uint64_t AMPKBenchmarkAllocationCount(void) {
+  return gAllocationCount;
+}
+
+void AMPKBenchmarkUse(id _Nullable object) {
+  gUseSink ^= (uintptr_t)(__bridge void *)object;
+}
+
+static uint64_t AMPKBenchmarkNanoseconds(void) {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (uint64_t)now.tv_sec * kNanosecondsPerSecond + (uint64_t)now.tv_nsec;
+}
+
+/** The result of a single benchmark. */
+@interface AMPKBenchmarkResult : NSObject
+@property(nonatomic, copy) NSString *name;
+@property(nonatomic) NSUInteger iterations;
+@property(nonatomic) double nanosecondsPerOperation;
+@property(nonatomic) double allocationsPerOperation;
+@end
+
+@implementation AMPKBenchmarkResult
+@end
+
+@implementation AMPKBenchmarkSuite {
+  NSMutableArray<NSString *> *_names;
+  NSMutableArray<AMPKBenchmarkBlock> *_blocks;
+}
+
+- (instancetype)init {
+  self = [super init];
+  if (self) {
+    _minimumRunTime = kDefaultMinimumRunTime;
+    _names = [[NSMutableArray alloc] init];
+    _blocks = [[NSMutableArray alloc] init];
+  }
+  return self;
+}
+
+- (void)addBenchmarkNamed:(NSString *)name block:(AMPKBenchmarkBlock)block {
+  [_names addObject:[name copy]];
+  [_blocks addObject:[block copy]];
+}
+
+- (int)runWithArguments:(NSArray<NSString *> *)arguments {
+  NSString *filter = nil;
+  NSString *jsonPath = nil;
+  for (NSString *argument in arguments) {
+    if ([argument hasPrefix:@"--filter="]) {
+      filter = [argument substringFromIndex:@"--filter=".length];
+    } else if ([argument hasPrefix:@"--json="]) {
+      jsonPath = [argument substringFromIndex:@"--json=".length];
+    }
+  }
+
+  AMPKBenchmarkStartCountingAllocations();
+
+  printf("%-50s %12s %14s %12s\n", "benchmark", "iterations", "ns/op", "allocs/op");
+  NSMutableArray<AMPKBenchmarkResult *> *results = [[NSMutableArray alloc] init];
+  for (NSUInteger i = 0; i < _names.count; i++) {
+    if (filter.length && [_names[i] rangeOfString:filter].location == NSNotFound) {
+      continue;
+    }
+    AMPKBenchmarkResult *result = [self runBenchmarkNamed:_names[i] block:_blocks[i]];
+    printf("%-50s %12lu %14.1f %12.2f\n", result.name.UTF8String,
+           (unsigned long)result.iterations, result.nanosecondsPerOperation,
+           result.allocationsPerOperation);
+    [results addObject:result];
+  }
+
+  if (jsonPath.length) {
+    return [self writeResults:results toPath:jsonPath] ? 0 : 1;
+  }
+  return 0;
+}
+
+#pragma mark - Private
+
+- (AMPKBenchmarkResult *)runBenchmarkNamed:(NSString *)name block:(AMPKBenchmarkBlock)block {
+  // Warm up caches and lazily created state before measuring.
+  @autoreleasepool {
+    block(1);
+  }
+
+  NSUInteger iterations = 1;
+  uint64_t elapsed = 0;
+  uint64_t allocations = 0;
+  const uint64_t minimumNanoseconds = (uint64_t)(_minimumRunTime * kNanosecondsPerSecond);
+  while (YES) {
+    @autoreleasepool {
+      uint64_t allocationsBefore = gAllocationCount;
+      uint64_t start = AMPKBenchmarkNanoseconds();
+      block(iterations);
+      elapsed = AMPKBenchmarkNanoseconds() - start;
+      allocations = gAllocationCount - allocationsBefore;
+    }
+    if (elapsed >= minimumNanoseconds || iterations >= kMaxIterations) {
+      break;
+    }
+    // Aim a little past the minimum run time, but grow by at most 100x per round.
+    double perIteration = MAX(1.0, (double)elapsed / iterations);
+    double next = 1.2 * minimumNanoseconds / perIteration;
+    iterations = (NSUInteger)MIN(MAX(next, iterations + 1.0),
+                                 MIN(iterations * 100.0, (double)kMaxIterations));
+  }
+
+  AMPKBenchmarkResult *result = [[AMPKBenchmarkResult alloc] init];
+  result.name = name;
+  result.iterations = iterations;
+  result.nanosecondsPerOperation = (double)elapsed / iterations;
+  result.allocationsPerOperation = (double)allocations / iterations;
+  return result;
+}
+
+- (BOOL)writeResults:(NSArray<AMPKBenchmarkResult *> *)results toPath:(NSString *)path {
+  NSMutableArray *json = [[NSMutableArray alloc] initWithCapacity:results.count];
+  for (AMPKBenchmarkResult *result in results) {
+    [json addObject:@{
+      @"name" : result.name,
+      @"iterations" : @(result.iterations),
+      @"ns_per_op" : @(result.nanosecondsPerOperation),
+      @"allocs_per_op" : @(result.allocationsPerOperation),
+    }];
+  }
+  NSError *error = nil;
+  NSData *data = [NSJSONSerialization dataWithJSONObject:json
+                                                 options:NSJSONWritingPrettyPrinted
+                                                   error:&error];
+  if (!data || ![data writeToFile:path atomically:YES]) {
+    fprintf(stderr, "Could not write %s: %s\n", path.UTF8String,
+            error.localizedDescription.UTF8String ?: "write failed");
+    return NO;
+  }
+  return YES;
+}
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,50 @@
+/**
+ * Copyright 2020 The AMP HTML Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS-IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#import "AMPKBenchmarkCases.h"
+
+#import "AMPKArticle.h"
+#import "AMPKBenchmark.h"
+
+void AMPKAddArticleBenchmarks(AMPKBenchmarkSuite *suite) {
+  NSURL *publisherURL = [NSURL URLWithString:@"https://www.example.com/news/story.amp.html"];
+  AMPKArticle *article = [AMPKArticle articleWithURL:publisherURL];
+  AMPKArticle *same = [AMPKArticle articleWithURL:publisherURL];
+
+  [suite addBenchmarkNamed:@"article/create" block:^(NSUInteger iterations) {
+    for (NSUInteger i = 0; i < iterations; i++) {
+      AMPKBenchmarkUse([AMPKArticle articleWithURL:publisherURL]);
+    }
+  }];
+
+  [suite addBenchmarkNamed:@"article/copy" block:^(NSUInteger iterations) {
+    for (NSUInteger i = 0; i < iterations; i++) {
+      AMPKBenchmarkUse([article copy]);
+    }
+  }];
+
+  [suite addBenchmarkNamed:@"article/is-equal" block:^(NSUInteger iterations) {
+    for (NSUInteger i = 0; i < iterations; i++) {
+      AMPKBenchmarkUse(@([article isEqual:same]));
+    }
+  }];
+
+  [suite addBenchmarkNamed:@"article/considered-the-same" block:^(NSUInteger iterations) {
+    for (NSUInteger i = 0; i < iterations; i++) {
+      AMPKBenchmarkUse(@(AMPKViewerShouldConsiderArticlesTheSame(article, same)));
+    }
+  }];
+}
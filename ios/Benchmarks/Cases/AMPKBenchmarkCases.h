@@ -0,0 +1,37 @@
+/**
+ * Copyright 2020 The AMP HTML Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS-IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#import <Foundation/Foundation.h>
+
+@class AMPKBenchmarkSuite;
+
+/** NSURL+AMPK: building and matching cache URLs. */
+void AMPKAddURLBenchmarks(AMPKBenchmarkSuite *suite);
+
+/** AMPKWebViewerJsMessage: encoding and decoding runtime messages. */
+void AMPKAddMessageBenchmarks(AMPKBenchmarkSuite *suite);
+
+/** AMPKMessageBroadcaster: fanning broadcasts out to the loaded viewers and collecting replies. */
+void AMPKAddBroadcastBenchmarks(AMPKBenchmarkSuite *suite);
+
+/** AMPKArticle: copying and comparing articles. */
+void AMPKAddArticleBenchmarks(AMPKBenchmarkSuite *suite);
+
+/**
+ * AMPKViewerDataSource: replacing the articles, directly or from a feed snapshot, and swiping
+ * through them.
+ */
+void AMPKAddDataSourceBenchmarks(AMPKBenchmarkSuite *suite);
@@ -0,0 +1,88 @@
+/**
+ * Copyright 2020 The AMP HTML Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS-IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#import "AMPKBenchmarkCases.h"
+
+#import "AMPKArticle.h"
+#import "AMPKBenchmark.h"
+#import "AMPKMessageBroadcaster.h"
+#import "AMPKWebViewerJsMessage.h"
+#import "AMPKWebViewerMessageHandlerController.h"
+#import "AMPKWebViewerViewController.h"
+
+// As many viewers as AMPKViewerDataSource keeps loaded, all showing articles from one publisher so
+// every broadcast reaches the other three.
+static const NSUInteger kLoadedViewers = 4;
+
+void AMPKAddBroadcastBenchmarks(AMPKBenchmarkSuite *suite) {
+  NSURL *domain = [NSURL URLWithString:@"https://www.google.com/"];
+  NSMutableArray<AMPKWebViewerViewController *> *viewers = [NSMutableArray array];
+  NSMutableSet<AMPKWebViewerMessageHandlerController *> *controllers = [NSMutableSet set];
+  for (NSUInteger i = 0; i < kLoadedViewers; i++) {
+    AMPKWebViewerViewController *viewer =
+        [[AMPKWebViewerViewController alloc] initWithDomainName:domain];
+    NSString *url = [NSString stringWithFormat:@"https://www.example.com/story-%lu.amp.html",
+                                               (unsigned long)i];
+    [viewer loadAmpArticle:[AMPKArticle articleWithURL:[NSURL URLWithString:url]] withHeaders:nil];
+    [viewers addObject:viewer];
+    [controllers addObject:viewer.messageHandlerController];
+  }
+  AMPKMessageBroadcaster *broadcaster = [[AMPKMessageBroadcaster alloc] init];
+  [broadcaster setLoadedControllers:controllers];
+  AMPKWebViewerMessageHandlerController *source = viewers[0].messageHandlerController;
+
+  [suite addBenchmarkNamed:@"broadcast/fan-out" block:^(NSUInteger iterations) {
+    for (NSUInteger i = 0; i < iterations; i++) {
+      AMPKWebViewerJsMessage *broadcast =
+          [AMPKWebViewerJsMessage messageWithType:AMPKMessageTypeRequest
+                                             name:@"broadcast"
+                                        channelID:1
+                                        requestID:(NSInteger)i
+                                 responseRequired:NO
+                                             data:@{ @"type" : @"amp-bind" }
+                                    originMessage:nil
+                                            error:nil];
+      [broadcaster postBroadcast:broadcast fromController:source];
+    }
+  }];
+
+  [suite addBenchmarkNamed:@"broadcast/fan-out-and-reply" block:^(NSUInteger iterations) {
+    for (NSUInteger i = 0; i < iterations; i++) {
+      AMPKWebViewerJsMessage *broadcast =
+          [AMPKWebViewerJsMessage messageWithType:AMPKMessageTypeRequest
+                                             name:@"broadcast"
+                                        channelID:1
+                                        requestID:(NSInteger)i
+                                 responseRequired:YES
+                                             data:@{ @"type" : @"amp-bind" }
+                                    originMessage:nil
+                                            error:nil];
+      [broadcaster postBroadcast:broadcast fromController:source];
+      for (NSUInteger v = 1; v < kLoadedViewers; v++) {
+        AMPKWebViewerJsMessage *reply =
+            [AMPKWebViewerJsMessage messageWithType:AMPKMessageTypeResponse
+                                               name:@"broadcast"
+                                          channelID:1
+                                          requestID:(NSInteger)i
+                                   responseRequired:NO
+                                               data:@YES
+                                      originMessage:broadcast
+                                              error:nil];
+        [broadcaster postBroadcast:reply fromController:viewers[v].messageHandlerController];
+      }
+    }
+  }];
+}
@@ -0,0 +1,97 @@
+/**
+ * Copyright 2020 The AMP HTML Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS-IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#import "AMPKBenchmarkCases.h"
+
+#import "AMPKArticle.h"
+#import "AMPKBenchmark.h"
+#import "AMPKFeedSnapshot.h"
+#import "AMPKViewerDataSource.h"
+
+// The size of a typical feed handed to the viewer.
+static const NSUInteger kFeedSize = 100;
+
+static NSArray<AMPKArticle *> *AMPKBenchmarkFeed(NSString *section) {
+  NSMutableArray<AMPKArticle *> *articles = [NSMutableArray arrayWithCapacity:kFeedSize];
+  for (NSUInteger i = 0; i < kFeedSize; i++) {
+    NSString *url = [NSString stringWithFormat:@"https://www.example.com/%@/story-%lu.amp.html",
+                                               section, (unsigned long)i];
+    [articles addObject:[AMPKArticle articleWithURL:[NSURL URLWithString:url]]];
+  }
+  return articles;
+}
+
+void AMPKAddDataSourceBenchmarks(AMPKBenchmarkSuite *suite) {
+  NSURL *domain = [NSURL URLWithString:@"https://www.google.com/"];
+  NSArray<NSArray<AMPKArticle *> *> *feeds = @[ AMPKBenchmarkFeed(@"news"),
+                                                AMPKBenchmarkFeed(@"sports") ];
+
+  // Alternates between two feeds, so every call replaces the articles.
+  [suite addBenchmarkNamed:@"datasource/set-articles" block:^(NSUInteger iterations) {
+    AMPKViewerDataSource *dataSource = [[AMPKViewerDataSource alloc] initWithDomainName:domain];
+    for (NSUInteger i = 0; i < iterations; i++) {
+      [dataSource setAmpArticles:feeds[i % 2] usingHeaders:nil];
+    }
+  }];
+
+  [suite addBenchmarkNamed:@"datasource/set-similar-articles" block:^(NSUInteger iterations) {
+    AMPKViewerDataSource *dataSource = [[AMPKViewerDataSource alloc] initWithDomainName:domain];
+    [dataSource setAmpArticles:feeds[0] usingHeaders:nil];
+    NSArray<AMPKArticle *> *copies = [[NSArray alloc] initWithArray:feeds[0] copyItems:YES];
+    for (NSUInteger i = 0; i < iterations; i++) {
+      [dataSource setAmpArticles:copies usingHeaders:nil];
+    }
+  }];
+
+  // The work AMPKFeedIngestor moves off the main thread.
+  [suite addBenchmarkNamed:@"datasource/build-feed-snapshot" block:^(NSUInteger iterations) {
+    for (NSUInteger i = 0; i < iterations; i++) {
+      AMPKBenchmarkUse([[AMPKFeedSnapshot alloc] initWithArticles:feeds[i % 2]
+                                                          headers:nil
+                                                       domainName:domain]);
+    }
+  }];
+
+  // What is left on the main thread once a snapshot is built.
+  [suite addBenchmarkNamed:@"datasource/set-feed-snapshot" block:^(NSUInteger iterations) {
+    NSArray<AMPKFeedSnapshot *> *snapshots = @[
+      [[AMPKFeedSnapshot alloc] initWithArticles:feeds[0] headers:nil domainName:domain],
+      [[AMPKFeedSnapshot alloc] initWithArticles:feeds[1] headers:nil domainName:domain],
+    ];
+    AMPKViewerDataSource *dataSource = [[AMPKViewerDataSource alloc] initWithDomainName:domain];
+    for (NSUInteger i = 0; i < iterations; i++) {
+      [dataSource setFeedSnapshot:snapshots[i % 2]];
+    }
+  }];
+
+  // A swipe as the page view controller drives it: prefetch the next article once the drag
+  // starts, then make it the visible one. Turns back at either end of the feed.
+  [suite addBenchmarkNamed:@"datasource/swipe" block:^(NSUInteger iterations) {
+    AMPKViewerDataSource *dataSource = [[AMPKViewerDataSource alloc] initWithDomainName:domain];
+    [dataSource setAmpArticles:feeds[0] usingHeaders:nil];
+    [dataSource setCurrentVisibleIndex:0];
+    NSInteger index = 0;
+    NSInteger step = 1;
+    for (NSUInteger i = 0; i < iterations; i++) {
+      if (index + step < 0 || index + step >= (NSInteger)kFeedSize) {
+        step = -step;
+      }
+      [dataSource prefetchItemAtIndex:index + step];
+      index += step;
+      [dataSource setCurrentVisibleIndex:index];
+    }
+  }];
+}
@@ -0,0 +1,58 @@
+/**
+ * Copyright 2020 The AMP HTML Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS-IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#import "AMPKBenchmarkCases.h"
+
+#import <WebKit/WebKit.h>
+
+#import "AMPKBenchmark.h"
+#import "AMPKWebViewerJsMessage.h"
+
+void AMPKAddMessageBenchmarks(AMPKBenchmarkSuite *suite) {
+  AMPKWebViewerJsMessage *message =
+      [AMPKWebViewerJsMessage messageWithType:AMPKMessageTypeRequest
+                                         name:@"visibilitychange"
+                                    channelID:1
+                                    requestID:42
+                             responseRequired:YES
+                                         data:@{ @"state" : @"visible", @"prerenderSize" : @1 }
+                                originMessage:nil
+                                        error:nil];
+  // The body WebKit hands the message handler for a documentLoaded message.
+  WKScriptMessage *scriptMessage =
+      [[WKScriptMessage alloc] initWithName:@"amp"
+                                       body:@{
+                                         @"app" : @"__AMPHTML__",
+                                         @"type" : @"q",
+                                         @"name" : @"documentLoaded",
+                                         @"channelid" : @1,
+                                         @"requestid" : @7,
+                                         @"rsvp" : @NO,
+                                         @"data" : @{ @"title" : @"Story", @"sourceUrl" : @"" },
+                                       }];
+
+  [suite addBenchmarkNamed:@"message/encode" block:^(NSUInteger iterations) {
+    for (NSUInteger i = 0; i < iterations; i++) {
+      AMPKBenchmarkUse([message jsonString]);
+    }
+  }];
+
+  [suite addBenchmarkNamed:@"message/decode" block:^(NSUInteger iterations) {
+    for (NSUInteger i = 0; i < iterations; i++) {
+      AMPKBenchmarkUse([scriptMessage ampWebViewerJsMessage]);
+    }
+  }];
+}
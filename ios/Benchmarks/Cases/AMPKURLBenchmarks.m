@@ -0,0 +1,51 @@
+/**
+ * Copyright 2020 The AMP HTML Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS-IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#import "AMPKBenchmarkCases.h"
+
+#import "AMPKBenchmark.h"
+#import "NSURL+AMPK.h"
+
+void AMPKAddURLBenchmarks(AMPKBenchmarkSuite *suite) {
+  NSURL *publisherURL = [NSURL URLWithString:@"https://www.example.com/news/2020/01/story.amp.html"];
+  NSURL *domain = [NSURL URLWithString:@"https://www.google.com/"];
+  NSURL *cdnURL = [publisherURL ampk_ProxiedURL];
+  NSURL *viewerURL = [cdnURL URLBySettingProxyHashFragmentsForDomain:domain];
+
+  [suite addBenchmarkNamed:@"url/proxied" block:^(NSUInteger iterations) {
+    for (NSUInteger i = 0; i < iterations; i++) {
+      AMPKBenchmarkUse([publisherURL ampk_ProxiedURL]);
+    }
+  }];
+
+  [suite addBenchmarkNamed:@"url/hash-fragments" block:^(NSUInteger iterations) {
+    for (NSUInteger i = 0; i < iterations; i++) {
+      AMPKBenchmarkUse([cdnURL URLBySettingProxyHashFragmentsForDomain:domain]);
+    }
+  }];
+
+  [suite addBenchmarkNamed:@"url/matches-cdn" block:^(NSUInteger iterations) {
+    for (NSUInteger i = 0; i < iterations; i++) {
+      AMPKBenchmarkUse(@([viewerURL matchesCDNURL:cdnURL]));
+    }
+  }];
+
+  [suite addBenchmarkNamed:@"url/sanitized-cdn" block:^(NSUInteger iterations) {
+    for (NSUInteger i = 0; i < iterations; i++) {
+      AMPKBenchmarkUse([viewerURL sanitizedCDNURL]);
+    }
+  }];
+}
@@ -0,0 +1,69 @@
+/**
+ * Copyright 2020 The AMP HTML Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS-IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/** What a trace cost when replayed with a given configuration. */
+@interface AMPKTraceSimulationResult : NSObject
+
+/** Articles loaded into a web view. */
+@property(nonatomic) NSUInteger loadsIssued;
+
+/** Loads whose article was never on screen before it was unloaded or replaced. */
+@property(nonatomic) NSUInteger wastedLoads;
+
+/** Total time the reader was looking at an article that hadn't finished loading. */
+@property(nonatomic) NSTimeInterval blankTime;
+
+/** The most web views alive at once. */
+@property(nonatomic) NSUInteger peakLiveWebViews;
+
+/** Total time loaded articles spent running off screen rather than visible or paused. */
+@property(nonatomic) NSTimeInterval hiddenRunningTime;
+
+/** How long the median, and the 90th percentile, article took to be shown once it was current. */
+@property(nonatomic) NSTimeInterval timeToVisibleMedian;
+@property(nonatomic) NSTimeInterval timeToVisibleP90;
+
+@end
+
+/**
+ * Replays traces recorded by AMPKViewerTraceRecorder through AMPKPrefetchController, AMPKViewer's
+ * page transition callbacks and AMPKViewerDataSource, with stub web views that take a fixed
+ * simulated time to load and share the network while they do. Nothing waits on real time, so a
+ * trace replays in milliseconds.
+ */
+@interface AMPKTraceSimulator : NSObject
+
+/** How long every article takes to load, 1 second by default. */
+@property(nonatomic) NSTimeInterval loadTime;
+
+/** See AMPKViewerDataSource's maxLoadedViewControllers. */
+@property(nonatomic) NSInteger maxLoadedViewControllers;
+
+/** See AMPKViewerDataSource's inactiveViewerTimeout. */
+@property(nonatomic) NSTimeInterval inactiveViewerTimeout;
+
+/** See AMPKViewerDataSource's stagedLoadTimeout. */
+@property(nonatomic) NSTimeInterval stagedLoadTimeout;
+
+- (AMPKTraceSimulationResult *)replayEvents:(NSArray<NSDictionary<NSString *, id> *> *)events;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,213 @@
+/**
+ * Copyright 2020 The AMP HTML Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS-IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#import "AMPKTraceSimulator.h"
+
+#import <UIKit/UIKit.h>
+
+#import "AMPKArticle.h"
+#import "AMPKLoadScheduler.h"
+#import "AMPKPrefetchController.h"
+#import "AMPKSimulatedWebViews.h"
+#import "AMPKViewer.h"
+#import "AMPKViewerDataSource.h"
+#import "AMPKViewerMetrics.h"
+#import "AMPKViewerTraceRecorder.h"
+#import "AMPKWebViewerViewController.h"
+#import "AMPKWebViewerViewController_private.h"
+#import "AMPKWebViewerViewController_simulation.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+static const NSTimeInterval kDefaultLoadTime = 1.0;
+static NSString *const kViewerDomain = @"https://www.google.com";
+
+@implementation AMPKTraceSimulationResult
+@end
+
+@interface AMPKTraceSimulator () <AMPKPrefetchProvider>
+@end
+
+@implementation AMPKTraceSimulator {
+  // Per replay.
+  AMPKPrefetchController *_prefetchController;
+  AMPKWebViewerViewController *_swipeTarget;
+  BOOL _onScreen;
+  NSUInteger _feeds;
+  NSTimeInterval _blankTime;
+}
+
+- (instancetype)init {
+  self = [super init];
+  if (self) {
+    _loadTime = kDefaultLoadTime;
+    AMPKViewerDataSource *dataSource =
+        [[AMPKViewerDataSource alloc] initWithDomainName:[NSURL URLWithString:kViewerDomain]];
+    _maxLoadedViewControllers = dataSource.maxLoadedViewControllers;
+    _inactiveViewerTimeout = dataSource.inactiveViewerTimeout;
+    _stagedLoadTimeout = dataSource.stagedLoadTimeout;
+  }
+  return self;
+}
+
+- (AMPKTraceSimulationResult *)replayEvents:(NSArray<NSDictionary<NSString *, id> *> *)events {
+  AMPKSimulatedWebViews *webViews = [[AMPKSimulatedWebViews alloc] initWithLoadTime:_loadTime];
+  [AMPKSimulatedWebViews setCurrent:webViews];
+  _swipeTarget = nil;
+  _feeds = 0;
+  _blankTime = 0;
+  // A trace that starts by bringing the viewer on screen was recorded with it off screen.
+  _onScreen = YES;
+  for (NSDictionary<NSString *, id> *event in events) {
+    NSString *type = event[AMPKTraceKeyType];
+    if ([type isEqualToString:AMPKTraceEventForeground] ||
+        [type isEqualToString:AMPKTraceEventBackground]) {
+      _onScreen = [type isEqualToString:AMPKTraceEventBackground];
+      break;
+    }
+  }
+
+  AMPKViewerMetrics *metrics;
+  @autoreleasepool {
+    _prefetchController = [[AMPKPrefetchController alloc] init];
+    _prefetchController.prefetchProvider = self;
+    for (NSDictionary<NSString *, id> *event in events) {
+      [self advanceTo:[event[AMPKTraceKeyTime] doubleValue] webViews:webViews];
+      [self replayEvent:event];
+      [[self pageOnScreen] markSimulatedArticleShown];
+    }
+    metrics = _prefetchController.ampViewController.viewerDataSource.metrics;
+    // Tearing the viewer down settles the loads still in flight.
+    _swipeTarget = nil;
+    _prefetchController = nil;
+  }
+  [AMPKSimulatedWebViews setCurrent:nil];
+
+  AMPKTraceSimulationResult *result = [[AMPKTraceSimulationResult alloc] init];
+  result.loadsIssued = webViews.loadsIssued;
+  result.wastedLoads = webViews.wastedLoads;
+  result.blankTime = _blankTime;
+  result.peakLiveWebViews = webViews.peakLiveWebViews;
+  result.hiddenRunningTime = webViews.hiddenRunningTime;
+  result.timeToVisibleMedian = [metrics timeToVisibleAtPercentile:50];
+  result.timeToVisibleP90 = [metrics timeToVisibleAtPercentile:90];
+  return result;
+}
+
+#pragma mark - AMPKPrefetchProvider
+
+- (AMPKViewerDataSource *)defaultDataSource {
+  AMPKViewerDataSource *dataSource =
+      [[AMPKViewerDataSource alloc] initWithDomainName:[NSURL URLWithString:kViewerDomain]];
+  dataSource.maxLoadedViewControllers = _maxLoadedViewControllers;
+  dataSource.inactiveViewerTimeout = _inactiveViewerTimeout;
+  dataSource.stagedLoadTimeout = _stagedLoadTimeout;
+  dataSource.loadScheduler.clock = ^NSTimeInterval {
+    return [AMPKSimulatedWebViews current].now;
+  };
+  return dataSource;
+}
+
+#pragma mark - Private
+
+// The article the reader is looking at: the one being swiped to, or else the current one.
+- (nullable AMPKWebViewerViewController *)pageOnScreen {
+  if (!_onScreen) {
+    return nil;
+  }
+  return _swipeTarget ?: _prefetchController.ampViewController.currentAmpWebViewerController;
+}
+
+// Moves simulated time forward, adding however much of it the page on screen spent loading. Steps
+// through the loads that complete and the staged loads that become due on the way, since either
+// can start more loads.
+- (void)advanceTo:(NSTimeInterval)time webViews:(AMPKSimulatedWebViews *)webViews {
+  AMPKLoadScheduler *scheduler =
+      _prefetchController.ampViewController.viewerDataSource.loadScheduler;
+  while (webViews.now < time) {
+    NSTimeInterval step = time;
+    if (webViews.nextLoadCompletionTime > webViews.now) {
+      step = MIN(step, webViews.nextLoadCompletionTime);
+    }
+    if (scheduler.nextDueTime > webViews.now) {
+      step = MIN(step, scheduler.nextDueTime);
+    }
+    AMPKWebViewerViewController *page = [self pageOnScreen];
+    if (page && !page.isRevealed) {
+      _blankTime += step - webViews.now;
+    }
+    webViews.now = step;
+    [scheduler startDueLoads];
+  }
+}
+
+- (void)replayEvent:(NSDictionary<NSString *, id> *)event {
+  NSString *type = event[AMPKTraceKeyType];
+  NSInteger index = [event[AMPKTraceKeyIndex] integerValue];
+  AMPKViewer *viewer = _prefetchController.ampViewController;
+
+  if ([type isEqualToString:AMPKTraceEventFeed]) {
+    NSUInteger feed = _feeds++;
+    NSUInteger count = [event[AMPKTraceKeyCount] unsignedIntegerValue];
+    NSMutableArray<AMPKArticle *> *articles = [NSMutableArray arrayWithCapacity:count];
+    for (NSUInteger i = 0; i < count; i++) {
+      NSString *url = [NSString stringWithFormat:@"https://www.example.com/feed-%lu/story-%lu.html",
+                                                 (unsigned long)feed, (unsigned long)i];
+      [articles addObject:[AMPKArticle articleWithURL:[NSURL URLWithString:url]]];
+    }
+    _swipeTarget = nil;
+    [viewer.viewerDataSource setAmpArticles:articles usingHeaders:nil];
+  } else if ([type isEqualToString:AMPKTraceEventJump]) {
+    _swipeTarget = nil;
+    [_prefetchController updatePrefetchIndex:index];
+  } else if ([type isEqualToString:AMPKTraceEventSwipeBegin]) {
+    AMPKWebViewerViewController *target = viewer.viewerDataSource[index];
+    if (target) {
+      _swipeTarget = target;
+      [viewer pageViewController:viewer willTransitionToViewControllers:@[ target ]];
+    }
+  } else if ([type isEqualToString:AMPKTraceEventSwipeEnd]) {
+    AMPKWebViewerViewController *target = _swipeTarget;
+    _swipeTarget = nil;
+    if (!target) {
+      return;
+    }
+    BOOL completed = [event[AMPKTraceKeyCompleted] boolValue];
+    AMPKWebViewerViewController *previous = viewer.currentAmpWebViewerController;
+    if (completed) {
+      // UIPageViewController has already moved to the new page when it reports the transition.
+      [viewer setViewControllers:@[ target ]
+                       direction:UIPageViewControllerNavigationDirectionForward
+                        animated:NO
+                      completion:nil];
+    }
+    [viewer pageViewController:viewer
+            didFinishAnimating:YES
+       previousViewControllers:previous ? @[ previous ] : @[]
+           transitionCompleted:completed];
+  } else if ([type isEqualToString:AMPKTraceEventBackground]) {
+    _swipeTarget = nil;
+    _onScreen = NO;
+    [viewer viewDidDisappear:NO];
+  } else if ([type isEqualToString:AMPKTraceEventForeground]) {
+    _onScreen = YES;
+    [viewer viewWillAppear:NO];
+  }
+}
+
+@end
+
+NS_ASSUME_NONNULL_END
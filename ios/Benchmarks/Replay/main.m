@@ -0,0 +1,137 @@
+/**
+ * Copyright 2020 The AMP HTML Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS-IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Replays viewer traces recorded by AMPKViewerTraceRecorder:
+//
+//   AMPKitTraceReplay [--load-time=<seconds>,...] [--pool-size=<views>,...]
+//       [--inactive-timeout=<seconds>,...] [--stage-timeout=<seconds>,...] [--json=<path>]
+//       <trace>...
+//
+// Every trace is replayed once per combination of load time, pool size, inactive timeout and
+// stage timeout.
+
+#import <Foundation/Foundation.h>
+
+#import "AMPKTraceSimulator.h"
+#import "AMPKViewerTraceRecorder.h"
+
+static NSArray<NSNumber *> *AMPKParseList(NSString *list) {
+  NSMutableArray<NSNumber *> *values = [NSMutableArray array];
+  for (NSString *value in [list componentsSeparatedByString:@","]) {
+    if (value.length) {
+      [values addObject:@([value doubleValue])];
+    }
+  }
+  return values;
+}
+
+int main(int argc, const char *argv[]) {
+  @autoreleasepool {
+    AMPKTraceSimulator *defaults = [[AMPKTraceSimulator alloc] init];
+    NSArray<NSNumber *> *loadTimes = @[ @(defaults.loadTime) ];
+    NSArray<NSNumber *> *poolSizes = @[ @(defaults.maxLoadedViewControllers) ];
+    NSArray<NSNumber *> *inactiveTimeouts = @[ @(defaults.inactiveViewerTimeout) ];
+    NSArray<NSNumber *> *stageTimeouts = @[ @(defaults.stagedLoadTimeout) ];
+    NSString *jsonPath = nil;
+    NSMutableArray<NSString *> *tracePaths = [NSMutableArray array];
+    NSArray<NSString *> *arguments = [[NSProcessInfo processInfo] arguments];
+    for (NSString *argument in [arguments subarrayWithRange:NSMakeRange(1, arguments.count - 1)]) {
+      if ([argument hasPrefix:@"--load-time="]) {
+        loadTimes = AMPKParseList([argument substringFromIndex:@"--load-time=".length]);
+      } else if ([argument hasPrefix:@"--pool-size="]) {
+        poolSizes = AMPKParseList([argument substringFromIndex:@"--pool-size=".length]);
+      } else if ([argument hasPrefix:@"--inactive-timeout="]) {
+        inactiveTimeouts =
+            AMPKParseList([argument substringFromIndex:@"--inactive-timeout=".length]);
+      } else if ([argument hasPrefix:@"--stage-timeout="]) {
+        stageTimeouts = AMPKParseList([argument substringFromIndex:@"--stage-timeout=".length]);
+      } else if ([argument hasPrefix:@"--json="]) {
+        jsonPath = [argument substringFromIndex:@"--json=".length];
+      } else {
+        [tracePaths addObject:argument];
+      }
+    }
+    if (tracePaths.count == 0) {
+      fprintf(stderr, "usage: AMPKitTraceReplay [--load-time=<seconds>,...] "
+                      "[--pool-size=<views>,...] [--inactive-timeout=<seconds>,...] "
+                      "[--stage-timeout=<seconds>,...] [--json=<path>] <trace>...\n");
+      return 2;
+    }
+
+    printf("%-30s %9s %5s %8s %9s %7s %7s %10s %10s %10s %8s %8s\n", "trace", "load (s)", "pool",
+           "idle (s)", "stage (s)", "loads", "wasted", "blank (s)", "peak views", "hidden (s)",
+           "ttv p50", "ttv p90");
+    NSMutableArray<NSDictionary *> *results = [NSMutableArray array];
+    for (NSString *path in tracePaths) {
+      NSData *data = [NSData dataWithContentsOfFile:path];
+      NSError *error = nil;
+      NSArray *events =
+          data ? [AMPKViewerTraceRecorder eventsFromTraceData:data error:&error] : nil;
+      if (!events) {
+        fprintf(stderr, "Could not read %s: %s\n", path.UTF8String,
+                error.localizedDescription.UTF8String ?: "no such file");
+        return 1;
+      }
+      for (NSNumber *loadTime in loadTimes) {
+        for (NSNumber *poolSize in poolSizes) {
+          for (NSNumber *inactiveTimeout in inactiveTimeouts) {
+            for (NSNumber *stageTimeout in stageTimeouts) {
+              AMPKTraceSimulator *simulator = [[AMPKTraceSimulator alloc] init];
+              simulator.loadTime = loadTime.doubleValue;
+              simulator.maxLoadedViewControllers = poolSize.integerValue;
+              simulator.inactiveViewerTimeout = inactiveTimeout.doubleValue;
+              simulator.stagedLoadTimeout = stageTimeout.doubleValue;
+              AMPKTraceSimulationResult *result = [simulator replayEvents:events];
+              NSString *name = path.lastPathComponent;
+              printf("%-30s %9.2f %5ld %8.2f %9.2f %7lu %7lu %10.2f %10lu %10.2f %8.2f %8.2f\n",
+                     name.UTF8String, loadTime.doubleValue, (long)poolSize.integerValue,
+                     inactiveTimeout.doubleValue, stageTimeout.doubleValue,
+                     (unsigned long)result.loadsIssued, (unsigned long)result.wastedLoads,
+                     result.blankTime, (unsigned long)result.peakLiveWebViews,
+                     result.hiddenRunningTime, result.timeToVisibleMedian,
+                     result.timeToVisibleP90);
+              [results addObject:@{
+                @"trace" : name,
+                @"load_time" : loadTime,
+                @"pool_size" : poolSize,
+                @"inactive_timeout" : inactiveTimeout,
+                @"stage_timeout" : stageTimeout,
+                @"loads" : @(result.loadsIssued),
+                @"wasted_loads" : @(result.wastedLoads),
+                @"blank_time" : @(result.blankTime),
+                @"peak_web_views" : @(result.peakLiveWebViews),
+                @"hidden_running_time" : @(result.hiddenRunningTime),
+                @"time_to_visible_p50" : @(result.timeToVisibleMedian),
+                @"time_to_visible_p90" : @(result.timeToVisibleP90),
+              }];
+            }
+          }
+        }
+      }
+    }
+
+    if (jsonPath.length) {
+      NSData *json = [NSJSONSerialization dataWithJSONObject:results
+                                                     options:NSJSONWritingPrettyPrinted
+                                                       error:nil];
+      if (![json writeToFile:jsonPath atomically:YES]) {
+        fprintf(stderr, "Could not write %s\n", jsonPath.UTF8String);
+        return 1;
+      }
+    }
+    return 0;
+  }
+}
@@ -0,0 +1,77 @@
+/**
+ * Copyright 2020 The AMP HTML Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS-IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * Simulated time and accounting for the stub AMPKWebViewerViewController. While one is current,
+ * every stub web viewer takes loadTime to load an article and reports its web views and loads here.
+ */
+@interface AMPKSimulatedWebViews : NSObject
+
+/** The simulation stub web viewers report to, if any. */
++ (nullable AMPKSimulatedWebViews *)current;
++ (void)setCurrent:(nullable AMPKSimulatedWebViews *)current;
+
+/**
+ * The simulated time in seconds. Only ever moves forward; moving it completes the loads that
+ * finish on the way, in order.
+ */
+@property(nonatomic) NSTimeInterval now;
+
+/**
+ * How long every article takes to load with the network to itself. Loads in flight at the same
+ * time share it equally, so two take twice as long.
+ */
+@property(nonatomic, readonly) NSTimeInterval loadTime;
+
+/** When the next load in flight completes if no other load starts, or 0 if none is in flight. */
+@property(nonatomic, readonly) NSTimeInterval nextLoadCompletionTime;
+
+/** Articles loaded into a web view. */
+@property(nonatomic, readonly) NSUInteger loadsIssued;
+
+/** Loads that were unloaded or replaced without the article ever being shown. */
+@property(nonatomic, readonly) NSUInteger wastedLoads;
+
+/** Web views currently alive, and the most alive at once. */
+@property(nonatomic, readonly) NSUInteger liveWebViews;
+@property(nonatomic, readonly) NSUInteger peakLiveWebViews;
+
+/**
+ * Total time pages spent running in web views that weren't on screen, i.e. neither visible nor
+ * paused. Stands in for the CPU and energy those web views use.
+ */
+@property(nonatomic, readonly) NSTimeInterval hiddenRunningTime;
+
+- (instancetype)initWithLoadTime:(NSTimeInterval)loadTime NS_DESIGNATED_INITIALIZER;
+- (instancetype)init NS_UNAVAILABLE;
+
+/** Called by the stub web viewers. */
+- (void)webViewCreated;
+- (void)webViewDestroyed;
+- (void)loadStarted;
+/** Returns a token for cancelLoad:. @c completion is called as now moves past the load's end. */
+- (id)startLoadWithCompletion:(dispatch_block_t)completion;
+- (void)cancelLoad:(id)load;
+- (void)loadEndedAfterBeingShown:(BOOL)shown;
+- (void)addHiddenRunningTime:(NSTimeInterval)time;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,130 @@
+/**
+ * Copyright 2020 The AMP HTML Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS-IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#import "AMPKSimulatedWebViews.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+static AMPKSimulatedWebViews *gCurrentSimulatedWebViews;
+
+// A load in flight.
+@interface AMPKSimulatedLoad : NSObject
+// Seconds of the whole network it still needs.
+@property(nonatomic) NSTimeInterval remaining;
+@property(nonatomic, copy) dispatch_block_t completion;
+@end
+
+@implementation AMPKSimulatedLoad
+@end
+
+@implementation AMPKSimulatedWebViews {
+  NSMutableArray<AMPKSimulatedLoad *> *_loads;
+}
+
++ (nullable AMPKSimulatedWebViews *)current {
+  return gCurrentSimulatedWebViews;
+}
+
++ (void)setCurrent:(nullable AMPKSimulatedWebViews *)current {
+  gCurrentSimulatedWebViews = current;
+}
+
+- (instancetype)initWithLoadTime:(NSTimeInterval)loadTime {
+  self = [super init];
+  if (self) {
+    _loadTime = loadTime;
+    _loads = [[NSMutableArray alloc] init];
+  }
+  return self;
+}
+
+- (void)setNow:(NSTimeInterval)now {
+  while (_loads.count && self.nextLoadCompletionTime <= now) {
+    AMPKSimulatedLoad *next = [self nextLoadToComplete];
+    [self progressLoadsTo:self.nextLoadCompletionTime];
+    [_loads removeObjectIdenticalTo:next];
+    // May start or cancel other loads.
+    next.completion();
+  }
+  [self progressLoadsTo:now];
+}
+
+- (NSTimeInterval)nextLoadCompletionTime {
+  AMPKSimulatedLoad *next = [self nextLoadToComplete];
+  return next ? _now + next.remaining * _loads.count : 0;
+}
+
+- (id)startLoadWithCompletion:(dispatch_block_t)completion {
+  AMPKSimulatedLoad *load = [[AMPKSimulatedLoad alloc] init];
+  load.remaining = _loadTime;
+  load.completion = completion;
+  [_loads addObject:load];
+  return load;
+}
+
+- (void)cancelLoad:(id)load {
+  [_loads removeObjectIdenticalTo:load];
+}
+
+- (void)webViewCreated {
+  _liveWebViews++;
+  _peakLiveWebViews = MAX(_peakLiveWebViews, _liveWebViews);
+}
+
+- (void)webViewDestroyed {
+  _liveWebViews--;
+}
+
+- (void)loadStarted {
+  _loadsIssued++;
+}
+
+- (void)loadEndedAfterBeingShown:(BOOL)shown {
+  if (!shown) {
+    _wastedLoads++;
+  }
+}
+
+- (void)addHiddenRunningTime:(NSTimeInterval)time {
+  _hiddenRunningTime += time;
+}
+
+#pragma mark - Private
+
+- (nullable AMPKSimulatedLoad *)nextLoadToComplete {
+  AMPKSimulatedLoad *next = nil;
+  for (AMPKSimulatedLoad *load in _loads) {
+    if (!next || load.remaining < next.remaining) {
+      next = load;
+    }
+  }
+  return next;
+}
+
+// Moves time forward with the loads in flight sharing the network.
+- (void)progressLoadsTo:(NSTimeInterval)time {
+  if (time <= _now) {
+    return;
+  }
+  for (AMPKSimulatedLoad *load in _loads) {
+    load.remaining = MAX(load.remaining - (time - _now) / _loads.count, 0);
+  }
+  _now = time;
+}
+
+@end
+
+NS_ASSUME_NONNULL_END
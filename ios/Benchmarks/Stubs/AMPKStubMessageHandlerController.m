@@ -0,0 +1,44 @@
+/**
+ * Copyright 2020 The AMP HTML Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS-IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#import "AMPKWebViewerMessageHandlerController.h"
+
+#import "AMPKWebViewerJsMessage.h"
+
+// Stands in for the WebKit backed AMPKWebViewerMessageHandlerController in the benchmarks.
+// Messages are encoded as they would be for the web view, then dropped.
+@implementation AMPKWebViewerMessageHandlerController
+
+- (void)sendAmpJsMessage:(AMPKWebViewerJsMessage *)message {
+  (void)[message jsonString];
+}
+
+- (void)sendVisible:(BOOL)visible {
+}
+
+- (void)sendPrefetched {
+}
+
+- (void)sendPaused {
+}
+
+- (void)forwardBroadcast:(AMPKWebViewerJsMessage *)broadcast {
+}
+
+- (void)cancelPendingMessages {
+}
+
+@end
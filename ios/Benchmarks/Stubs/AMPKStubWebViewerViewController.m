@@ -0,0 +1,281 @@
+/**
+ * Copyright 2020 The AMP HTML Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS-IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#import "AMPKWebViewerViewController.h"
+#import "AMPKWebViewerViewController_private.h"
+#import "AMPKWebViewerViewController_simulation.h"
+
+#import "AMPKSimulatedWebViews.h"
+#import "AMPKViewer.h"
+#import "AMPKWebViewerLifecycle.h"
+#import "AMPKWebViewerMessageHandlerController.h"
+#import "NSURL+AMPK.h"
+
+// Stands in for the WKWebView backed AMPKWebViewerViewController in the benchmarks and the trace
+// simulator. There is no web view: loading an article records it and, when a simulation is
+// running, reports the load and the web view's lifetime to it. The article is revealed when the
+// simulated load completes. When it is visible, paused or reloaded is decided by the same
+// AMPKWebViewerLifecycle as the real view controller's.
+@interface AMPKWebViewerViewController () <AMPKWebViewerLifecycleDelegate>
+@end
+
+@implementation AMPKWebViewerViewController {
+  NSURL *_domainName;
+  AMPKWebViewerLifecycle *_lifecycle;
+  UIScrollView *_webScrollView;
+  BOOL _simulatedArticleShown;
+  // The simulated load in flight, if any.
+  id _simulatedLoad;
+  // When the page last started running while hidden, or -1 if it is visible, paused or blank.
+  NSTimeInterval _runningHiddenSince;
+}
+
+- (instancetype)initWithDomainName:(NSURL *)domainName {
+  self = [super init];
+  if (self) {
+    _domainName = [domainName copy];
+    _messageHandlerController = [[AMPKWebViewerMessageHandlerController alloc] init];
+    _messageHandlerController.ampWebViewerController = self;
+    _lifecycle = [[AMPKWebViewerLifecycle alloc] init];
+    _lifecycle.delegate = self;
+    _runningHiddenSince = -1;
+  }
+  return self;
+}
+
+- (void)dealloc {
+  [_lifecycle cancelScheduledPause];
+  [self endSimulatedLoad];
+  [self settleRunningHiddenTime];
+  if (_webScrollView) {
+    [[AMPKSimulatedWebViews current] webViewDestroyed];
+  }
+}
+
+- (void)viewDidLoad {
+  [super viewDidLoad];
+
+  // The real view controller creates its web view here.
+  _webScrollView = [[UIScrollView alloc] init];
+  [[AMPKSimulatedWebViews current] webViewCreated];
+}
+
+- (UIScrollView *)webScrollView {
+  return _webScrollView;
+}
+
+- (BOOL)visible {
+  return _lifecycle.visible;
+}
+
+- (void)setVisible:(BOOL)visible {
+  [_lifecycle setVisible:visible];
+  self.view.hidden = !_lifecycle.visible && !self.viewer.isPrefetched;
+}
+
+- (BOOL)isPaused {
+  return _lifecycle.paused;
+}
+
+- (void)pause {
+  [_lifecycle pause];
+}
+
+- (NSTimeInterval)inactiveTimeout {
+  return _lifecycle.inactiveTimeout;
+}
+
+- (void)setInactiveTimeout:(NSTimeInterval)inactiveTimeout {
+  _lifecycle.inactiveTimeout = inactiveTimeout;
+}
+
+- (BOOL)isWebContentTerminated {
+  return _lifecycle.webContentTerminated;
+}
+
+- (void)setTerminationHandler:(nullable void (^)(AMPKWebViewerViewController *))terminationHandler {
+  _terminationHandler = [terminationHandler copy];
+  _lifecycle.reloadsWhenVisible = !_terminationHandler;
+}
+
+- (void)loadAmpArticle:(id<AMPKArticleProtocol>)article
+           withHeaders:(nullable NSDictionary<NSString *, NSString *> *)headers {
+  NSURL *proxiedURL = article.cdnURL ?: [article.publisherURL ampk_ProxiedURL];
+  [self loadAmpArticle:article
+           withHeaders:headers
+            proxiedURL:proxiedURL
+               loadURL:[proxiedURL URLBySettingProxyHashFragmentsForDomain:_domainName]];
+}
+
+- (void)loadAmpArticle:(id<AMPKArticleProtocol>)article
+           withHeaders:(nullable NSDictionary<NSString *, NSString *> *)headers
+            proxiedURL:(NSURL *)proxiedURL
+               loadURL:(NSURL *)loadURL {
+  if ([self.article.publisherURL isEqual:article.publisherURL]) {
+    return;
+  }
+
+  [self endSimulatedLoad];
+  _article = [article copyWithZone:nil];
+  _webURL = loadURL;
+  ((void)([self view]));  // Force to load view.
+  [_lifecycle articleWillLoad];
+  [self startSimulatedLoad];
+}
+
+- (void)reloadAfterWebContentTermination {
+  [_lifecycle reloadAfterWebContentTermination];
+}
+
+- (void)webContentProcessDidTerminate {
+  [self endSimulatedLoad];
+  _ampJsReady = NO;
+  [_lifecycle webContentProcessDidTerminate];
+  if (_terminationHandler) {
+    _terminationHandler(self);
+  }
+}
+
+- (void)prepareForReuse {
+  [self endSimulatedLoad];
+  _article = nil;
+  _webURL = nil;
+  _ampJsReady = NO;
+  _viewerDataSourceIndex = NSNotFound;
+  [_lifecycle cancelScheduledPause];
+  _viewerContentOffset = CGPointMake(0, 0);
+  _presenter = nil;
+  _delegate = nil;
+}
+
+- (void)startSimulatedLoad {
+  _ampJsReady = NO;
+  AMPKSimulatedWebViews *simulation = [AMPKSimulatedWebViews current];
+  [simulation loadStarted];
+  __weak AMPKWebViewerViewController *weakSelf = self;
+  _simulatedLoad = [simulation startLoadWithCompletion:^{
+    [weakSelf simulatedLoadDidComplete];
+  }];
+  _simulatedArticleShown = NO;
+}
+
+- (void)simulatedLoadDidComplete {
+  _simulatedLoad = nil;
+  _revealed = YES;
+  if (_revealHandler) {
+    _revealHandler(self);
+  }
+}
+
+- (void)markSimulatedArticleShown {
+  _simulatedArticleShown = YES;
+}
+
+- (BOOL)webViewerLifecycleIsPrefetched:(AMPKWebViewerLifecycle *)lifecycle {
+  return self.viewer.isPrefetched;
+}
+
+- (void)webViewerLifecycle:(AMPKWebViewerLifecycle *)lifecycle
+    didEnterVisibilityState:(AMPKVisibilityState)visibilityState {
+}
+
+- (void)webViewerLifecycleNeedsReload:(AMPKWebViewerLifecycle *)lifecycle {
+  if (_article) {
+    [self startSimulatedLoad];
+  }
+}
+
+// Starts or stops counting the time the page runs while hidden. A prefetched page is about to be
+// shown, and prepareForReuse doesn't stop it: the article keeps running until the next one
+// replaces it.
+- (void)webViewerLifecycleDidChange:(AMPKWebViewerLifecycle *)lifecycle {
+  BOOL runningHidden = _article && !lifecycle.webContentTerminated &&
+      lifecycle.visibilityState == AMPKVisibilityStateHidden;
+  if (!runningHidden) {
+    [self settleRunningHiddenTime];
+  } else if (_runningHiddenSince < 0) {
+    _runningHiddenSince = [AMPKSimulatedWebViews current].now;
+  }
+}
+
+// Reports how long the page ran while hidden. The lifecycle's pause timer never fires in simulated
+// time, so the time is cut off where inactiveTimeout would have paused it.
+- (void)settleRunningHiddenTime {
+  if (_runningHiddenSince < 0) {
+    return;
+  }
+  AMPKSimulatedWebViews *simulation = [AMPKSimulatedWebViews current];
+  NSTimeInterval running = simulation.now - _runningHiddenSince;
+  if (_lifecycle.inactiveTimeout > 0) {
+    running = MIN(running, _lifecycle.inactiveTimeout);
+  }
+  [simulation addHiddenRunningTime:running];
+  _runningHiddenSince = -1;
+}
+
+- (void)endSimulatedLoad {
+  // A terminated page's load ended when it was terminated.
+  if (_article && !_lifecycle.webContentTerminated) {
+    [[AMPKSimulatedWebViews current] loadEndedAfterBeingShown:_simulatedArticleShown];
+  }
+  if (_simulatedLoad) {
+    [[AMPKSimulatedWebViews current] cancelLoad:_simulatedLoad];
+    _simulatedLoad = nil;
+  }
+  _revealed = NO;
+}
+
+- (BOOL)checkCanGoForward {
+  return NO;
+}
+
+- (BOOL)goForwardIfPossible {
+  return NO;
+}
+
+- (BOOL)checkCanGoBack {
+  return NO;
+}
+
+- (BOOL)goBackIfPossible {
+  return NO;
+}
+
+- (void)channelOpenWithMessage:(AMPKWebViewerJsMessage *)message {
+  _ampJsReady = YES;
+}
+
+- (BOOL)shouldBlockFrameRequest:(NSURLRequest *)request {
+  return NO;
+}
+
+- (void)AMPDocumentLoadedWithMessage:(AMPKWebViewerJsMessage *)message {
+}
+
+- (void)shadowDocumentFailedWithMessage:(AMPKWebViewerJsMessage *)message {
+}
+
+- (void)requestFullOverlayMode {
+}
+
+- (void)cancelFullOverlayMode {
+}
+
+- (void)paywallAccessCompletionWithToken:(NSString *)respondToken
+                               requestId:(NSString *)requestId {
+}
+
+@end
@@ -0,0 +1,29 @@
+/**
+ * Copyright 2020 The AMP HTML Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS-IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#import "AMPKWebViewerViewController.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/** What the stub web viewer exposes to the trace simulator. */
+@interface AMPKWebViewerViewController ()
+
+/** Records that the current article was on screen, so its load wasn't wasted. */
+- (void)markSimulatedArticleShown;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,166 @@
+/**
+ * Copyright 2020 The AMP HTML Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS-IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#import <UIKit/UIKit.h>
+#import <WebKit/WebKit.h>
+
+@implementation NSValue (UIKitStub)
+
++ (NSValue *)valueWithCGPoint:(CGPoint)point {
+  return [NSValue valueWithBytes:&point objCType:@encode(CGPoint)];
+}
+
+- (CGPoint)CGPointValue {
+  CGPoint point;
+  [self getValue:&point];
+  return point;
+}
+
+@end
+
+@implementation UIColor
+
++ (UIColor *)whiteColor {
+  return [[UIColor alloc] init];
+}
+
+@end
+
+@implementation UIResponder
+@end
+
+@implementation UIView {
+  NSMutableArray<UIView *> *_subviews;
+}
+
+- (instancetype)init {
+  self = [super init];
+  if (self) {
+    _subviews = [[NSMutableArray alloc] init];
+  }
+  return self;
+}
+
+- (NSArray<UIView *> *)subviews {
+  return [_subviews copy];
+}
+
+- (nullable UIWindow *)window {
+  return nil;
+}
+
+- (void)insertSubview:(UIView *)view atIndex:(NSInteger)index {
+  [view removeFromSuperview];
+  [_subviews insertObject:view atIndex:MIN((NSUInteger)MAX(index, 0), _subviews.count)];
+  view->_superview = self;
+}
+
+- (void)addSubview:(UIView *)view {
+  [self insertSubview:view atIndex:(NSInteger)_subviews.count];
+}
+
+- (void)removeFromSuperview {
+  UIView *superview = _superview;
+  if (superview) {
+    [superview->_subviews removeObject:self];
+  }
+  _superview = nil;
+}
+
+@end
+
+@implementation UIWindow
+@end
+
+@implementation UIScrollView
+@end
+
+@implementation UIViewController {
+  UIView *_view;
+}
+
+- (UIView *)view {
+  if (!_view) {
+    _view = [[UIView alloc] init];
+    [self viewDidLoad];
+  }
+  return _view;
+}
+
+- (void)setView:(nullable UIView *)view {
+  _view = view;
+}
+
+- (BOOL)isViewLoaded {
+  return _view != nil;
+}
+
+- (void)viewDidLoad {
+}
+
+- (void)viewWillAppear:(BOOL)animated {
+}
+
+- (void)viewDidDisappear:(BOOL)animated {
+}
+
+- (void)encodeRestorableStateWithCoder:(NSCoder *)coder {
+}
+
+- (void)decodeRestorableStateWithCoder:(NSCoder *)coder {
+}
+
+@end
+
+@implementation UIPageViewController
+
+- (instancetype)
+    initWithTransitionStyle:(UIPageViewControllerTransitionStyle)style
+      navigationOrientation:(UIPageViewControllerNavigationOrientation)navigationOrientation
+                    options:(nullable NSDictionary<NSString *, id> *)options {
+  return [super init];
+}
+
+- (void)setViewControllers:(nullable NSArray<UIViewController *> *)viewControllers
+                 direction:(UIPageViewControllerNavigationDirection)direction
+                  animated:(BOOL)animated
+                completion:(void (^_Nullable)(BOOL finished))completion {
+  _viewControllers = [viewControllers copy];
+  if (completion) {
+    completion(YES);
+  }
+}
+
+@end
+
+@implementation WKWebView
+@end
+
+@implementation WKScriptMessage
+
+- (instancetype)initWithName:(NSString *)name body:(id)body {
+  self = [super init];
+  if (self) {
+    _name = [name copy];
+    _body = body;
+  }
+  return self;
+}
+
+@end
+
+@implementation WKUserContentController
+@end
@@ -0,0 +1,145 @@
+/**
+ * Copyright 2020 The AMP HTML Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS-IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// The parts of UIKit that AMPKit's Foundation-only core refers to, so it can be built for the
+// benchmarks without UIKit, e.g. with GNUstep on Linux. Nothing here is functional.
+
+#import <Foundation/Foundation.h>
+
+#if defined(__APPLE__)
+#import <CoreGraphics/CoreGraphics.h>
+#else
+// GNUstep's Foundation may already define CGFloat.
+#ifndef CGFLOAT_DEFINED
+#define CGFLOAT_DEFINED 1
+typedef double CGFloat;
+#endif
+
+typedef struct CGPoint {
+  CGFloat x;
+  CGFloat y;
+} CGPoint;
+
+static inline CGPoint CGPointMake(CGFloat x, CGFloat y) {
+  CGPoint point;
+  point.x = x;
+  point.y = y;
+  return point;
+}
+#endif
+
+NS_ASSUME_NONNULL_BEGIN
+
+@interface NSValue (UIKitStub)
++ (NSValue *)valueWithCGPoint:(CGPoint)point;
+- (CGPoint)CGPointValue;
+@end
+
+#ifndef NS_REQUIRES_SUPER
+#define NS_REQUIRES_SUPER
+#endif
+
+typedef NS_ENUM(NSInteger, UIPageViewControllerTransitionStyle) {
+  UIPageViewControllerTransitionStylePageCurl = 0,
+  UIPageViewControllerTransitionStyleScroll = 1
+};
+
+typedef NS_ENUM(NSInteger, UIPageViewControllerNavigationOrientation) {
+  UIPageViewControllerNavigationOrientationHorizontal = 0,
+  UIPageViewControllerNavigationOrientationVertical = 1
+};
+
+typedef NS_ENUM(NSInteger, UIPageViewControllerNavigationDirection) {
+  UIPageViewControllerNavigationDirectionForward,
+  UIPageViewControllerNavigationDirectionReverse
+};
+
+typedef NS_ENUM(NSInteger, UIAccessibilityScrollDirection) {
+  UIAccessibilityScrollDirectionRight = 1,
+  UIAccessibilityScrollDirectionLeft,
+  UIAccessibilityScrollDirectionUp,
+  UIAccessibilityScrollDirectionDown,
+  UIAccessibilityScrollDirectionNext,
+  UIAccessibilityScrollDirectionPrevious
+};
+
+@class UIWindow;
+
+@interface UIColor : NSObject
++ (UIColor *)whiteColor;
+@end
+
+@interface UIResponder : NSObject
+@end
+
+// Views keep their subviews so code that inserts views into the hierarchy behaves as it would on a
+// device, but no view is ever in a window.
+@interface UIView : UIResponder
+@property(nonatomic, getter=isHidden) BOOL hidden;
+@property(nonatomic, copy, nullable) UIColor *backgroundColor;
+@property(nonatomic, readonly, copy) NSArray<UIView *> *subviews;
+@property(nonatomic, weak, readonly, nullable) UIView *superview;
+@property(nonatomic, readonly, nullable) UIWindow *window;
+- (void)insertSubview:(UIView *)view atIndex:(NSInteger)index;
+- (void)addSubview:(UIView *)view;
+- (void)removeFromSuperview;
+@end
+
+@interface UIWindow : UIView
+@end
+
+@interface UIScrollView : UIView
+@property(nonatomic) CGPoint contentOffset;
+@property(nonatomic, getter=isScrollEnabled) BOOL scrollEnabled;
+@property(nonatomic) BOOL scrollsToTop;
+@end
+
+// The view is created on first access, which calls -viewDidLoad, as UIKit does.
+@interface UIViewController : UIResponder
+@property(nonatomic, null_resettable) UIView *view;
+@property(nonatomic, readonly, getter=isViewLoaded) BOOL viewLoaded;
+@property(nonatomic, copy, nullable) NSString *title;
+- (void)viewDidLoad;
+- (void)viewWillAppear:(BOOL)animated;
+- (void)viewDidDisappear:(BOOL)animated;
+- (void)encodeRestorableStateWithCoder:(NSCoder *)coder;
+- (void)decodeRestorableStateWithCoder:(NSCoder *)coder;
+@end
+
+@protocol UIPageViewControllerDataSource;
+@protocol UIPageViewControllerDelegate;
+
+@interface UIPageViewController : UIViewController
+@property(nonatomic, weak, nullable) id<UIPageViewControllerDataSource> dataSource;
+@property(nonatomic, weak, nullable) id<UIPageViewControllerDelegate> delegate;
+@property(nonatomic, readonly, nullable) NSArray<UIViewController *> *viewControllers;
+- (instancetype)
+    initWithTransitionStyle:(UIPageViewControllerTransitionStyle)style
+      navigationOrientation:(UIPageViewControllerNavigationOrientation)navigationOrientation
+                    options:(nullable NSDictionary<NSString *, id> *)options;
+- (void)setViewControllers:(nullable NSArray<UIViewController *> *)viewControllers
+                 direction:(UIPageViewControllerNavigationDirection)direction
+                  animated:(BOOL)animated
+                completion:(void (^_Nullable)(BOOL finished))completion;
+@end
+
+@protocol UIPageViewControllerDataSource <NSObject>
+@end
+
+@protocol UIPageViewControllerDelegate <NSObject>
+@end
+
+NS_ASSUME_NONNULL_END
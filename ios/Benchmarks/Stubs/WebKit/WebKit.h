@@ -0,0 +1,43 @@
+/**
+ * Copyright 2020 The AMP HTML Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS-IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// The parts of WebKit that AMPKit's Foundation-only core refers to, so it can be built for the
+// benchmarks without WebKit. WKScriptMessage can be created with any body to feed the message
+// decoding code.
+
+#import <Foundation/Foundation.h>
+
+@class WKUserContentController;
+
+@interface WKWebView : NSObject
+@end
+
+@interface WKScriptMessage : NSObject
+@property(nonatomic, readonly) id body;
+@property(nonatomic, readonly, copy) NSString *name;
+
+/** Only exists in the stub. */
+- (instancetype)initWithName:(NSString *)name body:(id)body;
+@end
+
+@interface WKUserContentController : NSObject
+@end
+
+@protocol WKScriptMessageHandler <NSObject>
+@end
+
+@protocol WKNavigationDelegate <NSObject>
+@end
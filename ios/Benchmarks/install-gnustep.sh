@@ -0,0 +1,44 @@
+#!/bin/sh
+# Builds and installs, under /usr/local, the GNUstep the benchmarks need on Linux: the libobjc2
+# runtime, which unlike GCC's libobjc that distributions package GNUstep with supports ARC and
+# blocks, libdispatch for AMPKFeedIngestor, gnustep-make and gnustep-base, all with clang.
+# Needs clang, cmake, git, and the development packages of libffi, gnutls, ICU and libxml2.
+set -e
+
+LIBOBJC2_VERSION=v2.1
+LIBDISPATCH_VERSION=swift-5.9-RELEASE
+MAKE_VERSION=make-2_9_1
+BASE_VERSION=base-1_29_0
+
+export CC=clang
+export CXX=clang++
+
+SOURCES=$(mktemp -d)
+cd "$SOURCES"
+
+git clone --quiet --depth 1 --recursive --branch $LIBOBJC2_VERSION \
+  https://github.com/gnustep/libobjc2.git
+cmake -S libobjc2 -B libobjc2/build -DCMAKE_BUILD_TYPE=Release -DTESTS=OFF
+cmake --build libobjc2/build
+sudo cmake --install libobjc2/build
+
+# libdispatch uses the blocks runtime built into libobjc2 rather than bringing its own.
+git clone --quiet --depth 1 --branch $LIBDISPATCH_VERSION \
+  https://github.com/apple/swift-corelibs-libdispatch.git
+cmake -S swift-corelibs-libdispatch -B swift-corelibs-libdispatch/build \
+  -DCMAKE_BUILD_TYPE=Release -DBUILD_TESTING=OFF -DINSTALL_PRIVATE_HEADERS=YES \
+  -DBlocksRuntime_INCLUDE_DIR=/usr/local/include \
+  -DBlocksRuntime_LIBRARIES=/usr/local/lib/libobjc.so
+cmake --build swift-corelibs-libdispatch/build
+sudo cmake --install swift-corelibs-libdispatch/build
+sudo ldconfig
+
+git clone --quiet --depth 1 --branch $MAKE_VERSION https://github.com/gnustep/tools-make.git
+(cd tools-make &&
+  ./configure --with-library-combo=ng-gnu-gnu --with-runtime-abi=gnustep-2.0 &&
+  sudo make install)
+
+. "$(gnustep-config --variable=GNUSTEP_MAKEFILES)/GNUstep.sh"
+git clone --quiet --depth 1 --branch $BASE_VERSION https://github.com/gnustep/libs-base.git
+(cd libs-base && ./configure && make -j"$(nproc)" && sudo -E make install)
+sudo ldconfig
@@ -0,0 +1,156 @@
+/**
+ * Copyright 2020 The AMP HTML Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS-IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+import { benchmark, getServerPort } from "../harness";
+
+const ITERATIONS = 20;
+
+/** Ad slots on the fixture page, each with a creative and tracking frames. */
+const AD_SLOTS = 8;
+const TRACKING_FRAMES_PER_AD = 2;
+/** Analytics frames at the top of the fixture page. */
+const ANALYTICS_FRAMES = 4;
+
+/**
+ * @param {string} html
+ * @return {string} an iframe showing html.
+ */
+function frame(html) {
+  const escaped = html.replace(/&/g, "&amp;").replace(/"/g, "&quot;");
+  return '<iframe srcdoc="' + escaped + '"></iframe>';
+}
+
+/**
+ * An article shaped like an ad-heavy AMP Doc: analytics frames, and ad
+ * slots whose frames nest a creative and tracking pixels.
+ * @return {string}
+ */
+function adHeavyPage() {
+  let body = "<h1>Benchmark article</h1>";
+  for (let i = 0; i < ANALYTICS_FRAMES; i++) {
+    body += frame("<p>analytics " + i + "</p>");
+  }
+  for (let i = 0; i < AD_SLOTS; i++) {
+    let ad = frame("<p>creative " + i + "</p>");
+    for (let j = 0; j < TRACKING_FRAMES_PER_AD; j++) {
+      ad += frame("<p>pixel " + j + "</p>");
+    }
+    body += "<p>Paragraph " + i + " of the benchmark article.</p>" + frame(ad);
+  }
+  return "<!doctype html><html><head></head><body>" + body + "</body></html>";
+}
+
+/**
+ * @param {!Window} win
+ * @return {!Array<!Window>} win and every frame nested in it.
+ */
+function allFrames(win) {
+  const frames = [win];
+  for (let i = 0; i < win.frames.length; i++) {
+    frames.push.apply(frames, allFrames(win.frames[i]));
+  }
+  return frames;
+}
+
+/**
+ * @param {string} name of a script in ios/AMPKit/Resources.
+ * @return {!Promise<string>}
+ */
+function fetchIntegrationScript(name) {
+  const url = "http://localhost:" + getServerPort() + "/ampkit/" + name + ".js";
+  return fetch(url).then(response => response.text());
+}
+
+/**
+ * Loads the fixture page and runs source in the frames AMPKit's user script
+ * would be injected into, the way WKUserScript does at document start.
+ * @param {!Element} host
+ * @param {string} source
+ * @param {boolean} mainFrameOnly
+ * @return {!Promise<{duration: number, frames: number}>} the time spent
+ *   parsing and running the script in all those frames, in ms.
+ */
+function injectIntoFixture(host, source, mainFrameOnly) {
+  const iframe = document.createElement("iframe");
+  iframe.srcdoc = adHeavyPage();
+  return new Promise(resolve => {
+    iframe.onload = () => {
+      const frames = mainFrameOnly
+        ? [iframe.contentWindow]
+        : allFrames(iframe.contentWindow);
+      let duration = 0;
+      frames.forEach(win => {
+        const script = win.document.createElement("script");
+        script.textContent = source;
+        const start = performance.now();
+        win.document.head.appendChild(script);
+        duration += performance.now() - start;
+      });
+      host.removeChild(iframe);
+      resolve({ duration, frames: frames.length });
+    };
+    host.appendChild(iframe);
+  });
+}
+
+describe("AMPKit integration script benchmarks", function() {
+  this.timeout(120000);
+
+  let host;
+
+  before(() => {
+    host = document.createElement("div");
+    document.body.appendChild(host);
+  });
+
+  after(() => {
+    document.body.removeChild(host);
+  });
+
+  // iOS AMPKit used to inject the Closure build into every frame, and now
+  // injects the modern build into the AMP Doc's main frame only. The fixture
+  // isn't served from the cache, so the modern build stops right after its
+  // origin check; what is measured for it is mostly parsing.
+  [
+    { name: "legacy-all-frames", script: "amp_integration", allFrames: true },
+    { name: "legacy-main-frame", script: "amp_integration", allFrames: false },
+    {
+      name: "modern-main-frame",
+      script: "amp_integration_modern",
+      allFrames: false
+    }
+  ].forEach(variant => {
+    it("ad-heavy page: " + variant.name, () => {
+      let frames = 0;
+      const injectOnce = source =>
+        injectIntoFixture(host, source, !variant.allFrames).then(result => {
+          frames = result.frames;
+          return result.duration;
+        });
+      return fetchIntegrationScript(variant.script)
+        .then(source =>
+          benchmark("ampkit-script-" + variant.name, ITERATIONS, () =>
+            injectOnce(source)
+          )
+        )
+        .then(() =>
+          benchmark("ampkit-frames-" + variant.name, 1, () =>
+            Promise.resolve(frames)
+          )
+        );
+    });
+  });
+});
@@ -0,0 +1,51 @@
+/**
+ * Copyright 2020 The AMP HTML Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS-IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+import { FrameBatcher } from "../../src/frame-batcher";
+import { benchmark } from "../harness";
+
+const ITERATIONS = 20;
+const MESSAGES = 10000;
+
+describe("Frame batching benchmarks", function() {
+  this.timeout(60000);
+
+  it("handles a burst of scroll messages and delivers the next frame", () => {
+    return benchmark("scroll-burst", ITERATIONS, () => {
+      const batcher = new FrameBatcher(window);
+      let delivered = 0;
+      batcher.subscribe("scroll", () => delivered++);
+      const messages = [];
+      for (let i = 0; i < MESSAGES; i++) {
+        messages.push({ scrollTop: i });
+      }
+      const start = performance.now();
+      for (let i = 0; i < MESSAGES; i++) {
+        batcher.push("scroll", messages[i]);
+      }
+      const duration = performance.now() - start;
+      return new Promise(resolve => requestAnimationFrame(resolve)).then(
+        () => {
+          if (delivered != 1) {
+            throw new Error("Delivered " + delivered + " times in a frame");
+          }
+          return duration;
+        }
+      );
+    });
+  });
+});
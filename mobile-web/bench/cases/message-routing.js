@@ -0,0 +1,69 @@
+/**
+ * Copyright 2020 The AMP HTML Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS-IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+import { MessageRouter } from "../../src/message-router";
+import { benchmark } from "../harness";
+
+const ITERATIONS = 20;
+const MESSAGES = 1000;
+const ORIGIN = "https://www-example-com.cdn.ampproject.org";
+
+describe("Message routing benchmarks", function() {
+  this.timeout(60000);
+
+  /**
+   * Times delivering MESSAGES window messages from one of viewers iframes,
+   * each with a handler on the page's router, like viewers waiting for their
+   * handshake or talking over the window.
+   */
+  function routeMessages(name, viewers) {
+    return benchmark(name, ITERATIONS, () => {
+      const router = MessageRouter.forWindow(window);
+      const iframes = [];
+      const unlisteners = [];
+      let delivered = 0;
+      for (let i = 0; i < viewers; i++) {
+        const iframe = document.createElement("iframe");
+        document.body.appendChild(iframe);
+        iframes.push(iframe);
+        unlisteners.push(router.listen(iframe, ORIGIN, () => delivered++));
+      }
+      const source = iframes[viewers - 1].contentWindow;
+      const start = performance.now();
+      for (let i = 0; i < MESSAGES; i++) {
+        window.dispatchEvent(
+          new MessageEvent("message", { data: i, origin: ORIGIN, source })
+        );
+      }
+      const duration = performance.now() - start;
+      unlisteners.forEach(unlisten => unlisten());
+      iframes.forEach(iframe => document.body.removeChild(iframe));
+      if (delivered != MESSAGES) {
+        throw new Error("Delivered " + delivered + " of " + MESSAGES);
+      }
+      return Promise.resolve(duration);
+    });
+  }
+
+  it("routes messages with one viewer on the page", () => {
+    return routeMessages("message-routing-1-viewer", 1);
+  });
+
+  it("routes messages with 16 viewers on the page", () => {
+    return routeMessages("message-routing-16-viewers", 16);
+  });
+});
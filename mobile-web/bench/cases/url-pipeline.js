@@ -0,0 +1,76 @@
+/**
+ * Copyright 2020 The AMP HTML Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS-IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+import { benchmark } from "../harness";
+import { constructViewerCacheUrl } from "../../src/amp-url-creator";
+import { parseUrl } from "../../utils/url";
+
+const ITERATIONS = 20;
+const FEED_SIZE = 200;
+
+describe("Cache url pipeline benchmarks", function() {
+  this.timeout(60000);
+
+  const initParams = {
+    origin: "http://localhost:9876",
+    cap: "history,handshakepoll"
+  };
+
+  function feed(iteration, hosts) {
+    const urls = [];
+    for (let i = 0; i < FEED_SIZE; i++) {
+      urls.push(
+        "https://www.site-" +
+          iteration +
+          "-" +
+          (i % hosts) +
+          ".example/article-" +
+          i +
+          ".html"
+      );
+    }
+    return urls;
+  }
+
+  it("builds viewer cache urls for a feed on distinct hosts", () => {
+    return benchmark("cache-urls-cold-hosts", ITERATIONS, i => {
+      const urls = feed(i, FEED_SIZE);
+      const start = performance.now();
+      return Promise.all(
+        urls.map(url => constructViewerCacheUrl(url, initParams))
+      ).then(() => performance.now() - start);
+    });
+  });
+
+  it("builds viewer cache urls for a feed on a few hosts", () => {
+    return benchmark("cache-urls-shared-hosts", ITERATIONS, i => {
+      const urls = feed(i, 5);
+      const start = performance.now();
+      return Promise.all(
+        urls.map(url => constructViewerCacheUrl(url, initParams))
+      ).then(() => performance.now() - start);
+    });
+  });
+
+  it("parses urls", () => {
+    return benchmark("parse-url", ITERATIONS, i => {
+      const urls = feed(i, FEED_SIZE);
+      const start = performance.now();
+      urls.forEach(url => parseUrl(url));
+      return Promise.resolve(performance.now() - start);
+    });
+  });
+});
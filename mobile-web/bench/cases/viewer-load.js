@@ -0,0 +1,143 @@
+/**
+ * Copyright 2020 The AMP HTML Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS-IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+import {Viewer} from "../../src/viewer";
+import {
+  benchmark,
+  delay,
+  disposeViewer,
+  getServerPort,
+  whenMarked
+} from "../harness";
+
+const ITERATIONS = 20;
+
+/** Publisher urls the stand-in cache answers for. */
+function articleUrl(i, opt_query) {
+  return (
+    "https://www.example.com/article-" +
+    i +
+    ".html" +
+    (opt_query ? "?" + opt_query : "")
+  );
+}
+
+describe("Viewer load benchmarks", function() {
+  this.timeout(120000);
+
+  let host;
+
+  before(() => {
+    Viewer.setCacheUrlAuthority("http://localhost:" + getServerPort());
+    host = document.createElement("div");
+    document.body.appendChild(host);
+  });
+
+  after(() => {
+    document.body.removeChild(host);
+  });
+
+  it("single open: attach to documentLoaded", () => {
+    return benchmark("single-open", ITERATIONS, i => {
+      const viewer = new Viewer(host, articleUrl(i));
+      viewer.attach();
+      return whenMarked(viewer, "documentLoaded").then(() => {
+        const performance = viewer.getPerformance();
+        const duration =
+          performance.getMark("documentLoaded") -
+          performance.getMark("attachStart");
+        disposeViewer(viewer);
+        return duration;
+      });
+    });
+  });
+
+  it("single open on a slow network: attach to documentLoaded", () => {
+    return benchmark("single-open-slow", ITERATIONS, i => {
+      const viewer = new Viewer(
+        host,
+        articleUrl(i, "latency=150&bandwidth=50000")
+      );
+      viewer.attach();
+      return whenMarked(viewer, "documentLoaded").then(() => {
+        const performance = viewer.getPerformance();
+        const duration =
+          performance.getMark("documentLoaded") -
+          performance.getMark("attachStart");
+        disposeViewer(viewer);
+        return duration;
+      });
+    });
+  });
+
+  it("prerender to visible: tap to documentLoaded", () => {
+    // The user taps a little while after the prerender started, which may
+    // or may not be enough for it to finish.
+    return benchmark("prerender-to-visible", ITERATIONS, i => {
+      const viewer = new Viewer(
+        host,
+        articleUrl(i, "latency=100"),
+        undefined,
+        true /* opt_prerender */
+      );
+      viewer.attach();
+      return delay(150)
+        .then(() => {
+          viewer.setVisibilityState("visible");
+          return whenMarked(viewer, "documentLoaded");
+        })
+        .then(() => {
+          const performance = viewer.getPerformance();
+          const duration = Math.max(
+            0,
+            performance.getMark("documentLoaded") -
+              performance.getMark("visible")
+          );
+          disposeViewer(viewer);
+          return duration;
+        });
+    });
+  });
+
+  it("rapid successive opens: last attach to documentLoaded", () => {
+    const OPENS = 5;
+    return benchmark("rapid-opens", ITERATIONS, i => {
+      let last = null;
+      let opens = Promise.resolve();
+      for (let j = 0; j < OPENS; j++) {
+        opens = opens
+          .then(() => {
+            if (last) {
+              disposeViewer(last);
+            }
+            last = new Viewer(host, articleUrl(i * OPENS + j));
+            last.attach();
+          })
+          .then(() => delay(j == OPENS - 1 ? 0 : 30));
+      }
+      return opens
+        .then(() => whenMarked(last, "documentLoaded"))
+        .then(() => {
+          const performance = last.getPerformance();
+          const duration =
+            performance.getMark("documentLoaded") -
+            performance.getMark("attachStart");
+          disposeViewer(last);
+          return duration;
+        });
+    });
+  });
+});
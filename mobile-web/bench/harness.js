@@ -0,0 +1,92 @@
+/**
+ * Copyright 2020 The AMP HTML Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS-IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+import {Viewer} from '../src/viewer';
+import {onViewerTiming} from '../src/viewer-performance';
+
+/** @const {string} Prefix of the console lines the bench reporter reads. */
+export const BENCH_RESULT_PREFIX = 'BENCH_RESULT ';
+
+/**
+ * @return {number} the port of the AMP cache stand-in, from the karma config.
+ */
+export function getServerPort() {
+  return window.__karma__.config.benchServerPort;
+}
+
+/**
+ * Runs sample() iterations times, one after the other, and reports the
+ * samples to the bench reporter, which turns them into percentiles.
+ * @param {string} name
+ * @param {number} iterations
+ * @param {function(number):!Promise<number>} sample resolves with the time
+ *   one iteration took, in ms.
+ * @return {!Promise<!Array<number>>}
+ */
+export function benchmark(name, iterations, sample) {
+  const samples = [];
+  let run = Promise.resolve();
+  for (let i = 0; i < iterations; i++) {
+    run = run.then(() => sample(i)).then(value => {
+      samples.push(value);
+    });
+  }
+  return run.then(() => {
+    console.log(BENCH_RESULT_PREFIX + JSON.stringify({name, samples}));
+    return samples;
+  });
+}
+
+/**
+ * @param {!Viewer} viewer
+ * @param {string} mark e.g. 'documentLoaded'.
+ * @return {!Promise<number>} resolves with the time of the mark.
+ */
+export function whenMarked(viewer, mark) {
+  const performance = viewer.getPerformance();
+  const time = performance.getMark(mark);
+  if (time !== undefined) {
+    return Promise.resolve(time);
+  }
+  return new Promise(resolve => {
+    const unlisten = onViewerTiming(timing => {
+      if (timing.viewerId == performance.viewerId && timing.type == 'mark' &&
+          timing.name == mark) {
+        unlisten();
+        resolve(timing.value);
+      }
+    });
+  });
+}
+
+/**
+ * Releases a viewer and removes its iframe.
+ * @param {!Viewer} viewer
+ */
+export function disposeViewer(viewer) {
+  const iframe = viewer.release();
+  if (iframe && iframe.parentNode) {
+    iframe.parentNode.removeChild(iframe);
+  }
+}
+
+/**
+ * @param {number} ms
+ * @return {!Promise}
+ */
+export function delay(ms) {
+  return new Promise(resolve => setTimeout(resolve, ms));
+}
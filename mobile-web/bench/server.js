@@ -0,0 +1,162 @@
+/**
+ * Copyright 2020 The AMP HTML Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS-IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * A local stand-in for the AMP cache, so viewer benchmarks don't depend on
+ * cdn.ampproject.org. It answers on any host, so CURLS-style hostnames such
+ * as www-example-com.localhost:8100 work without DNS setup, and serves:
+ *
+ *   /v/... and /c/...  a fixture AMP Doc, bench/fixtures/article.html.
+ *   /v0.js             a stub AMP runtime, bench/stub-runtime.js.
+ *   /ampkit/*.js       the integration scripts iOS AMPKit injects into its
+ *                      web views, from ios/AMPKit/Resources.
+ *
+ * Latency and bandwidth can be set for the whole server, or per AMP Doc with
+ * the latency (ms) and bandwidth (bytes per second) query parameters of the
+ * publisher url, which the cache url keeps.
+ *
+ * Usage: node bench/server.js [--port=8100] [--latency=0] [--bandwidth=0]
+ */
+
+const fs = require('fs');
+const http = require('http');
+const path = require('path');
+const url = require('url');
+
+/** @const {number} */
+const DEFAULT_PORT = 8100;
+
+/** @const {number} How often a throttled response writes a chunk, in ms. */
+const THROTTLE_INTERVAL = 50;
+
+const FIXTURE_DIR = path.join(__dirname, 'fixtures');
+
+const AMPKIT_RESOURCE_DIR =
+  path.join(__dirname, '..', '..', 'ios', 'AMPKit', 'Resources');
+
+/**
+ * @param {{
+ *   port: (number|undefined),
+ *   latency: (number|undefined),
+ *   bandwidth: (number|undefined),
+ * }=} opt_options latency in ms, bandwidth in bytes per second, 0 for none.
+ * @return {!Promise<!http.Server>} resolves once the server listens.
+ */
+function startServer(opt_options) {
+  const options = opt_options || {};
+  const defaults = {
+    latency: options.latency || 0,
+    bandwidth: options.bandwidth || 0,
+  };
+  const article = fs.readFileSync(path.join(FIXTURE_DIR, 'article.html'));
+  const runtime = fs.readFileSync(path.join(__dirname, 'stub-runtime.js'));
+
+  const server = http.createServer((request, response) => {
+    const parsed = url.parse(request.url, true);
+    const latency = Number(parsed.query.latency) || defaults.latency;
+    const bandwidth = Number(parsed.query.bandwidth) || defaults.bandwidth;
+
+    let body;
+    let contentType;
+    if (parsed.pathname == '/v0.js') {
+      body = runtime;
+      contentType = 'application/javascript';
+    } else if (/^\/[vc]\//.test(parsed.pathname)) {
+      body = article;
+      contentType = 'text/html; charset=utf-8';
+    } else if (/^\/ampkit\/[\w-]+\.js$/.test(parsed.pathname)) {
+      const file = path.join(AMPKIT_RESOURCE_DIR,
+        path.basename(parsed.pathname));
+      if (!fs.existsSync(file)) {
+        response.writeHead(404);
+        response.end();
+        return;
+      }
+      body = fs.readFileSync(file);
+      contentType = 'application/javascript';
+    } else {
+      response.writeHead(404);
+      response.end();
+      return;
+    }
+
+    setTimeout(() => {
+      response.writeHead(200, {
+        'Content-Type': contentType,
+        'Content-Length': body.length,
+        'Cache-Control': 'no-store',
+        'Access-Control-Allow-Origin': '*',
+      });
+      send(response, body, bandwidth);
+    }, latency);
+  });
+
+  return new Promise(resolve => {
+    server.listen(options.port || DEFAULT_PORT, () => resolve(server));
+  });
+}
+
+/**
+ * Writes body at no more than bandwidth bytes per second.
+ * @param {!http.ServerResponse} response
+ * @param {!Buffer} body
+ * @param {number} bandwidth 0 to write it all at once.
+ */
+function send(response, body, bandwidth) {
+  if (!bandwidth) {
+    response.end(body);
+    return;
+  }
+  const chunkSize = Math.max(1,
+    Math.floor(bandwidth * THROTTLE_INTERVAL / 1000));
+  let offset = 0;
+  const writeChunk = () => {
+    const chunk = body.slice(offset, offset + chunkSize);
+    offset += chunk.length;
+    if (offset >= body.length) {
+      response.end(chunk);
+    } else {
+      response.write(chunk);
+      setTimeout(writeChunk, THROTTLE_INTERVAL);
+    }
+  };
+  writeChunk();
+}
+
+/**
+ * @param {!Array<string>} args e.g. ['--port=8100'].
+ * @return {!Object<string, number>}
+ */
+function parseArgs(args) {
+  const options = {};
+  args.forEach(arg => {
+    const match = /^--(\w+)=(\d+)$/.exec(arg);
+    if (match) {
+      options[match[1]] = Number(match[2]);
+    }
+  });
+  return options;
+}
+
+if (require.main === module) {
+  const options = parseArgs(process.argv.slice(2));
+  startServer(options).then(server => {
+    console.log('AMP cache stand-in listening on port ' +
+      server.address().port);
+  });
+}
+
+module.exports = {startServer, DEFAULT_PORT};
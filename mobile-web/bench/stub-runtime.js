@@ -0,0 +1,149 @@
+/**
+ * Copyright 2020 The AMP HTML Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS-IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * A stub of the AMP runtime served by bench/server.js. It only speaks the
+ * viewer side of the messaging protocol: it opens the channel with
+ * channelOpen, reports documentLoaded (and prerenderComplete when
+ * prerendering) once the document has loaded, tracks visibilitychange, and
+ * answers every request that wants a response. Like the AMP runtime, it opens
+ * the channel on the first port the viewer offers when the viewer has the
+ * 'handshakepoll' capability, and on the window otherwise.
+ */
+(function() {
+  var APP = '__AMPHTML__';
+  var REQUEST = 'q';
+  var RESPONSE = 's';
+
+  var params = {};
+  location.hash.slice(1).split('&').forEach(function(pair) {
+    var parts = pair.split('=');
+    if (parts[0]) {
+      params[decodeURIComponent(parts[0])] =
+        decodeURIComponent(parts[1] || '');
+    }
+  });
+
+  var viewerOrigin = params['origin'];
+  var visibilityState = params['visibilityState'] || 'visible';
+  var handshakePoll =
+    (params['cap'] || '').split(',').indexOf('handshakepoll') != -1;
+  var nextRequestId = 1;
+  var handshakeRequestId = 0;
+  var channelOpen = false;
+  /** The port the viewer offered, once there is one. */
+  var port = null;
+
+  if (!viewerOrigin || window.parent == window) {
+    return;
+  }
+
+  function post(message) {
+    message.app = APP;
+    if (port) {
+      port./*OK*/postMessage(message);
+    } else {
+      window.parent./*OK*/postMessage(message, viewerOrigin);
+    }
+  }
+
+  function sendRequest(name, data, rsvp) {
+    var requestId = nextRequestId++;
+    post({
+      requestid: requestId,
+      type: REQUEST,
+      name: name,
+      data: data,
+      rsvp: rsvp,
+    });
+    return requestId;
+  }
+
+  function whenLoaded(callback) {
+    if (document.readyState == 'complete') {
+      callback();
+    } else {
+      window.addEventListener('load', callback);
+    }
+  }
+
+  function onChannelOpen() {
+    whenLoaded(function() {
+      sendRequest('documentLoaded', {
+        title: document.title,
+        sourceUrl: location.href,
+      }, false);
+      if (visibilityState == 'prerender') {
+        sendRequest('prerenderComplete', {}, false);
+      }
+    });
+  }
+
+  function receiveMessage(message) {
+    if (!message || message.app != APP) {
+      return;
+    }
+    if (message.type == RESPONSE) {
+      if (!channelOpen && message.requestid == handshakeRequestId) {
+        channelOpen = true;
+        onChannelOpen();
+      }
+      return;
+    }
+    if (message.name == 'visibilitychange' && message.data) {
+      visibilityState = message.data.state;
+    }
+    if (message.rsvp) {
+      post({
+        requestid: message.requestid,
+        type: RESPONSE,
+        name: message.name,
+        data: null,
+        rsvp: false,
+      });
+    }
+  }
+
+  function openChannel() {
+    handshakeRequestId = sendRequest('channelOpen', {
+      url: location.href,
+      sourceUrl: location.href,
+    }, true);
+  }
+
+  window.addEventListener('message', function(e) {
+    if (e.source != window.parent || e.origin != viewerOrigin) {
+      return;
+    }
+    var message = e.data;
+    if (handshakePoll && !port && message && message.app == APP &&
+        message.name == 'handshake-poll' && e.ports && e.ports[0]) {
+      port = e.ports[0];
+      port.onmessage = function(portEvent) {
+        receiveMessage(portEvent.data);
+      };
+      openChannel();
+      return;
+    }
+    if (!port) {
+      receiveMessage(message);
+    }
+  });
+
+  if (!handshakePoll) {
+    openChannel();
+  }
+})();
@@ -0,0 +1,142 @@
+/**
+ * Copyright 2020 The AMP HTML Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS-IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * Runs the benchmarks in bench/cases in headless Chrome against the local
+ * AMP cache stand-in (bench/server.js), and writes the percentiles of every
+ * benchmark to bench-results.json, or to the BENCH_RESULTS file.
+ */
+
+const fs = require("fs");
+const path = require("path");
+const { startServer } = require("./bench/server");
+
+const BENCH_SERVER_PORT = Number(process.env.BENCH_SERVER_PORT) || 8100;
+const BENCH_RESULT_PREFIX = "BENCH_RESULT ";
+const PERCENTILES = [50, 75, 90, 95, 99];
+
+/**
+ * Starts the AMP cache stand-in along with karma.
+ */
+function benchServerFramework() {
+  startServer({
+    port: BENCH_SERVER_PORT,
+    latency: Number(process.env.BENCH_LATENCY) || 0,
+    bandwidth: Number(process.env.BENCH_BANDWIDTH) || 0
+  }).then(server => {
+    process.on("exit", () => server.close());
+  });
+}
+
+/**
+ * @param {!Array<number>} sorted
+ * @param {number} p
+ * @return {number} the nearest-rank percentile.
+ */
+function percentile(sorted, p) {
+  const rank = Math.ceil((p / 100) * sorted.length);
+  return sorted[Math.min(sorted.length, Math.max(1, rank)) - 1];
+}
+
+/**
+ * Collects the samples the benchmarks log and writes their percentiles.
+ */
+function BenchReporter(config, logger) {
+  const log = logger.create("reporter.bench");
+  const results = {};
+
+  this.onBrowserLog = (browser, message) => {
+    const start = message.indexOf(BENCH_RESULT_PREFIX);
+    if (start == -1) {
+      return;
+    }
+    const json = message.slice(
+      start + BENCH_RESULT_PREFIX.length,
+      message.lastIndexOf("}") + 1
+    );
+    const result = JSON.parse(json);
+    const sorted = result.samples.slice().sort((a, b) => a - b);
+    const summary = {
+      browser: browser.name,
+      iterations: sorted.length,
+      mean: sorted.reduce((sum, value) => sum + value, 0) / sorted.length,
+      min: sorted[0],
+      max: sorted[sorted.length - 1]
+    };
+    PERCENTILES.forEach(p => {
+      summary["p" + p] = percentile(sorted, p);
+    });
+    results[result.name] = summary;
+  };
+
+  this.onRunComplete = () => {
+    const file = path.resolve(
+      config.basePath,
+      process.env.BENCH_RESULTS || "bench-results.json"
+    );
+    fs.writeFileSync(file, JSON.stringify(results, null, 2) + "\n");
+    log.info("Wrote " + Object.keys(results).length + " results to " + file);
+  };
+}
+
+BenchReporter.$inject = ["config", "logger"];
+
+module.exports = function(config) {
+  config.set({
+    files: ["bench/cases/**/*.js"],
+
+    frameworks: ["bench-server", "browserify", "mocha"],
+
+    preprocessors: {
+      "bench/**/*.js": ["browserify"]
+    },
+
+    browserify: {
+      debug: true,
+      transform: ["babelify"]
+    },
+
+    plugins: [
+      "karma-*",
+      { "framework:bench-server": ["factory", benchServerFramework] },
+      { "reporter:bench": ["type", BenchReporter] }
+    ],
+
+    reporters: ["progress", "bench"],
+
+    client: {
+      benchServerPort: BENCH_SERVER_PORT,
+      captureConsole: true,
+      mocha: {
+        timeout: 120000
+      }
+    },
+
+    port: 9877,
+    colors: true,
+    logLevel: "INFO",
+    browsers: ["ChromeHeadless_bench"],
+    singleRun: true,
+    browserNoActivityTimeout: 300000,
+
+    customLaunchers: {
+      ChromeHeadless_bench: {
+        base: "ChromeHeadless",
+        flags: ["--no-sandbox", "--disable-extensions"]
+      }
+    }
+  });
+};
@@ -37,13 +37,21 @@ const plugins = [
 ];
 
 export default [{
-  input: './src/viewer.js',
+  input: './src/index.js',
   output: {
     file: './dist/viewer.js',
     format: 'iife',
   },
   plugins,
 },
+{
+  input: './src/cache-url-worker.js',
+  output: {
+    file: './dist/cache-url-worker.js',
+    format: 'iife',
+  },
+  plugins,
+},
 {
   input: './ampkit/ampkit-url-creator.js',
   output: {
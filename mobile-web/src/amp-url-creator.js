@@ -27,6 +27,20 @@ const DEFAULT_CACHE_AUTHORITY_ = 'cdn.ampproject.org';
  */
 const DEFAULT_VIEWER_JS_VERSION_ = '0.1';
 
+/**
+ * The maximum number of CURLS subdomains to remember.
+ * @private {number}
+ */
+const CURLS_SUBDOMAIN_CACHE_SIZE_ = 200;
+
+/**
+ * Maps a publisher protocol and host to its pending or computed CURLS
+ * subdomain. Hashing the host is the expensive part of building a cache url
+ * and every article on the same host shares the result.
+ * @private {!Map<string, !Promise<string>>}
+ */
+const curlsSubdomainCache_ = new Map();
+
 /**
  * Constructs a Viewer cache url for native viers using these rules:
  * https://developers.google.com/amp/cache/overview
@@ -94,11 +108,12 @@ function constructViewerCacheUrlOptions(url, isNative, initParams,
   const ampJSVersion = isNative ? '' : 'amp_js_v=' + viewerJsVersion;
 
   const urlProtocolAndHost = parsedUrl.protocol + '//' + parsedUrl.host;
+  const cacheScheme = parseCacheUrlAuthority_(opt_cacheUrlAuthority).scheme;
 
   return new Promise(resolve => {
     constructCacheDomainUrl_(urlProtocolAndHost, opt_cacheUrlAuthority).then(cacheDomain => {
       resolve(
-        'https://' +
+        cacheScheme +
         cacheDomain + 
         pathType +
         protocolStr +
@@ -113,6 +128,44 @@ function constructViewerCacheUrlOptions(url, isNative, initParams,
   });
 }
 
+/**
+ * Constructs the origin a publisher url is served from by the cache. For
+ * example:
+ *
+ * Input url 'http://www.ampproject.org/foo'
+ * will return 'https://www-ampproject-org.cdn.ampproject.org'
+ *
+ * @param {string} url The complete publisher url.
+ * @param {string} opt_cacheUrlAuthority
+ * @return {!Promise<string>}
+ */
+export function constructCacheOrigin(url, opt_cacheUrlAuthority) {
+  const parsedUrl = parseUrl(url);
+  return constructCacheDomainUrl_(
+    parsedUrl.protocol + '//' + parsedUrl.host, opt_cacheUrlAuthority)
+    .then(cacheDomain =>
+      parseCacheUrlAuthority_(opt_cacheUrlAuthority).scheme + cacheDomain);
+}
+
+/**
+ * Constructs the url of the AMP runtime served by the cache. For example:
+ *
+ * 'https://cdn.ampproject.org/v0.js', or for runtime version '011912201807310'
+ * 'https://cdn.ampproject.org/rtv/011912201807310/v0.js'
+ *
+ * @param {string} opt_cacheUrlAuthority
+ * @param {string} opt_runtimeVersion the runtime version, the current one
+ *   when not given.
+ * @return {string}
+ */
+export function constructRuntimeUrl(opt_cacheUrlAuthority,
+    opt_runtimeVersion) {
+  const cache = parseCacheUrlAuthority_(opt_cacheUrlAuthority);
+  const versionPath = opt_runtimeVersion ?
+    '/rtv/' + encodeURIComponent(opt_runtimeVersion) : '';
+  return cache.scheme + cache.authority + versionPath + '/v0.js';
+}
+
 /**
  * Constructs a cache domain url. For example:
  * 
@@ -126,14 +179,51 @@ function constructViewerCacheUrlOptions(url, isNative, initParams,
  */
 function constructCacheDomainUrl_(url, opt_cacheUrlAuthority) {
   return new Promise(resolve => {
-    const cacheUrlAuthority = 
-      opt_cacheUrlAuthority ? opt_cacheUrlAuthority : DEFAULT_CACHE_AUTHORITY_;
-      ampToolboxCacheUrl.createCurlsSubdomain(url).then(curlsSubdomain => {
+    const cacheUrlAuthority =
+      parseCacheUrlAuthority_(opt_cacheUrlAuthority).authority;
+      createCurlsSubdomain_(url).then(curlsSubdomain => {
         resolve(curlsSubdomain + '.' + cacheUrlAuthority);
       });
   });
 }
 
+/**
+ * Splits a cache url authority into the scheme to reach it with and the
+ * authority itself. The scheme is https:// unless the authority names one,
+ * e.g. 'http://localhost:8100' for a local stand-in cache.
+ *
+ * @param {string} opt_cacheUrlAuthority
+ * @return {{scheme: string, authority: string}}
+ * @private
+ */
+function parseCacheUrlAuthority_(opt_cacheUrlAuthority) {
+  const cacheUrlAuthority =
+    opt_cacheUrlAuthority ? opt_cacheUrlAuthority : DEFAULT_CACHE_AUTHORITY_;
+  const match = /^(https?:\/\/)(.*)$/.exec(cacheUrlAuthority);
+  return match ? {scheme: match[1], authority: match[2]} :
+    {scheme: 'https://', authority: cacheUrlAuthority};
+}
+
+/**
+ * Memoized version of ampToolboxCacheUrl.createCurlsSubdomain.
+ * @param {string} url The publisher protocol and host.
+ * @return {!Promise<string>}
+ * @private
+ */
+function createCurlsSubdomain_(url) {
+  let curlsSubdomain = curlsSubdomainCache_.get(url);
+  if (!curlsSubdomain) {
+    if (curlsSubdomainCache_.size >= CURLS_SUBDOMAIN_CACHE_SIZE_) {
+      curlsSubdomainCache_.delete(curlsSubdomainCache_.keys().next().value);
+    }
+    curlsSubdomain = ampToolboxCacheUrl.createCurlsSubdomain(url);
+    curlsSubdomainCache_.set(url, curlsSubdomain);
+    // Don't remember failures, the next caller should get to retry.
+    curlsSubdomain.catch(() => curlsSubdomainCache_.delete(url));
+  }
+  return curlsSubdomain;
+}
+
 /**
  * Takes an object such as:
  * {
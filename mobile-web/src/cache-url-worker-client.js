@@ -0,0 +1,146 @@
+/**
+ * Copyright 2020 The AMP HTML Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS-IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+import {CONSTRUCT_VIEWER_CACHE_URLS_MSG} from './cache-url-worker';
+import {constructViewerCacheUrl} from './amp-url-creator';
+import {log} from '../utils/log';
+
+/** @const {string} The default location of the built worker script. */
+const DEFAULT_WORKER_URL = 'cache-url-worker.js';
+
+/**
+ * Builds viewer cache urls for a batch of publisher urls (e.g. a whole feed)
+ * in a Web Worker, so the CURLS hashing doesn't compete with the host page
+ * for the main thread. Falls back to building them on the main thread when
+ * Workers aren't available.
+ */
+export class CacheUrlWorkerClient {
+
+  /**
+   * @param {string=} opt_workerUrl url of the built cache-url-worker.js.
+   */
+  constructor(opt_workerUrl) {
+    /** @private {string} */
+    this.workerUrl_ = opt_workerUrl || DEFAULT_WORKER_URL;
+
+    /** @private {?Worker} */
+    this.worker_ = null;
+
+    /** @private {boolean} */
+    this.workerFailed_ = false;
+
+    /** @private {number} */
+    this.nextId_ = 0;
+
+    /**
+     * @private {!Object<number, {
+     *   resolve: function(!Array<?string>),
+     *   reject: function(*),
+     *   fallback: function():!Promise<!Array<?string>>
+     * }>}
+     */
+    this.pending_ = {};
+  }
+
+  /**
+   * @param {!Array<string>} urls The complete publisher urls.
+   * @param {object} initParams Params containing origin, etc.
+   * @param {string=} opt_cacheUrlAuthority
+   * @param {string=} opt_viewerJsVersion
+   * @return {!Promise<!Array<?string>>} the viewer cache urls in the same
+   *   order as urls, null for the ones that couldn't be built.
+   */
+  constructViewerCacheUrls(urls, initParams, opt_cacheUrlAuthority,
+      opt_viewerJsVersion) {
+    const buildOnMainThread = () => Promise.all(urls.map(url =>
+      constructViewerCacheUrl(url, initParams, opt_cacheUrlAuthority,
+        opt_viewerJsVersion).catch(() => null)));
+
+    const worker = this.getWorker_();
+    if (!worker) {
+      return buildOnMainThread();
+    }
+
+    const id = this.nextId_++;
+    return new Promise((resolve, reject) => {
+      this.pending_[id] = {resolve, reject, fallback: buildOnMainThread};
+      worker./*OK*/postMessage({
+        name: CONSTRUCT_VIEWER_CACHE_URLS_MSG,
+        id,
+        urls,
+        initParams,
+        cacheUrlAuthority: opt_cacheUrlAuthority,
+        viewerJsVersion: opt_viewerJsVersion,
+      });
+    });
+  }
+
+  /**
+   * Terminates the worker and rejects the requests it hasn't answered yet.
+   */
+  terminate() {
+    if (this.worker_) {
+      this.worker_.terminate();
+      this.worker_ = null;
+    }
+    const pending = this.pending_;
+    this.pending_ = {};
+    for (let id in pending) {
+      pending[id].reject(new Error('The cache url worker was terminated'));
+    }
+  }
+
+  /**
+   * @return {?Worker} the lazily created worker, null if unavailable.
+   * @private
+   */
+  getWorker_() {
+    if (this.worker_ || this.workerFailed_) {
+      return this.worker_;
+    }
+    if (typeof Worker == 'undefined') {
+      this.workerFailed_ = true;
+      return null;
+    }
+    try {
+      this.worker_ = new Worker(this.workerUrl_);
+    } catch (e) {
+      log('Unable to start the cache url worker', e);
+      this.workerFailed_ = true;
+      return null;
+    }
+    this.worker_.addEventListener('message', e => {
+      const request = this.pending_[e.data.id];
+      if (request) {
+        delete this.pending_[e.data.id];
+        request.resolve(e.data.cacheUrls);
+      }
+    });
+    // The worker script failed to load or crashed, finish what's pending on
+    // the main thread and don't try again.
+    this.worker_.addEventListener('error', e => {
+      log('The cache url worker failed', e);
+      const pending = this.pending_;
+      this.pending_ = {};
+      this.terminate();
+      this.workerFailed_ = true;
+      for (let id in pending) {
+        pending[id].fallback().then(pending[id].resolve);
+      }
+    });
+    return this.worker_;
+  }
+}
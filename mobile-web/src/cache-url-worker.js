@@ -0,0 +1,51 @@
+/**
+ * Copyright 2020 The AMP HTML Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS-IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+import {constructViewerCacheUrl} from './amp-url-creator';
+
+/**
+ * This file is the entry point of a Web Worker that builds viewer cache urls
+ * off the main thread. It answers 'constructViewerCacheUrls' requests with
+ * one cache url per publisher url, or null for urls that failed.
+ */
+
+/** @const {string} */
+export const CONSTRUCT_VIEWER_CACHE_URLS_MSG = 'constructViewerCacheUrls';
+
+/**
+ * @param {*} data A message sent to the worker.
+ * @return {?Promise<{id: number, cacheUrls: !Array<?string>}>} the reply to
+ *   a 'constructViewerCacheUrls' request, null for any other message.
+ */
+export function answerCacheUrlsRequest(data) {
+  if (!data || data.name != CONSTRUCT_VIEWER_CACHE_URLS_MSG) {
+    return null;
+  }
+  return Promise.all(data.urls.map(url =>
+    constructViewerCacheUrl(url, data.initParams, data.cacheUrlAuthority,
+      data.viewerJsVersion).catch(() => null)
+  )).then(cacheUrls => ({id: data.id, cacheUrls}));
+}
+
+if (typeof WorkerGlobalScope != 'undefined' &&
+    self instanceof WorkerGlobalScope) {
+  self.addEventListener('message', e => {
+    const reply = answerCacheUrlsRequest(e.data);
+    if (reply) {
+      reply.then(response => self./*OK*/postMessage(response));
+    }
+  });
+}
@@ -0,0 +1,128 @@
+/**
+ * Copyright 2020 The AMP HTML Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS-IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+import {constructCacheOrigin, constructRuntimeUrl} from './amp-url-creator';
+import {log} from '../utils/log';
+import {parseUrl} from '../utils/url';
+
+/** @const {number} How many origins are kept warm by default. */
+const DEFAULT_MAX_ORIGINS = 6;
+
+/**
+ * Opens connections to the cache origins of AMP Docs the user is likely to
+ * open, by adding preconnect and dns-prefetch hints to the document head.
+ * The connection is then ready by the time the AMP Doc iframe needs it.
+ * Only the most recently warmed origins keep their hints, since every
+ * preconnect holds a socket open.
+ */
+export class ConnectionWarmer {
+
+  /**
+   * @param {!Document=} opt_doc
+   * @param {number=} opt_maxOrigins
+   * @param {string=} opt_cacheUrlAuthority
+   */
+  constructor(opt_doc, opt_maxOrigins, opt_cacheUrlAuthority) {
+    /** @private {!Document} */
+    this.doc_ = opt_doc || document;
+
+    /** @private {number} */
+    this.maxOrigins_ = opt_maxOrigins || DEFAULT_MAX_ORIGINS;
+
+    /** @private {string|undefined} */
+    this.cacheUrlAuthority_ = opt_cacheUrlAuthority;
+
+    /**
+     * Hint elements by origin, least recently warmed first.
+     * @private {!Map<string, !Array<!Element>>}
+     */
+    this.hints_ = new Map();
+
+    /** @private {string} */
+    this.runtimeOrigin_ =
+      parseUrl(constructRuntimeUrl(opt_cacheUrlAuthority)).origin;
+  }
+
+  /**
+   * Warms the cache origins of the given publisher urls, and the origin the
+   * AMP runtime is served from.
+   * @param {!Array<string>} urls
+   * @return {!Promise} resolves once the hints are in place.
+   */
+  warm(urls) {
+    this.warmOrigin(this.runtimeOrigin_);
+    return Promise.all(urls.map(url => {
+      return constructCacheOrigin(url, this.cacheUrlAuthority_)
+        .then(origin => this.warmOrigin(origin))
+        .catch(error => log('could not warm', url, error));
+    }));
+  }
+
+  /**
+   * @param {string} origin
+   */
+  warmOrigin(origin) {
+    const hints = this.hints_.get(origin);
+    if (hints) {
+      // Already warm, just mark it as recently used.
+      this.hints_.delete(origin);
+      this.hints_.set(origin, hints);
+      return;
+    }
+    if (this.hints_.size >= this.maxOrigins_) {
+      this.coolOrigin_(this.hints_.keys().next().value);
+    }
+    this.hints_.set(origin, [
+      this.addHint_('preconnect', origin),
+      this.addHint_('dns-prefetch', origin),
+    ]);
+  }
+
+  /**
+   * @param {string} origin
+   * @return {boolean} true if origin has hints in place.
+   */
+  isWarm(origin) {
+    return this.hints_.has(origin);
+  }
+
+  /**
+   * @param {string} rel
+   * @param {string} origin
+   * @return {!Element}
+   * @private
+   */
+  addHint_(rel, origin) {
+    const link = this.doc_.createElement('link');
+    link.rel = rel;
+    link.href = origin;
+    this.doc_.head.appendChild(link);
+    return link;
+  }
+
+  /**
+   * @param {string} origin
+   * @private
+   */
+  coolOrigin_(origin) {
+    this.hints_.get(origin).forEach(link => {
+      if (link.parentNode) {
+        link.parentNode.removeChild(link);
+      }
+    });
+    this.hints_.delete(origin);
+  }
+}
@@ -0,0 +1,143 @@
+/**
+ * Copyright 2020 The AMP HTML Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS-IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * The latest value of one stream and who wants it.
+ * @typedef {{
+ *   name: string,
+ *   value: *,
+ *   dirty: boolean,
+ *   callbacks: !Array<function(*)>,
+ * }}
+ */
+let Stream;
+
+/**
+ * Coalesces values that arrive many times a frame, e.g. the scroll position
+ * of an AMP Doc, into one callback per animation frame with the latest value.
+ * Pushing a value allocates nothing and, for a stream nobody subscribed to,
+ * does nothing at all.
+ */
+export class FrameBatcher {
+
+  /**
+   * @param {!Window} win
+   */
+  constructor(win) {
+    /** @private {!Window} */
+    this.win_ = win;
+
+    /** @private {!Array<!Stream>} */
+    this.streams_ = [];
+
+    /** @private {number} */
+    this.frameId_ = 0;
+
+    /** @private @const {function()} */
+    this.flush_ = this.flush_.bind(this);
+  }
+
+  /**
+   * Calls callback with the latest value of stream once per animation frame
+   * in which values were pushed to it.
+   * @param {string} name
+   * @param {function(*)} callback
+   * @return {function()} unsubscribes the callback.
+   */
+  subscribe(name, callback) {
+    let stream = this.find_(name);
+    if (!stream) {
+      stream = {name, value: undefined, dirty: false, callbacks: []};
+      this.streams_.push(stream);
+    }
+    stream.callbacks.push(callback);
+    return () => {
+      const index = stream.callbacks.indexOf(callback);
+      if (index != -1) {
+        stream.callbacks.splice(index, 1);
+      }
+    };
+  }
+
+  /**
+   * Records the latest value of stream, to be delivered on the next frame.
+   * @param {string} name
+   * @param {*} value
+   */
+  push(name, value) {
+    const stream = this.find_(name);
+    if (!stream || !stream.callbacks.length) {
+      return;
+    }
+    stream.value = value;
+    stream.dirty = true;
+    if (!this.frameId_) {
+      this.frameId_ = this.win_.requestAnimationFrame(this.flush_);
+    }
+  }
+
+  /**
+   * Drops the values not delivered yet.
+   */
+  cancel() {
+    if (this.frameId_) {
+      this.win_.cancelAnimationFrame(this.frameId_);
+      this.frameId_ = 0;
+    }
+    for (let i = 0; i < this.streams_.length; i++) {
+      this.streams_[i].dirty = false;
+      this.streams_[i].value = undefined;
+    }
+  }
+
+  /**
+   * @private
+   */
+  flush_() {
+    this.frameId_ = 0;
+    for (let i = 0; i < this.streams_.length; i++) {
+      const stream = this.streams_[i];
+      if (!stream.dirty) {
+        continue;
+      }
+      const value = stream.value;
+      stream.dirty = false;
+      stream.value = undefined;
+      // A callback may unsubscribe, so walk a snapshot only when there are
+      // several.
+      const callbacks = stream.callbacks.length > 1 ?
+        stream.callbacks.slice() : stream.callbacks;
+      for (let j = 0; j < callbacks.length; j++) {
+        callbacks[j](value);
+      }
+    }
+  }
+
+  /**
+   * There are only ever a couple of streams, so they are simply scanned.
+   * @param {string} name
+   * @return {?Stream}
+   * @private
+   */
+  find_(name) {
+    for (let i = 0; i < this.streams_.length; i++) {
+      if (this.streams_[i].name == name) {
+        return this.streams_[i];
+      }
+    }
+    return null;
+  }
+}
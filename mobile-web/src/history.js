@@ -17,6 +17,88 @@
 import {log} from '../utils/log';
 import {parseUrl} from '../utils/url';
 
+/**
+ * Listens for popstate once for every History on the page. A history entry
+ * pushed by a History goes back to that History only; entries without an
+ * owner on the page, e.g. the host page's own, go to all of them.
+ */
+export class HistoryCoordinator {
+
+  constructor() {
+    /**
+     * Tells this page's ids from those in entries left by an earlier load of
+     * the page.
+     * @private @const {string}
+     */
+    this.idPrefix_ = Math.random().toString(36).slice(2) + ':';
+
+    /** @private {number} */
+    this.nextId_ = 1;
+
+    /** @private {!Map<string, !Function>} */
+    this.handlers_ = new Map();
+
+    /** @private {?function(!Event)} */
+    this.popStateListener_ = null;
+  }
+
+  /**
+   * @param {!Function} handleChangeHistoryState
+   * @return {string} the id to put in the history states of the caller.
+   */
+  register(handleChangeHistoryState) {
+    const id = this.idPrefix_ + this.nextId_++;
+    this.handlers_.set(id, handleChangeHistoryState);
+    if (!this.popStateListener_) {
+      this.popStateListener_ = this.handlePopState_.bind(this);
+      window.addEventListener('popstate', this.popStateListener_);
+    }
+    return id;
+  }
+
+  /**
+   * @param {string} id
+   */
+  unregister(id) {
+    this.handlers_.delete(id);
+    if (!this.handlers_.size && this.popStateListener_) {
+      window.removeEventListener('popstate', this.popStateListener_);
+      this.popStateListener_ = null;
+    }
+  }
+
+  /**
+   * @return {number} how many Histories are registered.
+   */
+  getHandlerCount() {
+    return this.handlers_.size;
+  }
+
+  /**
+   * @param {!Event} event
+   * @private
+   */
+  handlePopState_(event) {
+    const state = event.state;
+    const owner = state && this.handlers_.get(state.viewerHistoryId);
+    if (owner) {
+      owner(false /* isLastBack */, !!state.isAMP);
+      return;
+    }
+    // Copy the handlers, one may dispose its History while handling this.
+    Array.from(this.handlers_.values()).forEach(handler => {
+      if (!state) {
+        handler(true /* isLastBack */, false /* isAMP */);
+      } else {
+        handler(false /* isLastBack */, !!state.isAMP);
+      }
+    });
+  }
+}
+
+/** @const {!HistoryCoordinator} The coordinator of every History. */
+export const historyCoordinator = new HistoryCoordinator();
+
 /**
  * This file manages history for the Viewer.
  */
@@ -26,30 +108,18 @@ export class History {
    *  state changes.
    */
   constructor(handleChangeHistoryState) {
-    /** @private {!Function} */
-    this.handleChangeHistoryState_ = handleChangeHistoryState;
-
-    this.init_();
+    /** @private {?string} */
+    this.id_ = historyCoordinator.register(handleChangeHistoryState);
   }
 
   /**
-   * Init the onpopstate listener.
-   * @private
+   * Stops handling history state changes.
    */
-  init_() {
-    window.addEventListener('popstate', event => {
-      const state = event.state;
-      if (!state) {
-        this.handleChangeHistoryState_(
-          true /* isLastBack */, 
-          false /* isAMP */);
-        return;
-      }
-
-      this.handleChangeHistoryState_(
-        false /* isLastBack */, 
-        !!state.isAMP);
-    });
+  dispose() {
+    if (this.id_ !== null) {
+      historyCoordinator.unregister(this.id_);
+      this.id_ = null;
+    }
   }
 
   /**
@@ -59,7 +129,8 @@ export class History {
   pushState(url) {
     let stateData = {
       urlPath: url,
-      isAMP: true
+      isAMP: true,
+      viewerHistoryId: this.id_,
     };
 
     // The url should have /amp/ + url added to it. For example:
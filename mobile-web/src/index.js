@@ -0,0 +1,31 @@
+/**
+ * Copyright 2020 The AMP HTML Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS-IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+import {CacheUrlWorkerClient} from './cache-url-worker-client';
+import {LinkPrefetchController} from './link-prefetch-controller';
+import {Viewer} from './viewer';
+import {ViewerPool} from './viewer-pool';
+import {onViewerTiming} from './viewer-performance';
+
+/**
+ * This file is the entry point of dist/viewer.js. It exposes the viewer
+ * classes to the host page.
+ */
+window.Viewer = Viewer;
+window.ViewerPool = ViewerPool;
+window.CacheUrlWorkerClient = CacheUrlWorkerClient;
+window.LinkPrefetchController = LinkPrefetchController;
+window.onViewerTiming = onViewerTiming;
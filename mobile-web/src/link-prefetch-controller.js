@@ -0,0 +1,392 @@
+/**
+ * Copyright 2020 The AMP HTML Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS-IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+import {PrerenderBudget} from './prerender-budget';
+import {Viewer} from './viewer';
+import {VisibilityState} from './viewer-messaging';
+import {constructViewerCacheUrl} from './amp-url-creator';
+
+/** @const {string} How far outside the viewport links start being watched. */
+const DEFAULT_ROOT_MARGIN = '200px';
+
+/** @const {number} How long a link must stay near the viewport, in ms. */
+const DEFAULT_DWELL_TIME = 150;
+
+/**
+ * @typedef {{
+ *   rootMargin: (string|undefined),
+ *   dwellTime: (number|undefined),
+ *   referrer: (string|undefined),
+ *   prefetch: (boolean|undefined),
+ *   prerender: (boolean|undefined),
+ *   maxPrerenders: (number|undefined),
+ *   cacheUrlClient: (!CacheUrlWorkerClient|undefined),
+ *   getUrl: (function(!Element):?string|undefined),
+ * }}
+ */
+let LinkPrefetchOptions;
+
+/**
+ * Gets ahead of the user's taps on AMP links of the host page. As links come
+ * near the viewport it computes their viewer cache urls, warms the cache
+ * origins and prefetches the AMP Docs. The most visible link also gets a
+ * hidden prerendering Viewer, which is handed over as is when it's tapped.
+ * Work for links that scroll away is cancelled. This is the web counterpart
+ * of AMPKPrefetchController.
+ */
+export class LinkPrefetchController {
+
+  /**
+   * @param {!Element} hostElement the element viewers attach their iframe to.
+   * @param {!LinkPrefetchOptions=} opt_options
+   */
+  constructor(hostElement, opt_options) {
+    const options = opt_options || {};
+
+    /** @private {!Element} */
+    this.hostElement_ = hostElement;
+
+    /** @private {number} */
+    this.dwellTime_ = options.dwellTime === undefined ?
+      DEFAULT_DWELL_TIME : options.dwellTime;
+
+    /** @private {string|undefined} */
+    this.referrer_ = options.referrer;
+
+    /** @private {boolean} */
+    this.prefetch_ = options.prefetch !== false;
+
+    /** @private {boolean} */
+    this.prerender_ = options.prerender !== false;
+
+    /** @private {?CacheUrlWorkerClient} */
+    this.cacheUrlClient_ = options.cacheUrlClient || null;
+
+    /** @private {function(!Element):?string} */
+    this.getUrl_ = options.getUrl || (link =>
+      link.getAttribute('href') || link.getAttribute('url'));
+
+    /**
+     * The prerender budget of this controller's viewers, the page's shared
+     * one unless maxPrerenders is given.
+     * @private {?PrerenderBudget}
+     */
+    this.prerenderBudget_ = options.maxPrerenders === undefined ? null :
+      new PrerenderBudget(options.maxPrerenders);
+
+    /**
+     * Links near the viewport and how much of them is visible.
+     * @private {!Map<!Element, number>}
+     */
+    this.candidates_ = new Map();
+
+    /** @private {!Map<!Element, number>} */
+    this.dwellTimeouts_ = new Map();
+
+    /**
+     * The prefetches by AMP Doc url: the <link rel=prefetch>, null while the
+     * cache url is being built, and how many links near the viewport point
+     * to the AMP Doc.
+     * @private {!Map<string, {element: ?Element, count: number}>}
+     */
+    this.prefetches_ = new Map();
+
+    /**
+     * The links counted in prefetches_.
+     * @private {!Set<!Element>}
+     */
+    this.prefetchingLinks_ = new Set();
+
+    /** @private {?Viewer} */
+    this.prerenderedViewer_ = null;
+
+    /**
+     * The iframe of prerenderedViewer_, hidden until it's taken.
+     * @private {?HTMLIFrameElement}
+     */
+    this.prerenderedIframe_ = null;
+
+    /** @private {?string} */
+    this.prerenderedUrl_ = null;
+
+    /** @private {?IntersectionObserver} */
+    this.observer_ = typeof IntersectionObserver == 'undefined' ? null :
+      new IntersectionObserver(this.handleIntersections_.bind(this), {
+        rootMargin: options.rootMargin || DEFAULT_ROOT_MARGIN,
+        threshold: [0, 0.25, 0.5, 0.75, 1],
+      });
+  }
+
+  /**
+   * Starts watching an AMP link.
+   * @param {!Element} link
+   */
+  observe(link) {
+    if (this.observer_) {
+      this.observer_.observe(link);
+    }
+  }
+
+  /**
+   * Stops watching an AMP link and cancels its work.
+   * @param {!Element} link
+   */
+  unobserve(link) {
+    if (this.observer_) {
+      this.observer_.unobserve(link);
+    }
+    this.leave_(link);
+  }
+
+  /**
+   * Gets a visible viewer for the AMP link the user tapped: the prerendered
+   * one if it was for this link, a newly attached one otherwise.
+   * @param {!Element} link
+   * @return {!Viewer}
+   */
+  takeViewer(link) {
+    const url = this.getUrl_(link);
+    let viewer;
+    if (this.prerenderedViewer_ && this.prerenderedUrl_ == url) {
+      viewer = this.prerenderedViewer_;
+      showIframe_(this.prerenderedIframe_);
+      this.prerenderedViewer_ = null;
+      this.prerenderedIframe_ = null;
+      this.prerenderedUrl_ = null;
+      viewer.setVisibilityState(VisibilityState.VISIBLE);
+    } else {
+      this.dropPrerenderedViewer_();
+      viewer = new Viewer(this.hostElement_, url, this.referrer_);
+      viewer.attach();
+    }
+    return viewer;
+  }
+
+  /**
+   * @return {?string} the url of the link that has a prerendering viewer.
+   */
+  getPrerenderedUrl() {
+    return this.prerenderedUrl_;
+  }
+
+  /**
+   * Stops watching all links and cancels all work.
+   */
+  destroy() {
+    if (this.observer_) {
+      this.observer_.disconnect();
+    }
+    this.candidates_.forEach((ratio, link) => this.leave_(link));
+    this.dropPrerenderedViewer_();
+  }
+
+  /**
+   * @param {!Array<!IntersectionObserverEntry>} entries
+   * @private
+   */
+  handleIntersections_(entries) {
+    const entered = [];
+    entries.forEach(entry => {
+      const link = entry.target;
+      if (!entry.isIntersecting) {
+        this.leave_(link);
+        return;
+      }
+      if (!this.candidates_.has(link)) {
+        entered.push(link);
+      }
+      this.candidates_.set(link, entry.intersectionRatio);
+    });
+    entered.forEach(link => {
+      // Links flung past don't stay long enough to be worth any work.
+      this.dwellTimeouts_.set(link, setTimeout(() => {
+        this.dwellTimeouts_.delete(link);
+        this.prepare_([link]);
+        this.updatePrerender_();
+      }, this.dwellTime_));
+    });
+    this.updatePrerender_();
+  }
+
+  /**
+   * @param {!Element} link
+   * @private
+   */
+  leave_(link) {
+    if (!this.candidates_.delete(link)) {
+      return;
+    }
+    clearTimeout(this.dwellTimeouts_.get(link));
+    this.dwellTimeouts_.delete(link);
+
+    const url = this.getUrl_(link);
+    const prefetch = this.prefetches_.get(url);
+    // The prefetch is kept while another link to the same AMP Doc is near.
+    if (this.prefetchingLinks_.delete(link) && prefetch &&
+        --prefetch.count == 0) {
+      this.prefetches_.delete(url);
+      // Browsers that support it cancel the prefetch of a removed link.
+      if (prefetch.element && prefetch.element.parentNode) {
+        prefetch.element.parentNode.removeChild(prefetch.element);
+      }
+    }
+    this.updatePrerender_();
+  }
+
+  /**
+   * Warms the cache origins of links and prefetches their AMP Docs.
+   * @param {!Array<!Element>} links
+   * @private
+   */
+  prepare_(links) {
+    const urls = [];
+    links.forEach(link => {
+      const url = this.getUrl_(link);
+      if (!url || this.prefetchingLinks_.has(link)) {
+        return;
+      }
+      let prefetch = this.prefetches_.get(url);
+      if (!prefetch) {
+        urls.push(url);
+        if (!this.prefetch_) {
+          return;
+        }
+        prefetch = {element: null, count: 0};
+        this.prefetches_.set(url, prefetch);
+      }
+      prefetch.count++;
+      this.prefetchingLinks_.add(link);
+    });
+    if (!urls.length) {
+      return;
+    }
+    Viewer.warm(urls);
+    if (!this.prefetch_) {
+      return;
+    }
+    this.constructCacheUrls_(urls).then(cacheUrls => {
+      cacheUrls.forEach((cacheUrl, i) => {
+        const prefetch = this.prefetches_.get(urls[i]);
+        // Skip AMP Docs whose links all left while the url was being built.
+        if (cacheUrl && prefetch && !prefetch.element) {
+          prefetch.element = this.prefetchDocument_(cacheUrl);
+        }
+      });
+    });
+  }
+
+  /**
+   * @param {!Array<string>} urls
+   * @return {!Promise<!Array<?string>>}
+   * @private
+   */
+  constructCacheUrls_(urls) {
+    if (this.cacheUrlClient_) {
+      return this.cacheUrlClient_.constructViewerCacheUrls(urls, {},
+        Viewer.getCacheUrlAuthority());
+    }
+    return Promise.all(urls.map(url =>
+      constructViewerCacheUrl(url, {}, Viewer.getCacheUrlAuthority())
+        .catch(() => null)));
+  }
+
+  /**
+   * Prefetches an AMP Doc with a <link rel=prefetch>, which the browser
+   * keeps for the navigation of the iframe it's later loaded into.
+   * @param {string} cacheUrl
+   * @return {!Element} the link, removing it cancels the prefetch.
+   * @private
+   */
+  prefetchDocument_(cacheUrl) {
+    const link = document.createElement('link');
+    link.rel = 'prefetch';
+    link.as = 'document';
+    // The fragment only carries the init params, it isn't part of the request.
+    link.href = cacheUrl.split('#')[0];
+    document.head.appendChild(link);
+    return link;
+  }
+
+  /**
+   * Keeps a prerendering viewer for the most visible link that has been near
+   * the viewport long enough.
+   * @private
+   */
+  updatePrerender_() {
+    if (!this.prerender_) {
+      return;
+    }
+    let bestLink = null;
+    let bestRatio = 0;
+    this.candidates_.forEach((ratio, link) => {
+      if (ratio > bestRatio && !this.dwellTimeouts_.has(link)) {
+        bestLink = link;
+        bestRatio = ratio;
+      }
+    });
+    const url = bestLink && this.getUrl_(bestLink);
+    if (url == this.prerenderedUrl_) {
+      return;
+    }
+    this.dropPrerenderedViewer_();
+    if (url) {
+      this.prerenderedUrl_ = url;
+      this.prerenderedIframe_ = document.createElement('iframe');
+      hideIframe_(this.prerenderedIframe_);
+      this.prerenderedViewer_ = new Viewer(this.hostElement_, url,
+        this.referrer_, true /* opt_prerender */);
+      if (this.prerenderBudget_) {
+        this.prerenderedViewer_.setPrerenderBudget(this.prerenderBudget_);
+      }
+      this.prerenderedViewer_.attach(this.prerenderedIframe_);
+    }
+  }
+
+  /**
+   * @private
+   */
+  dropPrerenderedViewer_() {
+    if (this.prerenderedViewer_) {
+      const iframe = this.prerenderedViewer_.release();
+      if (iframe && iframe.parentNode) {
+        iframe.parentNode.removeChild(iframe);
+      }
+    }
+    this.prerenderedViewer_ = null;
+    this.prerenderedIframe_ = null;
+    this.prerenderedUrl_ = null;
+  }
+}
+
+/**
+ * Keeps a prerendering iframe out of sight and out of the host element's
+ * layout. It still renders, unlike with display: none.
+ * @param {!HTMLIFrameElement} iframe
+ * @private
+ */
+function hideIframe_(iframe) {
+  iframe.style.visibility = 'hidden';
+  iframe.style.position = 'absolute';
+}
+
+/**
+ * @param {!HTMLIFrameElement} iframe
+ * @private
+ */
+function showIframe_(iframe) {
+  iframe.style.visibility = '';
+  iframe.style.position = '';
+}
@@ -0,0 +1,235 @@
+/**
+ * Copyright 2020 The AMP HTML Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS-IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * A window message handler registered for one iframe.
+ * @typedef {{
+ *   iframe: !HTMLIFrameElement,
+ *   source: ?Window,
+ *   origin: string,
+ *   handler: function(!MessageEvent),
+ * }}
+ */
+let Route;
+
+/**
+ * Routers by the window they listen on.
+ * @type {!WeakMap<!Window, !MessageRouter>}
+ */
+const routers = new WeakMap();
+
+/**
+ * Listens for window messages once per page and hands each one to the iframe
+ * it came from, looked up by its source window, so the cost of a message
+ * doesn't grow with the number of viewers on the page. Messages from other
+ * windows, or from the wrong origin, are dropped.
+ */
+export class MessageRouter {
+
+  /**
+   * @param {!Window} win
+   */
+  constructor(win) {
+    /** @private {!Window} */
+    this.win_ = win;
+
+    /** @private {!Map<!Window, !Route>} */
+    this.routes_ = new Map();
+
+    /** @private {!Map<!HTMLIFrameElement, !Route>} */
+    this.iframeRoutes_ = new Map();
+
+    /**
+     * Routes for iframes that had no window yet when they were added, e.g.
+     * because they weren't in the document.
+     * @private {!Array<!Route>}
+     */
+    this.pending_ = [];
+
+    /** @private {?function(!MessageEvent)} */
+    this.listener_ = null;
+  }
+
+  /**
+   * @param {!Window} win
+   * @return {!MessageRouter} the router of win.
+   */
+  static forWindow(win) {
+    let router = routers.get(win);
+    if (!router) {
+      router = new MessageRouter(win);
+      routers.set(win, router);
+    }
+    return router;
+  }
+
+  /**
+   * Delivers messages posted by iframe's window from origin to handler, in
+   * place of any handler added for iframe before.
+   * @param {!HTMLIFrameElement} iframe
+   * @param {string} origin
+   * @param {function(!MessageEvent)} handler
+   * @return {function()} removes the handler.
+   */
+  listen(iframe, origin, handler) {
+    this.remove_(iframe);
+    const route = {iframe, source: iframe.contentWindow, origin, handler};
+    this.iframeRoutes_.set(iframe, route);
+    if (route.source) {
+      this.routes_.set(route.source, route);
+    } else {
+      this.pending_.push(route);
+    }
+    this.updateListener_();
+    return () => {
+      if (this.iframeRoutes_.get(iframe) == route) {
+        this.remove_(iframe);
+        this.updateListener_();
+      }
+    };
+  }
+
+  /**
+   * @return {number} how many iframes have a handler.
+   */
+  getRouteCount() {
+    return this.iframeRoutes_.size;
+  }
+
+  /**
+   * @param {!MessageEvent} e
+   * @private
+   */
+  handleMessage_(e) {
+    let route = e.source && this.routes_.get(e.source);
+    if (!route && this.pending_.length) {
+      this.resolvePending_();
+      route = e.source && this.routes_.get(e.source);
+    }
+    if (route && route.origin == e.origin) {
+      route.handler(e);
+    }
+  }
+
+  /**
+   * Moves the pending routes whose iframe has a window by now to routes_.
+   * @private
+   */
+  resolvePending_() {
+    this.pending_ = this.pending_.filter(route => {
+      route.source = route.iframe.contentWindow;
+      if (!route.source) {
+        return true;
+      }
+      this.routes_.set(route.source, route);
+      return false;
+    });
+  }
+
+  /**
+   * @param {!HTMLIFrameElement} iframe
+   * @private
+   */
+  remove_(iframe) {
+    const route = this.iframeRoutes_.get(iframe);
+    if (!route) {
+      return;
+    }
+    this.iframeRoutes_.delete(iframe);
+    if (route.source) {
+      this.routes_.delete(route.source);
+    } else {
+      this.pending_.splice(this.pending_.indexOf(route), 1);
+    }
+  }
+
+  /**
+   * Listens while there are routes and stops when there are none left.
+   * @private
+   */
+  updateListener_() {
+    const hasRoutes = this.getRouteCount() > 0;
+    if (hasRoutes && !this.listener_) {
+      this.listener_ = this.handleMessage_.bind(this);
+      this.win_.addEventListener('message', this.listener_);
+    } else if (!hasRoutes && this.listener_) {
+      this.win_.removeEventListener('message', this.listener_);
+      this.listener_ = null;
+    }
+  }
+}
+
+/**
+ * A port to an iframe's window, for Messaging, that receives through the
+ * page's MessageRouter instead of a window listener of its own. Once closed,
+ * messages from the iframe are no longer delivered, so a reused iframe's
+ * next AMP Doc can't reach the old messaging channel.
+ */
+export class RoutedWindowPort {
+
+  /**
+   * @param {!Window} win
+   * @param {!HTMLIFrameElement} iframe
+   * @param {string} origin
+   */
+  constructor(win, iframe, origin) {
+    /** @private {!MessageRouter} */
+    this.router_ = MessageRouter.forWindow(win);
+    /** @private {!HTMLIFrameElement} */
+    this.iframe_ = iframe;
+    /** @private {string} */
+    this.origin_ = origin;
+    /** @private {?function()} */
+    this.unlisten_ = null;
+    /** @private {boolean} */
+    this.closed_ = false;
+  }
+
+  /**
+   * @param {string} eventType only 'message' is supported.
+   * @param {function(!Event)} handler
+   */
+  addEventListener(eventType, handler) {
+    if (eventType != 'message' || this.closed_) {
+      return;
+    }
+    this.unlisten_ = this.router_.listen(this.iframe_, this.origin_, handler);
+  }
+
+  /**
+   * @param {*} data
+   */
+  postMessage(data) {
+    const target = this.iframe_.contentWindow;
+    if (this.closed_ || !target) {
+      return;
+    }
+    // A sandboxed AMP Doc has the opaque origin 'null', which can't be
+    // targeted.
+    target./*OK*/postMessage(data,
+      this.origin_ == 'null' ? '*' : this.origin_);
+  }
+
+  start() {}
+
+  close() {
+    this.closed_ = true;
+    if (this.unlisten_) {
+      this.unlisten_();
+      this.unlisten_ = null;
+    }
+  }
+}
@@ -0,0 +1,125 @@
+/**
+ * Copyright 2020 The AMP HTML Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS-IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/** @const {number} How many viewers may prerender at once by default. */
+const DEFAULT_MAX_PRERENDERS = 2;
+
+/**
+ * Caps how many viewers on the page may prerender at once, so speculative
+ * prerenders don't saturate the CPU and network. Viewers that don't get a
+ * slot wait in line and are granted one, in order, as slots are released.
+ */
+export class PrerenderBudget {
+
+  /**
+   * @param {number=} opt_maxPrerenders
+   */
+  constructor(opt_maxPrerenders) {
+    /** @private {number} */
+    this.maxPrerenders_ = opt_maxPrerenders === undefined ?
+      DEFAULT_MAX_PRERENDERS : opt_maxPrerenders;
+
+    /** @private {!Set<*>} */
+    this.holders_ = new Set();
+
+    /** @private {!Array<{holder: *, callback: !Function}>} */
+    this.waiting_ = [];
+  }
+
+  /**
+   * @param {number} maxPrerenders
+   */
+  setMaxPrerenders(maxPrerenders) {
+    this.maxPrerenders_ = Math.max(0, maxPrerenders);
+    this.grantWaiting_();
+  }
+
+  /**
+   * @return {number}
+   */
+  getMaxPrerenders() {
+    return this.maxPrerenders_;
+  }
+
+  /**
+   * @return {number} how many slots are held.
+   */
+  getPrerenderCount() {
+    return this.holders_.size;
+  }
+
+  /**
+   * Takes a slot for holder if one is free, or holder already has one.
+   * @param {*} holder
+   * @return {boolean} true if holder may prerender.
+   */
+  tryAcquire(holder) {
+    if (this.holders_.has(holder)) {
+      return true;
+    }
+    if (this.holders_.size >= this.maxPrerenders_) {
+      return false;
+    }
+    this.holders_.add(holder);
+    return true;
+  }
+
+  /**
+   * Puts holder in line for a slot. callback is called once the slot has been
+   * taken on its behalf.
+   * @param {*} holder
+   * @param {!Function} callback
+   */
+  enqueue(holder, callback) {
+    this.cancel(holder);
+    this.waiting_.push({holder, callback});
+    this.grantWaiting_();
+  }
+
+  /**
+   * Takes holder out of line without granting it a slot.
+   * @param {*} holder
+   */
+  cancel(holder) {
+    this.waiting_ = this.waiting_.filter(entry => entry.holder !== holder);
+  }
+
+  /**
+   * Frees holder's slot, if any, and takes it out of line.
+   * @param {*} holder
+   */
+  release(holder) {
+    this.cancel(holder);
+    if (this.holders_.delete(holder)) {
+      this.grantWaiting_();
+    }
+  }
+
+  /**
+   * @private
+   */
+  grantWaiting_() {
+    while (this.waiting_.length && this.tryAcquire(this.waiting_[0].holder)) {
+      this.waiting_.shift().callback();
+    }
+  }
+}
+
+/**
+ * The budget shared by every viewer on the page.
+ * @const {!PrerenderBudget}
+ */
+export const prerenderBudget = new PrerenderBudget();
@@ -19,13 +19,68 @@ import {
   Messaging,
   MessageType,
   RequestHandler,
-  WindowPortEmulator,
 } from 'amp-viewer-messaging/messaging';
+import {MessageRouter, RoutedWindowPort} from './message-router';
+import {ViewerPerformance} from './viewer-performance';
 import {log} from '../utils/log';
 
 
 const CHANNEL_OPEN_MSG = 'channelOpen';
 
+/** @const {number} How many requests are held until the handshake. */
+const MAX_QUEUED_REQUESTS = 50;
+
+const VISIBILITY_CHANGE_MSG = 'visibilitychange';
+
+/**
+ * A request made before the handshake, sent once messaging is established.
+ * @typedef {{
+ *   type: string,
+ *   data: *,
+ *   awaitResponse: boolean,
+ *   resolve: function(*),
+ *   reject: function(*),
+ * }}
+ */
+let QueuedRequest;
+
+/** @const {number} The first retry delay of the handshake poll, in ms. */
+const HANDSHAKE_POLL_INITIAL_DELAY = 50;
+
+/** @const {number} The longest retry delay of the handshake poll, in ms. */
+const HANDSHAKE_POLL_MAX_DELAY = 1000;
+
+/**
+ * @const {number} How many offers the handshake poll makes before it gives
+ * up, about 20 seconds' worth. A document that never answers, e.g. one that
+ * isn't AMP, would otherwise be offered a port every second for good.
+ */
+const HANDSHAKE_POLL_MAX_ATTEMPTS = 25;
+
+/**
+ * The visibility states an AMP Doc can be put in by its viewer.
+ * @enum {string}
+ */
+export const VisibilityState = {
+  PRERENDER: 'prerender',
+  VISIBLE: 'visible',
+  INACTIVE: 'inactive',
+  PAUSED: 'paused',
+};
+
+/**
+ * @param {string} state
+ * @return {boolean} true if state is one of VisibilityState.
+ */
+export function isVisibilityState(state) {
+  for (const key in VisibilityState) {
+    if (VisibilityState[key] == state) {
+      return true;
+    }
+  }
+  return false;
+}
+
 export class ViewerMessaging {
 
   /**
@@ -33,8 +88,11 @@ export class ViewerMessaging {
    * @param {!HTMLIFrameElement} ampIframe
    * @param {string} frameOrigin
    * @param {!RequestHandler} messageHandler
+   * @param {string=} opt_visibilityState the state to hand the AMP Doc once
+   *   the handshake completes, VISIBLE by default.
    */
-  constructor(win, ampIframe, frameOrigin, messageHandler) {
+  constructor(win, ampIframe, frameOrigin, messageHandler,
+      opt_visibilityState) {
     /** @const {!Window} */
     this.win = win;
     /** @private {!HTMLIFrameElement} */
@@ -43,24 +101,143 @@ export class ViewerMessaging {
     this.frameOrigin_ = frameOrigin;
     /** @private {!RequestHandler} */
     this.messageHandler_ = messageHandler;
+    /** @private {string} */
+    this.visibilityState_ = opt_visibilityState || VisibilityState.VISIBLE;
+    /** @private {number} */
+    this.prerenderSize_ = 1;
+    /** @private {?number} */
+    this.timeToHandshake_ = null;
+    /** @private {!Array<!QueuedRequest>} */
+    this.requestQueue_ = [];
+    /** @private {boolean} */
+    this.stopped_ = false;
+    /** @private {number} */
+    this.handshakeAttempts_ = 0;
+    /** @private {?ViewerPerformance} */
+    this.performance_ = null;
+    /**
+     * The ports offered to the AMP Doc that haven't been answered. The AMP
+     * runtime takes the first offer it receives, which may not be the newest
+     * one, so they all listen until one of them is answered.
+     * @private {!Array<!MessagePort>}
+     */
+    this.pollChannelPorts_ = [];
+  }
+
+  /**
+   * Reports handshake attempts and request round trip times to performance.
+   * @param {!ViewerPerformance} performance
+   */
+  setPerformance(performance) {
+    this.performance_ = performance;
+  }
+
+  /**
+   * Tells the AMP Doc about its new visibility state, or remembers it for the
+   * handshake if messaging isn't established yet.
+   * @param {string} visibilityState one of VisibilityState.
+   */
+  setVisibilityState(visibilityState) {
+    if (this.visibilityState_ == visibilityState) {
+      return;
+    }
+    this.visibilityState_ = visibilityState;
+    if (!this.messaging_) {
+      // The handshake sends whatever the state is by then.
+      return;
+    }
+    this.sendRequest(VISIBILITY_CHANGE_MSG, {
+      state: this.visibilityState_,
+      prerenderSize: this.prerenderSize_,
+    }, false);
   }
 
   /**
+   * Waits for the AMP Doc to open the messaging channel. With
+   * opt_isHandshakePoll the viewer offers the AMP Doc a MessageChannel port
+   * until it answers on it, which needs the 'handshakepoll' capability in its
+   * init params; an AMP Doc that opens the channel on the window instead is
+   * still accepted.
    * @param {boolean=} opt_isHandshakePoll
    * @return {!Promise}
    */
   start(opt_isHandshakePoll) {
-    if (opt_isHandshakePoll) {
+    /** @private {number} */
+    this.handshakeStartTime_ = this.win.performance.now();
+    return new Promise(resolve => {
+      /** @private {?Function} */
+      this.handshakeResolve_ = resolve;
+      this.waitForHandshake_(this.frameOrigin_);
+      if (!opt_isHandshakePoll) {
+        return;
+      }
+      // Offers posted before the AMP Doc's window exists are lost, so offer
+      // again as soon as it has loaded rather than waiting for the next
+      // retry. The retries go on: the runtime loads asynchronously and may
+      // not be listening yet.
+      /** @private {?function()} */
+      this.iframeLoadListener_ = () => {
+        this.pollHandshake_();
+      };
+      this.ampIframe_.addEventListener('load', this.iframeLoadListener_);
       /** @private {number} */
-      this.pollingIntervalId_ = setInterval(this.initiateHandshake_.bind(
-        this, this.intervalCtr) , 1000); //poll every second
-      return new Promise(resolve => {
-        /** @private {!Function} */
-        this.hanshakePollPromiseResolve_ = resolve;
-      });
-    } else {
-      return this.waitForHandshake_(this.frameOrigin_);
+      this.handshakePollDelay_ = HANDSHAKE_POLL_INITIAL_DELAY;
+      this.pollHandshake_();
+    });
+  }
+
+  /**
+   * Offers the AMP Doc a handshake now and schedules the next offer with
+   * exponential backoff, in case this one arrives before the AMP Doc listens.
+   * Extra offers are harmless: the runtime answers the first one it receives
+   * and every offer listens until one is answered, so a reply on an older
+   * port than the newest still completes the handshake.
+   * @private
+   */
+  pollHandshake_() {
+    clearTimeout(this.handshakePollTimeoutId_);
+    this.handshakePollTimeoutId_ = 0;
+    if (this.handshakeAttempts_ >= HANDSHAKE_POLL_MAX_ATTEMPTS) {
+      return;
+    }
+    this.initiateHandshake_();
+    /** @private {number} */
+    this.handshakePollTimeoutId_ = setTimeout(() => {
+      this.handshakePollDelay_ = Math.min(
+        this.handshakePollDelay_ * 2, HANDSHAKE_POLL_MAX_DELAY);
+      this.pollHandshake_();
+    }, this.handshakePollDelay_);
+  }
+
+  /**
+   * Stops waiting for a handshake: stops offering them, closes the
+   * unanswered channels and stops listening on the window.
+   * @private
+   */
+  stopHandshake_() {
+    if (this.unlistenHandshake_) {
+      this.unlistenHandshake_();
+      this.unlistenHandshake_ = null;
+    }
+    clearTimeout(this.handshakePollTimeoutId_);
+    this.handshakePollTimeoutId_ = 0;
+    if (this.iframeLoadListener_) {
+      this.ampIframe_.removeEventListener('load', this.iframeLoadListener_);
+      this.iframeLoadListener_ = null;
     }
+    this.closePollChannelPorts_();
+  }
+
+  /**
+   * @private
+   */
+  closePollChannelPorts_() {
+    const ports = this.pollChannelPorts_;
+    this.pollChannelPorts_ = [];
+    ports.forEach(port => {
+      port.onmessage = null;
+      port.close();
+    });
   }
 
   /**
@@ -68,63 +245,115 @@ export class ViewerMessaging {
    */
   initiateHandshake_() {
     log('initiateHandshake_');
-    if (this.ampIframe_) {
-      const channel = new MessageChannel();
-      let message = {
-        app: APP,
-        name: 'handshake-poll',
-      };
-      this.ampIframe_.contentWindow./*OK*/postMessage(
-        message, '*', [channel.port2]);
-
-      channel.port1.onmessage = e => {
-        const data = e.data;
-        if (this.isChannelOpen_(data)) {
-          clearInterval(this.pollingIntervalId_); //stop polling
-          log('messaging established!');
-          this.completeHandshake_(channel.port1, data.requestid).then(() => {
-            this.hanshakePollPromiseResolve_();
-          });
-        } else {
-          this.messageHandler_(data.name, data.data, data.rsvp);
-        }
-      };
+    const target = this.ampIframe_ && this.ampIframe_.contentWindow;
+    if (!target) {
+      return;
     }
+    this.handshakeAttempts_++;
+    const channel = new MessageChannel();
+    this.pollChannelPorts_.push(channel.port1);
+
+    let message = {
+      app: APP,
+      name: 'handshake-poll',
+    };
+    target./*OK*/postMessage(message, '*', [channel.port2]);
+
+    const port = channel.port1;
+    port.onmessage = e => {
+      if (!this.isChannelOpen_(e.data)) {
+        return;
+      }
+      log('messaging established!');
+      // Hand the port over to Messaging, which listens on it from now on,
+      // and close the offers that weren't taken.
+      port.onmessage = null;
+      this.pollChannelPorts_.splice(this.pollChannelPorts_.indexOf(port), 1);
+      this.stopHandshake_();
+      this.completeHandshake_(port, e.data.requestid).then(() => {
+        this.resolveHandshake_();
+      });
+    };
   }
 
   /**
+   * Listens, through the page's MessageRouter, for the AMP Doc to open the
+   * channel on the window.
    * @param {string} targetOrigin
-   * @return {!Promise}
    * @private
    */
   waitForHandshake_(targetOrigin) {
     log('awaitHandshake_');
-    return new Promise(resolve => {
-      const listener = e => {
-        log('message!', e);
-        const target = this.ampIframe_.contentWindow;
-        if (e.origin == targetOrigin &&
-            this.isChannelOpen_(e.data) &&
-            (!e.source || e.source == target)) {
-          log(' messaging established with ', targetOrigin);
-          this.win.removeEventListener('message', listener);
-          const port = new WindowPortEmulator(this.win, targetOrigin, target);
-          this.completeHandshake_(port, e.data.requestid).then(() => {
-            resolve();
-          });
+    /** @private {?function()} */
+    this.unlistenHandshake_ = MessageRouter.forWindow(this.win).listen(
+      this.ampIframe_, targetOrigin, e => {
+        if (!this.isChannelOpen_(e.data)) {
+          return;
         }
-      };
-      this.win.addEventListener('message', listener);
+        log(' messaging established with ', targetOrigin);
+        this.stopHandshake_();
+        const port =
+          new RoutedWindowPort(this.win, this.ampIframe_, targetOrigin);
+        this.completeHandshake_(port, e.data.requestid).then(() => {
+          this.resolveHandshake_();
+        });
+      });
+  }
+
+  /**
+   * @private
+   */
+  resolveHandshake_() {
+    if (this.handshakeResolve_) {
+      this.handshakeResolve_();
+      this.handshakeResolve_ = null;
+    }
+  }
+
+  /**
+   * Stops any pending handshake and drops the messaging channel, e.g. before
+   * the iframe is reused for another AMP Doc.
+   */
+  stop() {
+    this.stopHandshake_();
+    if (this.port_) {
+      this.port_.close();
+      this.port_ = null;
+    }
+    this.messaging_ = null;
+    this.stopped_ = true;
+    const queue = this.requestQueue_;
+    this.requestQueue_ = [];
+    queue.forEach(request => {
+      request.reject(new Error('Messaging stopped before ' + request.type +
+        ' was sent'));
     });
   }
 
   /**
-   * @param {!MessagePort|!WindowPortEmulator} port
+   * @return {?number} how long the handshake took after start(), in ms, or
+   *   null if it hasn't completed.
+   */
+  getTimeToHandshake() {
+    return this.timeToHandshake_;
+  }
+
+  /**
+   * @param {!MessagePort|!RoutedWindowPort} port
    * @param {string} requestId
    * @return {!Promise}
    * @private
    */
   completeHandshake_(port, requestId) {
+    this.timeToHandshake_ =
+      this.win.performance.now() - this.handshakeStartTime_;
+    log('handshake completed in', this.timeToHandshake_, 'ms');
+    // No offers were made when the AMP Doc opened the channel on the
+    // window by itself, which is reported as 0 attempts.
+    if (this.performance_) {
+      this.performance_.count('handshakeAttempts', this.handshakeAttempts_);
+    }
+
     let message = {
       app: APP,
       requestid: requestId,
@@ -134,17 +363,57 @@ export class ViewerMessaging {
     log('posting Message', message);
     port./*OK*/postMessage(message);
 
+    /** @private {!MessagePort|!RoutedWindowPort} */
+    this.port_ = port;
     this.messaging_ = new Messaging(this.win, port);
     this.messaging_.setDefaultHandler(this.messageHandler_);
 
-    this.sendRequest('visibilitychange', {
-      state: this.visibilityState_,
-      prerenderSize: this.prerenderSize,
-    }, true);
+    this.flushRequestQueue_();
 
     return Promise.resolve();
   };
 
+  /**
+   * Sends the visibility state first, answering any visibilitychange request
+   * made before the handshake with it, then everything else that was queued.
+   * @private
+   */
+  flushRequestQueue_() {
+    const queue = this.requestQueue_;
+    this.requestQueue_ = [];
+
+    const visibilityIndex = this.findQueuedVisibilityChange_(queue);
+    const queuedVisibility =
+      visibilityIndex == -1 ? null : queue.splice(visibilityIndex, 1)[0];
+    const visibilityPromise = this.messaging_.sendRequest(
+      VISIBILITY_CHANGE_MSG, {
+        state: this.visibilityState_,
+        prerenderSize: this.prerenderSize_,
+      }, true);
+    if (queuedVisibility) {
+      visibilityPromise.then(queuedVisibility.resolve, queuedVisibility.reject);
+    }
+
+    queue.forEach(request => {
+      this.sendRequest(request.type, request.data, request.awaitResponse)
+        .then(request.resolve, request.reject);
+    });
+  }
+
+  /**
+   * @param {!Array<!QueuedRequest>} queue
+   * @return {number} the index of the queued visibilitychange, or -1.
+   * @private
+   */
+  findQueuedVisibilityChange_(queue) {
+    for (let i = 0; i < queue.length; i++) {
+      if (queue[i].type == VISIBILITY_CHANGE_MSG) {
+        return i;
+      }
+    }
+    return -1;
+  }
+
   /**
    * @param {*} eventData
    * @return {boolean}
@@ -155,16 +424,61 @@ export class ViewerMessaging {
   };
 
   /**
+   * Sends a request to the AMP Doc. Requests made before the handshake are
+   * queued and sent as soon as it completes; repeated visibilitychange
+   * requests are coalesced into the latest one.
    * @param {string} type
    * @param {*} data
    * @param {boolean} awaitResponse
-   * @return {!Promise<*>|undefined}
+   * @return {!Promise<*>} resolves with the response, or once sent if
+   *   awaitResponse is false.
    */
   sendRequest(type, data, awaitResponse) {
     log('sendRequest');
-    if (!this.messaging_) {
-      return;
+    if (this.messaging_) {
+      const response = Promise.resolve(
+        this.messaging_.sendRequest(type, data, awaitResponse));
+      if (awaitResponse && this.performance_) {
+        const performance = this.performance_;
+        const start = performance.now();
+        response.then(() => {
+          performance.duration('roundTrip:' + type, performance.now() - start);
+        }, () => {});
+      }
+      return response;
+    }
+    if (this.stopped_) {
+      return Promise.reject(new Error('Messaging stopped, ' + type +
+        ' was not sent'));
     }
-    return this.messaging_.sendRequest(type, data, awaitResponse);
+    return new Promise((resolve, reject) => {
+      if (type == VISIBILITY_CHANGE_MSG) {
+        const index = this.findQueuedVisibilityChange_(this.requestQueue_);
+        if (index != -1) {
+          // Only the latest state matters; answer the older request with
+          // whatever the newer one gets.
+          const older = this.requestQueue_.splice(index, 1)[0];
+          const resolveNewer = resolve;
+          const rejectNewer = reject;
+          resolve = value => {
+            older.resolve(value);
+            resolveNewer(value);
+          };
+          reject = reason => {
+            older.reject(reason);
+            rejectNewer(reason);
+          };
+        }
+        if (data && data.state) {
+          this.visibilityState_ = data.state;
+        }
+      }
+      if (this.requestQueue_.length >= MAX_QUEUED_REQUESTS) {
+        reject(new Error('Too many requests before the handshake, ' + type +
+          ' was dropped'));
+        return;
+      }
+      this.requestQueue_.push({type, data, awaitResponse, resolve, reject});
+    });
   };
 }
@@ -0,0 +1,208 @@
+/**
+ * Copyright 2020 The AMP HTML Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS-IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+import {log} from '../utils/log';
+
+/**
+ * A timing reported to the listeners registered with onViewerTiming.
+ *   type: 'mark' for a point in time, 'measure' for a duration, 'count' for
+ *     a number of occurrences, e.g. handshake attempts.
+ *   name: e.g. 'attachStart' or 'handshake'.
+ *   value: the performance.now() time of a mark, the duration of a measure
+ *     in ms, or the count.
+ *   viewerId: which viewer on the page it's about.
+ *   ampDocUrl: the AMP Doc that viewer shows.
+ * @typedef {{
+ *   type: string,
+ *   name: string,
+ *   value: number,
+ *   viewerId: number,
+ *   ampDocUrl: string,
+ * }}
+ */
+let ViewerTiming;
+
+/** @const {string} Prefix of the User Timing entries of viewers. */
+const ENTRY_PREFIX = 'amp-viewer';
+
+/** @type {number} */
+let nextViewerId = 0;
+
+/** @const {!Array<function(!ViewerTiming)>} */
+const listeners = [];
+
+/**
+ * Registers a callback for the timings of every viewer on the page, e.g. to
+ * export them to a RUM backend.
+ * @param {function(!ViewerTiming)} callback
+ * @return {function()} unregisters the callback.
+ */
+export function onViewerTiming(callback) {
+  listeners.push(callback);
+  return () => {
+    const index = listeners.indexOf(callback);
+    if (index != -1) {
+      listeners.splice(index, 1);
+    }
+  };
+}
+
+/**
+ * Records the timings of one viewer as User Timing marks and measures, named
+ * 'amp-viewer:<viewerId>:<name>', and reports them to onViewerTiming
+ * listeners. The entries stay on the performance timeline until clear().
+ */
+export class ViewerPerformance {
+
+  /**
+   * @param {string} ampDocUrl
+   */
+  constructor(ampDocUrl) {
+    /** @const {number} */
+    this.viewerId = nextViewerId++;
+
+    /** @private {string} */
+    this.ampDocUrl_ = ampDocUrl;
+
+    /** @private {!Object<string, number>} */
+    this.marks_ = {};
+
+    /** @private {!Array<string>} */
+    this.measureNames_ = [];
+
+    /** @private {?Performance} */
+    this.performance_ = typeof performance == 'undefined' ? null : performance;
+  }
+
+  /**
+   * @return {number} the current time in ms, as performance.now().
+   */
+  now() {
+    return this.performance_ ? this.performance_.now() : Date.now();
+  }
+
+  /**
+   * Marks that something happened now.
+   * @param {string} name
+   */
+  mark(name) {
+    this.marks_[name] = this.now();
+    if (this.performance_ && this.performance_.mark) {
+      this.performance_.mark(this.entryName_(name));
+    }
+    this.report_('mark', name, this.marks_[name]);
+  }
+
+  /**
+   * Measures the time between two marks, if both happened.
+   * @param {string} name
+   * @param {string} startMark
+   * @param {string} endMark
+   */
+  measure(name, startMark, endMark) {
+    const start = this.marks_[startMark];
+    const end = this.marks_[endMark];
+    if (start === undefined || end === undefined) {
+      return;
+    }
+    if (this.performance_ && this.performance_.measure) {
+      this.performance_.measure(this.entryName_(name),
+        this.entryName_(startMark), this.entryName_(endMark));
+      this.measureNames_.push(name);
+    }
+    this.report_('measure', name, end - start);
+  }
+
+  /**
+   * Reports a duration that doesn't start and end at marks, e.g. a message
+   * round trip.
+   * @param {string} name
+   * @param {number} duration in ms.
+   */
+  duration(name, duration) {
+    this.report_('measure', name, duration);
+  }
+
+  /**
+   * @param {string} name
+   * @param {number} count
+   */
+  count(name, count) {
+    this.report_('count', name, count);
+  }
+
+  /**
+   * Removes this viewer's marks and measures from the performance timeline,
+   * e.g. once the viewer is released, so a page that goes through many
+   * viewers doesn't fill up the timeline. They have been reported already.
+   * Measures only use the marks made after this.
+   */
+  clear() {
+    if (this.performance_ && this.performance_.clearMarks) {
+      Object.keys(this.marks_).forEach(name => {
+        this.performance_.clearMarks(this.entryName_(name));
+      });
+    }
+    if (this.performance_ && this.performance_.clearMeasures) {
+      this.measureNames_.forEach(name => {
+        this.performance_.clearMeasures(this.entryName_(name));
+      });
+    }
+    this.marks_ = {};
+    this.measureNames_ = [];
+  }
+
+  /**
+   * @param {string} name
+   * @return {number|undefined} when the mark happened, if it did.
+   */
+  getMark(name) {
+    return this.marks_[name];
+  }
+
+  /**
+   * @param {string} name
+   * @return {string}
+   * @private
+   */
+  entryName_(name) {
+    return ENTRY_PREFIX + ':' + this.viewerId + ':' + name;
+  }
+
+  /**
+   * @param {string} type
+   * @param {string} name
+   * @param {number} value
+   * @private
+   */
+  report_(type, name, value) {
+    const timing = {
+      type,
+      name,
+      value,
+      viewerId: this.viewerId,
+      ampDocUrl: this.ampDocUrl_,
+    };
+    listeners.slice().forEach(listener => {
+      try {
+        listener(timing);
+      } catch (error) {
+        // A broken listener shouldn't break the viewer.
+        log('viewer timing listener failed', error);
+      }
+    });
+  }
+}
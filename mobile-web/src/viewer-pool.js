@@ -0,0 +1,258 @@
+/**
+ * Copyright 2020 The AMP HTML Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS-IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+import {Viewer} from './viewer';
+import {VisibilityState} from './viewer-messaging';
+
+/** @const {number} The default number of neighbors to prerender per side. */
+const DEFAULT_WINDOW_SIZE = 1;
+
+/**
+ * Shows a list of AMP Docs that can be swiped through. This is the mobile-web
+ * counterpart of AMPKViewerDataSource: it keeps a bounded pool of iframes,
+ * one Viewer each, for the current AMP Doc and windowSize neighbors on each
+ * side. Neighbors are attached in prerender and promoted to visible when they
+ * become current. Iframes that leave the window are recycled for the AMP Docs
+ * that enter it instead of being recreated.
+ *
+ * The iframes cover the Host Element, and touches inside them stay in the
+ * AMP Doc, so the page drives the pool with next() and previous(), e.g. from
+ * its own controls.
+ */
+export class ViewerPool {
+
+  /**
+   * @param {!Element} hostElement the element to attach the iframes to.
+   * @param {number=} opt_windowSize how many neighbors to prerender on each
+   *   side of the current AMP Doc.
+   * @param {string=} opt_referrer
+   */
+  constructor(hostElement, opt_windowSize, opt_referrer) {
+    /** @private {!Element} */
+    this.hostElement_ = hostElement;
+
+    /** @private {number} */
+    this.windowSize_ = opt_windowSize === undefined ?
+      DEFAULT_WINDOW_SIZE : Math.max(0, opt_windowSize);
+
+    /** @private {string|undefined} */
+    this.referrer_ = opt_referrer;
+
+    /** @private {!Array<string>} */
+    this.ampDocUrls_ = [];
+
+    /** @private {number} */
+    this.currentIndex_ = -1;
+
+    /**
+     * The attached viewers keyed by the index of their AMP Doc.
+     * @private {!Map<number, !Viewer>}
+     */
+    this.viewers_ = new Map();
+
+    /** @private {!Map<!Viewer, !HTMLIFrameElement>} */
+    this.iframes_ = new Map();
+
+    /** @private {!Array<!HTMLIFrameElement>} */
+    this.freeIframes_ = [];
+
+    /** @private {?Array<!Function>} */
+    this.showAndHide_ = null;
+  }
+
+  /**
+   * Passed on to every Viewer in the pool, see Viewer.setViewerShowAndHide.
+   * @param {!Function} showViewer
+   * @param {!Function} hideViewer
+   * @param {!function():boolean} isViewerHidden
+   */
+  setViewerShowAndHide(showViewer, hideViewer, isViewerHidden) {
+    this.showAndHide_ = [showViewer, hideViewer, isViewerHidden];
+    this.viewers_.forEach(viewer => {
+      viewer.setViewerShowAndHide(showViewer, hideViewer, isViewerHidden);
+    });
+  }
+
+  /**
+   * Replaces the AMP Docs of the pool and shows the one at opt_index.
+   * @param {!Array<string>} ampDocUrls
+   * @param {number=} opt_index
+   */
+  setAmpDocUrls(ampDocUrls, opt_index) {
+    this.viewers_.forEach((viewer, index) => this.recycle_(index));
+    this.ampDocUrls_ = ampDocUrls.slice();
+    this.currentIndex_ = -1;
+    this.setCurrentIndex(opt_index || 0);
+  }
+
+  /**
+   * @return {number} the index of the visible AMP Doc, -1 if there is none.
+   */
+  getCurrentIndex() {
+    return this.currentIndex_;
+  }
+
+  /**
+   * @return {?Viewer} the viewer of the visible AMP Doc.
+   */
+  getCurrentViewer() {
+    return this.viewers_.get(this.currentIndex_) || null;
+  }
+
+  /**
+   * Makes the AMP Doc at index visible, promoting its prerendered viewer if
+   * there is one, and moves the prerender window around it.
+   * @param {number} index
+   */
+  setCurrentIndex(index) {
+    if (index < 0 || index >= this.ampDocUrls_.length ||
+        index == this.currentIndex_) {
+      return;
+    }
+    this.currentIndex_ = index;
+
+    // Free the iframes that fell out of the window first so the ones that
+    // entered it can reuse them.
+    const first = Math.max(0, index - this.windowSize_);
+    const last = Math.min(this.ampDocUrls_.length - 1,
+      index + this.windowSize_);
+    this.viewers_.forEach((viewer, i) => {
+      if (i < first || i > last) {
+        this.recycle_(i);
+      }
+    });
+
+    // The current AMP Doc starts loading before its neighbors. Neighbors that
+    // were never shown stay in prerender, the ones that were go inactive.
+    this.getOrAttachViewer_(index).setVisibilityState(VisibilityState.VISIBLE);
+    for (let offset = 1; offset <= this.windowSize_; offset++) {
+      [index + offset, index - offset].forEach(i => {
+        if (i < first || i > last) {
+          return;
+        }
+        const viewer = this.getOrAttachViewer_(i);
+        if (viewer.getVisibilityState() != VisibilityState.PRERENDER) {
+          viewer.setVisibilityState(VisibilityState.INACTIVE);
+        }
+      });
+    }
+
+    this.viewers_.forEach((viewer, i) => this.layout_(viewer, i));
+  }
+
+  /**
+   * Shows the next AMP Doc, if there is one.
+   */
+  next() {
+    this.setCurrentIndex(this.currentIndex_ + 1);
+  }
+
+  /**
+   * Shows the previous AMP Doc, if there is one.
+   */
+  previous() {
+    this.setCurrentIndex(this.currentIndex_ - 1);
+  }
+
+  /**
+   * Releases every viewer and removes the iframes from the Host Element.
+   */
+  destroy() {
+    this.viewers_.forEach((viewer, index) => this.recycle_(index));
+    this.freeIframes_.forEach(iframe => {
+      this.hostElement_.removeChild(iframe);
+    });
+    this.freeIframes_ = [];
+    this.ampDocUrls_ = [];
+    this.currentIndex_ = -1;
+  }
+
+  /**
+   * @param {number} index
+   * @return {!Viewer} the viewer for the AMP Doc at index, attached to a
+   *   recycled iframe when one is free.
+   * @private
+   */
+  getOrAttachViewer_(index) {
+    let viewer = this.viewers_.get(index);
+    if (viewer) {
+      return viewer;
+    }
+
+    viewer = new Viewer(this.hostElement_, this.ampDocUrls_[index],
+      this.referrer_, index != this.currentIndex_ /* opt_prerender */);
+    if (this.showAndHide_) {
+      viewer.setViewerShowAndHide.apply(viewer, this.showAndHide_);
+    }
+
+    const iframe = this.freeIframes_.pop() || this.createIframe_();
+    this.viewers_.set(index, viewer);
+    this.iframes_.set(viewer, iframe);
+    this.layout_(viewer, index);
+    viewer.attach(iframe);
+    return viewer;
+  }
+
+  /**
+   * Releases the viewer at index and keeps its iframe for reuse. The AMP Doc
+   * is told it is inactive and then unloaded, so it doesn't keep running
+   * until the iframe is reused.
+   * @param {number} index
+   * @private
+   */
+  recycle_(index) {
+    const viewer = this.viewers_.get(index);
+    const iframe = this.iframes_.get(viewer);
+    this.viewers_.delete(index);
+    this.iframes_.delete(viewer);
+    viewer.setVisibilityState(VisibilityState.INACTIVE);
+    iframe.src = 'about:blank';
+    viewer.release();
+    iframe.style.visibility = 'hidden';
+    this.freeIframes_.push(iframe);
+  }
+
+  /**
+   * @return {!HTMLIFrameElement} a new iframe in the Host Element.
+   * @private
+   */
+  createIframe_() {
+    const iframe = document.createElement('iframe');
+    iframe.style.position = 'absolute';
+    iframe.style.top = '0';
+    iframe.style.left = '0';
+    iframe.style.width = '100%';
+    iframe.style.height = '100%';
+    iframe.style.border = '0';
+    iframe.style.transition = 'transform 0.3s ease-out';
+    this.hostElement_.appendChild(iframe);
+    return iframe;
+  }
+
+  /**
+   * Places the viewer's iframe next to the current one, off screen unless it
+   * is the current one.
+   * @param {!Viewer} viewer
+   * @param {number} index
+   * @private
+   */
+  layout_(viewer, index) {
+    const iframe = this.iframes_.get(viewer);
+    iframe.style.visibility = '';
+    iframe.style.transform =
+      'translateX(' + ((index - this.currentIndex_) * 100) + '%)';
+  }
+}
@@ -14,16 +14,57 @@
  * limitations under the License.
  */
 
+import {ConnectionWarmer} from './connection-warmer';
+import {FrameBatcher} from './frame-batcher';
 import {History} from './history';
-import {ViewerMessaging} from './viewer-messaging';
+import {ViewerPerformance} from './viewer-performance';
+import {
+  ViewerMessaging,
+  VisibilityState,
+  isVisibilityState,
+} from './viewer-messaging';
 import {constructViewerCacheUrl} from './amp-url-creator';
 import {log} from '../utils/log';
 import {parseUrl} from '../utils/url';
+import {PrerenderBudget, prerenderBudget} from './prerender-budget';
+
+/**
+ * Warms connections for every viewer on the page.
+ * @type {?ConnectionWarmer}
+ */
+let connectionWarmer = null;
+
+/**
+ * The AMP cache every viewer on the page loads AMP Docs from, the default
+ * one if undefined.
+ * @type {string|undefined}
+ */
+let cacheUrlAuthority = undefined;
+
+/**
+ * Whether viewers offer their AMP Doc a MessageChannel handshake, see
+ * Viewer.setHandshakePoll.
+ * @type {boolean}
+ */
+let handshakePoll = true;
+
+/** @const {!Promise} The answer to messages that need nothing done. */
+const RESOLVED = Promise.resolve();
+
+/**
+ * The messages an AMP Doc sends many times a second, which are delivered to
+ * subscribers once per animation frame.
+ * @enum {string}
+ */
+const FrameMessage = {
+  SCROLL: 'scroll',
+  DOCUMENT_HEIGHT: 'documentHeight',
+};
 
 /**
  * This file is a Viewer for AMP Documents.
  */
-class Viewer {
+export class Viewer {
 
   /**
    * @param {!Element} hostElement the element to attatch the iframe to.
@@ -44,14 +85,62 @@ class Viewer {
     /** @private {string} */
     this.referrer_ = opt_referrer;
 
-    /** @private {boolean|undefined} */
-    this.prerender_ = opt_prerender;
+    /** @private {string} */
+    this.visibilityState_ = opt_prerender ?
+      VisibilityState.PRERENDER : VisibilityState.VISIBLE;
 
     /** @private {?Element} */
     this.iframe_ = null;
 
+    /** @private {boolean} */
+    this.loadStarted_ = false;
+
+    /** @private {boolean} */
+    this.historyPushed_ = false;
+
+    /** @private {!ViewerPerformance} */
+    this.performance_ = new ViewerPerformance(ampDocUrl);
+
     /** @private {!History} */
     this.history_ = new History(this.handleChangeHistoryState_.bind(this));
+
+    /** @private {!FrameBatcher} */
+    this.frameBatcher_ = new FrameBatcher(window);
+
+    /** @private {!PrerenderBudget} */
+    this.prerenderBudget_ = prerenderBudget;
+  }
+
+  /**
+   * Makes this viewer take its prerender slot from budget rather than the
+   * one shared by every viewer on the page, see setMaxPrerenders. Call it
+   * before attach().
+   * @param {!PrerenderBudget} budget
+   */
+  setPrerenderBudget(budget) {
+    this.prerenderBudget_ = budget;
+  }
+
+  /**
+   * Registers a callback for the scroll position of the AMP Doc, e.g. to
+   * drive a progress bar. It is called at most once per animation frame with
+   * the latest position, {scrollTop: number}.
+   * @param {function(*)} callback
+   * @return {function()} unregisters the callback.
+   */
+  onScroll(callback) {
+    return this.frameBatcher_.subscribe(FrameMessage.SCROLL, callback);
+  }
+
+  /**
+   * Registers a callback for the height of the AMP Doc. It is called at most
+   * once per animation frame with the latest height, {height: number}.
+   * @param {function(*)} callback
+   * @return {function()} unregisters the callback.
+   */
+  onDocumentHeight(callback) {
+    return this.frameBatcher_.subscribe(FrameMessage.DOCUMENT_HEIGHT,
+      callback);
   }
 
   /**
@@ -77,36 +166,226 @@ class Viewer {
   }
 
   /**
-   * Attaches the AMP Doc Iframe to the Host Element.
+   * Sets how many viewers on the page may prerender at once. Prerendering
+   * viewers over the limit wait for a slot before loading their AMP Doc.
+   * @param {number} maxPrerenders
+   */
+  static setMaxPrerenders(maxPrerenders) {
+    prerenderBudget.setMaxPrerenders(maxPrerenders);
+  }
+
+  /**
+   * Sets the AMP cache every viewer on the page loads AMP Docs from, e.g.
+   * 'cdn.ampproject.org', or 'http://localhost:8100' for a local stand-in.
+   * Call it before attaching any viewer.
+   * @param {string} authority
    */
-  attach() {
-    this.iframe_ = document.createElement('iframe');
+  static setCacheUrlAuthority(authority) {
+    cacheUrlAuthority = authority;
+    connectionWarmer = null;
+  }
+
+  /**
+   * Whether the viewers attached from now on offer their AMP Doc a
+   * MessageChannel port for the handshake, advertised with the
+   * 'handshakepoll' capability, so its messages arrive on a port of their own
+   * rather than on the window. On by default; turned off, the AMP Doc opens
+   * the channel on the window.
+   * @param {boolean} enabled
+   */
+  static setHandshakePoll(enabled) {
+    handshakePoll = enabled;
+  }
+
+  /**
+   * @return {string|undefined} the AMP cache set by setCacheUrlAuthority.
+   */
+  static getCacheUrlAuthority() {
+    return cacheUrlAuthority;
+  }
+
+  /**
+   * Opens connections to the AMP cache for AMP Docs the user is likely to
+   * open next, e.g. the links on screen, so a tap doesn't wait on DNS, TCP
+   * and TLS.
+   * @param {!Array<string>} urls the AMP Doc urls.
+   * @return {!Promise}
+   */
+  static warm(urls) {
+    if (!connectionWarmer) {
+      connectionWarmer =
+        new ConnectionWarmer(undefined, undefined, cacheUrlAuthority);
+    }
+    return connectionWarmer.warm(urls);
+  }
+
+  /**
+   * Attaches the AMP Doc Iframe to the Host Element. A prerendering viewer
+   * only starts loading once it gets a slot in the prerender budget, or is
+   * made visible.
+   * @param {HTMLIFrameElement=} opt_iframe an iframe to load the AMP Doc into
+   *   instead of creating a new one, e.g. one handed back by release().
+   */
+  attach(opt_iframe) {
+    this.performance_.mark('attachStart');
+    this.iframe_ = opt_iframe || document.createElement('iframe');
     // TODO (chenshay): iframe_.setAttribute('scrolling', 'no')
     // to enable the scrolling workarounds for iOS.
 
+    if (this.visibilityState_ == VisibilityState.PRERENDER &&
+        !this.prerenderBudget_.tryAcquire(this)) {
+      log('prerender budget exhausted, waiting for a slot');
+      this.prerenderBudget_.enqueue(this, this.load_.bind(this));
+      return;
+    }
+    this.load_();
+  }
+
+  /**
+   * Points the iframe at the AMP Doc and starts messaging with it.
+   * @private
+   */
+  load_() {
+    if (this.loadStarted_ || !this.iframe_) {
+      return;
+    }
+    this.loadStarted_ = true;
+
     this.buildIframeSrc_().then(ampDocCachedUrl => {
+      if (!this.iframe_) {
+        // Released or unattached before the url was ready.
+        return;
+      }
+      this.performance_.mark('cacheUrlReady');
+      this.performance_.measure('cacheUrl', 'attachStart', 'cacheUrlReady');
+
       this.viewerMessaging_ = new ViewerMessaging(
         window,
         this.iframe_,
         parseUrl(ampDocCachedUrl).origin,
-        this.messageHandler_.bind(this));
+        this.messageHandler_.bind(this),
+        this.visibilityState_);
+      this.viewerMessaging_.setPerformance(this.performance_);
 
-      this.viewerMessaging_.start().then(()=>{
+      this.viewerMessaging_.start(handshakePoll).then(()=>{
         log('this.viewerMessaging_.start() Promise resolved !!!');
+        this.performance_.mark('handshakeComplete');
+        this.performance_.measure('handshake', 'srcSet', 'handshakeComplete');
       });
 
       this.iframe_.src = ampDocCachedUrl;
-      this.hostElement_.appendChild(this.iframe_);
-      this.history_.pushState(this.ampDocUrl_);
+      this.performance_.mark('srcSet');
+      // Moving an iframe in the DOM reloads it, so leave reused ones alone.
+      if (this.iframe_.parentNode != this.hostElement_) {
+        this.hostElement_.appendChild(this.iframe_);
+      }
+      if (this.visibilityState_ == VisibilityState.VISIBLE) {
+        this.pushHistory_();
+      }
     });
   }
 
+  /**
+   * Pushes the AMP Doc onto the history the first time it is shown.
+   * @private
+   */
+  pushHistory_() {
+    if (!this.historyPushed_) {
+      this.historyPushed_ = true;
+      this.history_.pushState(this.ampDocUrl_);
+    }
+  }
+
+  /**
+   * Sends the new visibility state to the AMP Doc. Leaving prerender frees
+   * this viewer's prerender slot. A viewer still waiting for a slot stays in
+   * line, and loads in whatever state it is in by the time it gets one,
+   * unless it is made visible, which loads it right away. Being shown for the
+   * first time also pushes the AMP Doc onto the history.
+   * @param {string} visibilityState one of VisibilityState.
+   */
+  setVisibilityState(visibilityState) {
+    if (!isVisibilityState(visibilityState)) {
+      throw new Error('Unknown visibility state: ' + visibilityState);
+    }
+    if (this.visibilityState_ == visibilityState) {
+      return;
+    }
+    const wasPrerender = this.visibilityState_ == VisibilityState.PRERENDER;
+    this.visibilityState_ = visibilityState;
+    if (visibilityState == VisibilityState.VISIBLE) {
+      this.performance_.mark('visible');
+    }
+
+    if (this.iframe_ && !this.loadStarted_) {
+      // Still waiting for a prerender slot. Only being shown jumps the line.
+      if (visibilityState == VisibilityState.VISIBLE) {
+        this.prerenderBudget_.release(this);
+        this.load_();
+      }
+      return;
+    }
+
+    // A viewer that was granted its slot while inactive holds it until it is
+    // shown.
+    if (wasPrerender || visibilityState == VisibilityState.VISIBLE) {
+      this.prerenderBudget_.release(this);
+    } else if (visibilityState == VisibilityState.PRERENDER &&
+        this.iframe_) {
+      // Count a demoted viewer against the budget if there's room. It is
+      // already loaded, so there's nothing to hold back if there isn't.
+      this.prerenderBudget_.tryAcquire(this);
+    }
+
+    if (this.viewerMessaging_) {
+      this.viewerMessaging_.setVisibilityState(visibilityState);
+    }
+    if (visibilityState == VisibilityState.VISIBLE && this.isLoaded_()) {
+      this.pushHistory_();
+    }
+  }
+
+  /**
+   * @return {!ViewerPerformance} the timings of this viewer.
+   */
+  getPerformance() {
+    return this.performance_;
+  }
+
+  /**
+   * @return {string} the visibility state of the AMP Doc.
+   */
+  getVisibilityState() {
+    return this.visibilityState_;
+  }
+
+  /**
+   * Stops talking to the AMP Doc and hands back its iframe, still in the Host
+   * Element, so it can be reused for another AMP Doc. The viewer can't be
+   * attached again afterwards.
+   * @return {?HTMLIFrameElement}
+   */
+  release() {
+    const iframe = this.iframe_;
+    if (this.viewerMessaging_) {
+      this.viewerMessaging_.stop();
+    }
+    this.prerenderBudget_.release(this);
+    this.frameBatcher_.cancel();
+    this.iframe_ = null;
+    this.viewerMessaging_ = null;
+    this.history_.dispose();
+    this.performance_.clear();
+    return iframe;
+  }
+
   /**
    * @return {!Promise<string>}
    */
   buildIframeSrc_() {
     return new Promise(resolve => {
-      constructViewerCacheUrl(this.ampDocUrl_, this.createInitParams_()).then(
+      constructViewerCacheUrl(this.ampDocUrl_, this.createInitParams_(),
+        cacheUrlAuthority).then(
         viewerCacheUrl => {
           resolve(viewerCacheUrl);
         }
@@ -124,12 +403,12 @@ class Viewer {
 
     const initParams = {
       'origin': parsedViewerUrl.origin,
-      'cap': 'history',
+      'cap': handshakePoll ? 'history,handshakepoll' : 'history',
     };
 
     if (this.referrer_) initParams['referrer'] = this.referrer_;
-    if (this.prerender_) {
-      initParams['visibilityState'] = 'prerender';
+    if (this.visibilityState_ != VisibilityState.VISIBLE) {
+      initParams['visibilityState'] = this.visibilityState_;
       initParams['prerenderSize'] = 1;
     }
 
@@ -142,9 +421,15 @@ class Viewer {
    */
   unAttach() {
     if (this.hideViewer_) this.hideViewer_();
-    this.hostElement_.removeChild(this.iframe_);
+    if (this.viewerMessaging_) this.viewerMessaging_.stop();
+    this.prerenderBudget_.release(this);
+    this.frameBatcher_.cancel();
+    if (this.iframe_.parentNode == this.hostElement_) {
+      this.hostElement_.removeChild(this.iframe_);
+    }
     this.iframe_ = null;
     this.viewerMessaging_ = null;
+    this.performance_.clear();
   }
   
   /**
@@ -171,6 +456,12 @@ class Viewer {
    * @private
    */
   messageHandler_(name, data, rsvp) {
+    // These arrive with every scrolled frame, so they skip the logging and
+    // leave the work to the next animation frame.
+    if (name == FrameMessage.SCROLL || name == FrameMessage.DOCUMENT_HEIGHT) {
+      this.frameBatcher_.push(name, data);
+      return RESOLVED;
+    }
     log('messageHandler: ', name, data, rsvp);
     switch(name) {
       case 'pushHistory':
@@ -179,16 +470,21 @@ class Viewer {
       case 'popHistory':
         this.history_.goBack();
         return Promise.resolve();
-      case 'cancelFullOverlay':
       case 'documentLoaded':
-      case 'documentHeight':
+        this.performance_.mark('documentLoaded');
+        this.performance_.measure(
+          'documentLoad', 'attachStart', 'documentLoaded');
+        return Promise.resolve();
       case 'prerenderComplete':
+        this.performance_.mark('prerenderComplete');
+        this.performance_.measure(
+          'prerender', 'attachStart', 'prerenderComplete');
+        return Promise.resolve();
+      case 'cancelFullOverlay':
       case 'requestFullOverlay':
-      case 'scroll':
         return Promise.resolve();
       default:
         return Promise.reject(name + ' Message is not supported!');
     }
   }
 }
-window.Viewer = Viewer;
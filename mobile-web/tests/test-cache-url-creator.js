@@ -14,7 +14,11 @@
  * limitations under the License.
  */
 
-import { constructViewerCacheUrl } from "../src/amp-url-creator";
+import ampToolboxCacheUrl from "amp-toolbox-cache-url";
+import {
+  constructRuntimeUrl,
+  constructViewerCacheUrl
+} from "../src/amp-url-creator";
 
 const initParams = {
   origin: "http://localhost:8000"
@@ -53,4 +57,65 @@ describe("Tests for CacheUrlCreator", () => {
       );
     });
   });
+
+  it("should use the scheme of a cache authority that names one", () => {
+    return constructViewerCacheUrl(
+      "https://www.example.com/foo",
+      initParams,
+      "http://localhost:8100"
+    ).then(output => {
+      expect(output).to.equal(
+        "http://www-example-com.localhost:8100/v/s/www.example.com/foo?amp_js_v=0.1#origin=http%3A%2F%2Flocalhost%3A8000"
+      );
+    });
+  });
+
+  it("should construct the runtime url of the current version", () => {
+    expect(constructRuntimeUrl()).to.equal("https://cdn.ampproject.org/v0.js");
+    expect(constructRuntimeUrl("http://localhost:8100")).to.equal(
+      "http://localhost:8100/v0.js"
+    );
+  });
+
+  it("should construct the runtime url of a given version", () => {
+    expect(constructRuntimeUrl(undefined, "011912201807310")).to.equal(
+      "https://cdn.ampproject.org/rtv/011912201807310/v0.js"
+    );
+  });
+
+  describe("CURLS subdomain memoization", () => {
+    beforeEach(() => {
+      sinon.spy(ampToolboxCacheUrl, "createCurlsSubdomain");
+    });
+
+    afterEach(() => {
+      ampToolboxCacheUrl.createCurlsSubdomain.restore();
+    });
+
+    it("should compute the subdomain once per publisher origin", () => {
+      return Promise.all([
+        constructViewerCacheUrl("https://memo.example.com/a", initParams),
+        constructViewerCacheUrl("https://memo.example.com/b", initParams)
+      ]).then(outputs => {
+        expect(ampToolboxCacheUrl.createCurlsSubdomain).to.have.been
+          .calledOnce;
+        expect(outputs[0]).to.equal(
+          "https://memo-example-com.cdn.ampproject.org/v/s/memo.example.com/a?amp_js_v=0.1#origin=http%3A%2F%2Flocalhost%3A8000"
+        );
+        expect(outputs[1]).to.equal(
+          "https://memo-example-com.cdn.ampproject.org/v/s/memo.example.com/b?amp_js_v=0.1#origin=http%3A%2F%2Flocalhost%3A8000"
+        );
+      });
+    });
+
+    it("should compute the subdomain of each origin separately", () => {
+      return Promise.all([
+        constructViewerCacheUrl("https://one.example.com/", initParams),
+        constructViewerCacheUrl("http://one.example.com/", initParams)
+      ]).then(() => {
+        expect(ampToolboxCacheUrl.createCurlsSubdomain).to.have.been
+          .calledTwice;
+      });
+    });
+  });
 });
@@ -0,0 +1,161 @@
+/**
+ * Copyright 2020 The AMP HTML Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS-IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+import { CacheUrlWorkerClient } from "../src/cache-url-worker-client";
+import {
+  CONSTRUCT_VIEWER_CACHE_URLS_MSG,
+  answerCacheUrlsRequest
+} from "../src/cache-url-worker";
+
+const initParams = {
+  origin: "http://localhost:8000"
+};
+
+const EXAMPLE_CACHE_URL =
+  "https://www-example-com.cdn.ampproject.org/v/s/www.example.com/foo?amp_js_v=0.1#origin=http%3A%2F%2Flocalhost%3A8000";
+
+/**
+ * Stands in for a Worker, recording what it is sent and letting the test
+ * dispatch its replies and errors.
+ */
+class FakeWorker {
+  constructor(url) {
+    this.url = url;
+    this.messages = [];
+    this.listeners = {};
+    this.terminated = false;
+    FakeWorker.instances.push(this);
+  }
+
+  addEventListener(type, listener) {
+    this.listeners[type] = listener;
+  }
+
+  postMessage(data) {
+    this.messages.push(data);
+  }
+
+  terminate() {
+    this.terminated = true;
+  }
+
+  dispatch(type, event) {
+    this.listeners[type](event);
+  }
+}
+
+describe("Tests for CacheUrlWorkerClient", () => {
+  let originalWorker;
+  let client;
+
+  beforeEach(() => {
+    originalWorker = window.Worker;
+    FakeWorker.instances = [];
+    window.Worker = FakeWorker;
+    client = new CacheUrlWorkerClient("test-worker.js");
+  });
+
+  afterEach(() => {
+    window.Worker = originalWorker;
+  });
+
+  it("should send the request to the worker and resolve with its reply", () => {
+    const result = client.constructViewerCacheUrls(
+      ["https://www.example.com/foo"],
+      initParams
+    );
+    expect(FakeWorker.instances).to.have.length(1);
+    const worker = FakeWorker.instances[0];
+    expect(worker.url).to.equal("test-worker.js");
+    const message = worker.messages[0];
+    expect(message.name).to.equal(CONSTRUCT_VIEWER_CACHE_URLS_MSG);
+    expect(message.urls).to.deep.equal(["https://www.example.com/foo"]);
+
+    worker.dispatch("message", {
+      data: { id: message.id, cacheUrls: ["cache-url"] }
+    });
+    return result.then(cacheUrls => {
+      expect(cacheUrls).to.deep.equal(["cache-url"]);
+    });
+  });
+
+  it("should build pending urls on the main thread when the worker fails", () => {
+    const result = client.constructViewerCacheUrls(
+      ["https://www.example.com/foo"],
+      initParams
+    );
+    const worker = FakeWorker.instances[0];
+    worker.dispatch("error", new Event("error"));
+    expect(worker.terminated).to.be.true;
+    return result.then(cacheUrls => {
+      expect(cacheUrls).to.deep.equal([EXAMPLE_CACHE_URL]);
+      return client.constructViewerCacheUrls(
+        ["https://www.example.com/foo"],
+        initParams
+      );
+    }).then(cacheUrls => {
+      expect(FakeWorker.instances).to.have.length(1);
+      expect(cacheUrls).to.deep.equal([EXAMPLE_CACHE_URL]);
+    });
+  });
+
+  it("should reject pending requests when terminated", () => {
+    const result = client.constructViewerCacheUrls(
+      ["https://www.example.com/foo"],
+      initParams
+    );
+    client.terminate();
+    expect(FakeWorker.instances[0].terminated).to.be.true;
+    return result.then(
+      () => {
+        throw new Error("should have been rejected");
+      },
+      error => {
+        expect(error).to.be.an("error");
+      }
+    );
+  });
+
+  it("should build urls on the main thread without Worker support", () => {
+    window.Worker = undefined;
+    return client
+      .constructViewerCacheUrls(["https://www.example.com/foo"], initParams)
+      .then(cacheUrls => {
+        expect(cacheUrls).to.deep.equal([EXAMPLE_CACHE_URL]);
+      });
+  });
+});
+
+describe("Tests for the cache url worker", () => {
+  it("should answer a request with one cache url per publisher url", () => {
+    return answerCacheUrlsRequest({
+      name: CONSTRUCT_VIEWER_CACHE_URLS_MSG,
+      id: 7,
+      urls: ["https://www.example.com/foo"],
+      initParams
+    }).then(response => {
+      expect(response).to.deep.equal({
+        id: 7,
+        cacheUrls: [EXAMPLE_CACHE_URL]
+      });
+    });
+  });
+
+  it("should ignore other messages", () => {
+    expect(answerCacheUrlsRequest({ name: "other" })).to.be.null;
+    expect(answerCacheUrlsRequest(null)).to.be.null;
+  });
+});
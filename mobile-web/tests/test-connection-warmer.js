@@ -0,0 +1,62 @@
+/**
+ * Copyright 2020 The AMP HTML Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS-IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+import { ConnectionWarmer } from "../src/connection-warmer";
+
+describe("Tests for ConnectionWarmer", () => {
+  let doc;
+
+  beforeEach(() => {
+    doc = document.implementation.createHTMLDocument("");
+  });
+
+  function hints(rel) {
+    return Array.prototype.map.call(
+      doc.head.querySelectorAll('link[rel="' + rel + '"]'),
+      link => link.getAttribute("href")
+    );
+  }
+
+  it("should add preconnect and dns-prefetch hints once per origin", () => {
+    const warmer = new ConnectionWarmer(doc);
+    return warmer
+      .warm([
+        "https://www.ampproject.org/a",
+        "https://www.ampproject.org/b"
+      ])
+      .then(() => {
+        expect(hints("preconnect")).to.deep.equal([
+          "https://cdn.ampproject.org",
+          "https://www-ampproject-org.cdn.ampproject.org"
+        ]);
+        expect(hints("dns-prefetch")).to.have.length(2);
+      });
+  });
+
+  it("should drop the least recently warmed origin over the cap", () => {
+    const warmer = new ConnectionWarmer(doc, 2);
+    warmer.warmOrigin("https://a.example");
+    warmer.warmOrigin("https://b.example");
+    warmer.warmOrigin("https://a.example");
+    warmer.warmOrigin("https://c.example");
+    expect(warmer.isWarm("https://a.example")).to.be.true;
+    expect(warmer.isWarm("https://b.example")).to.be.false;
+    expect(hints("preconnect")).to.deep.equal([
+      "https://a.example",
+      "https://c.example"
+    ]);
+  });
+});
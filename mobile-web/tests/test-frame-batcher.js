@@ -0,0 +1,86 @@
+/**
+ * Copyright 2020 The AMP HTML Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS-IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+import { FrameBatcher } from "../src/frame-batcher";
+
+describe("Tests for FrameBatcher", () => {
+  let frames;
+  let batcher;
+
+  beforeEach(() => {
+    frames = [];
+    const win = {
+      requestAnimationFrame: callback => frames.push(callback),
+      cancelAnimationFrame: id => {
+        frames[id - 1] = null;
+      }
+    };
+    batcher = new FrameBatcher(win);
+  });
+
+  function runFrame() {
+    const pending = frames.filter(Boolean);
+    frames = [];
+    pending.forEach(callback => callback());
+  }
+
+  it("should deliver the latest value once per frame", () => {
+    const callback = sinon.spy();
+    batcher.subscribe("scroll", callback);
+    batcher.push("scroll", { scrollTop: 1 });
+    batcher.push("scroll", { scrollTop: 2 });
+    batcher.push("scroll", { scrollTop: 3 });
+    expect(frames).to.have.length(1);
+    expect(callback).to.not.have.been.called;
+
+    runFrame();
+    expect(callback).to.have.been.calledOnceWith({ scrollTop: 3 });
+    runFrame();
+    expect(callback).to.have.been.calledOnce;
+  });
+
+  it("should deliver each stream in the same frame", () => {
+    const scroll = sinon.spy();
+    const height = sinon.spy();
+    batcher.subscribe("scroll", scroll);
+    batcher.subscribe("documentHeight", height);
+    batcher.push("scroll", { scrollTop: 1 });
+    batcher.push("documentHeight", { height: 100 });
+    expect(frames).to.have.length(1);
+
+    runFrame();
+    expect(scroll).to.have.been.calledOnceWith({ scrollTop: 1 });
+    expect(height).to.have.been.calledOnceWith({ height: 100 });
+  });
+
+  it("should not schedule a frame without subscribers", () => {
+    batcher.push("scroll", { scrollTop: 1 });
+    const unsubscribe = batcher.subscribe("scroll", () => {});
+    unsubscribe();
+    batcher.push("scroll", { scrollTop: 2 });
+    expect(frames).to.have.length(0);
+  });
+
+  it("should drop undelivered values when cancelled", () => {
+    const callback = sinon.spy();
+    batcher.subscribe("scroll", callback);
+    batcher.push("scroll", { scrollTop: 1 });
+    batcher.cancel();
+    runFrame();
+    expect(callback).to.not.have.been.called;
+  });
+});
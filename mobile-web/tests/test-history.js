@@ -0,0 +1,65 @@
+/**
+ * Copyright 2020 The AMP HTML Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS-IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+import { HistoryCoordinator } from "../src/history";
+
+describe("Tests for HistoryCoordinator", () => {
+  let coordinator;
+
+  beforeEach(() => {
+    coordinator = new HistoryCoordinator();
+  });
+
+  it("should hand an entry back to the History that pushed it", () => {
+    const owner = sinon.spy();
+    const other = sinon.spy();
+    const ownerId = coordinator.register(owner);
+    coordinator.register(other);
+
+    coordinator.handlePopState_({
+      state: { isAMP: true, viewerHistoryId: ownerId }
+    });
+    expect(owner).to.have.been.calledWith(false, true);
+    expect(other).to.not.have.been.called;
+  });
+
+  it("should hand the last back to every History", () => {
+    const first = sinon.spy();
+    const second = sinon.spy();
+    coordinator.register(first);
+    coordinator.register(second);
+
+    coordinator.handlePopState_({ state: null });
+    expect(first).to.have.been.calledWith(true, false);
+    expect(second).to.have.been.calledWith(true, false);
+  });
+
+  it("should listen for popstate once while there are Histories", () => {
+    const addEventListener = sinon.spy(window, "addEventListener");
+    const removeEventListener = sinon.spy(window, "removeEventListener");
+    const ids = [
+      coordinator.register(() => {}),
+      coordinator.register(() => {})
+    ];
+    expect(addEventListener).to.have.been.calledOnceWith("popstate");
+
+    ids.forEach(id => coordinator.unregister(id));
+    expect(removeEventListener).to.have.been.calledOnceWith("popstate");
+    addEventListener.restore();
+    removeEventListener.restore();
+  });
+});
@@ -0,0 +1,216 @@
+/**
+ * Copyright 2020 The AMP HTML Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS-IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+import { LinkPrefetchController } from "../src/link-prefetch-controller";
+import { Viewer } from "../src/viewer";
+import { VisibilityState } from "../src/viewer-messaging";
+import { prerenderBudget } from "../src/prerender-budget";
+
+describe("Tests for LinkPrefetchController", () => {
+  let clock;
+  let warm;
+  let controller;
+
+  beforeEach(() => {
+    clock = sinon.useFakeTimers();
+    warm = sinon.stub(Viewer, "warm");
+    controller = new LinkPrefetchController(document.createElement("div"), {
+      dwellTime: 100,
+      prefetch: false,
+      prerender: false
+    });
+  });
+
+  afterEach(() => {
+    controller.destroy();
+    warm.restore();
+    clock.restore();
+  });
+
+  function link(url) {
+    const el = document.createElement("a");
+    el.setAttribute("href", url);
+    return el;
+  }
+
+  function intersect(target, isIntersecting) {
+    controller.handleIntersections_([
+      { target, isIntersecting, intersectionRatio: isIntersecting ? 1 : 0 }
+    ]);
+  }
+
+  it("should warm links that stay near the viewport", () => {
+    const a = link("https://www.ampproject.org/a");
+    intersect(a, true);
+    expect(warm).to.not.have.been.called;
+    clock.tick(100);
+    expect(warm).to.have.been.calledWith(["https://www.ampproject.org/a"]);
+  });
+
+  it("should skip links that leave before the dwell time", () => {
+    const a = link("https://www.ampproject.org/a");
+    intersect(a, true);
+    clock.tick(50);
+    intersect(a, false);
+    clock.tick(100);
+    expect(warm).to.not.have.been.called;
+  });
+
+  describe("prefetch", () => {
+    let cacheUrls;
+
+    beforeEach(() => {
+      controller.destroy();
+      cacheUrls = null;
+      controller = new LinkPrefetchController(document.createElement("div"), {
+        dwellTime: 100,
+        prerender: false,
+        cacheUrlClient: {
+          constructViewerCacheUrls(urls) {
+            cacheUrls = Promise.resolve(
+              urls.map(url => url.replace("www.", "cache.") + "#origin=x")
+            );
+            return cacheUrls;
+          }
+        }
+      });
+    });
+
+    function prefetchLinks() {
+      return Array.prototype.slice.call(
+        document.head.querySelectorAll("link[rel=prefetch]")
+      );
+    }
+
+    it("should prefetch the AMP Docs of links near the viewport", () => {
+      const a = link("https://www.ampproject.org/a");
+      intersect(a, true);
+      clock.tick(100);
+      return cacheUrls.then(() => {
+        const prefetches = prefetchLinks();
+        expect(prefetches).to.have.length(1);
+        expect(prefetches[0].href).to.equal("https://cache.ampproject.org/a");
+        intersect(a, false);
+        expect(prefetchLinks()).to.have.length(0);
+      });
+    });
+
+    it("should keep a prefetch while another link to the AMP Doc is near", () => {
+      const a = link("https://www.ampproject.org/a");
+      const otherA = link("https://www.ampproject.org/a");
+      intersect(a, true);
+      intersect(otherA, true);
+      clock.tick(100);
+      return cacheUrls.then(() => {
+        expect(prefetchLinks()).to.have.length(1);
+        intersect(a, false);
+        expect(prefetchLinks()).to.have.length(1);
+        intersect(otherA, false);
+        expect(prefetchLinks()).to.have.length(0);
+      });
+    });
+  });
+
+  describe("prerender", () => {
+    let host;
+    let buildIframeSrc;
+    let viewers;
+
+    beforeEach(() => {
+      controller.destroy();
+      viewers = [];
+      buildIframeSrc = sinon
+        .stub(Viewer.prototype, "buildIframeSrc_")
+        .returns(new Promise(() => {}));
+      host = document.createElement("div");
+      controller = new LinkPrefetchController(host, {
+        dwellTime: 100,
+        prefetch: false,
+        maxPrerenders: 1
+      });
+    });
+
+    afterEach(() => {
+      viewers.forEach(viewer => viewer.release());
+      buildIframeSrc.restore();
+    });
+
+    function take(target) {
+      const viewer = controller.takeViewer(target);
+      viewers.push(viewer);
+      return viewer;
+    }
+
+    it("should prerender the link near the viewport in a hidden iframe", () => {
+      const a = link("https://www.ampproject.org/a");
+      intersect(a, true);
+      expect(controller.getPrerenderedUrl()).to.be.null;
+      clock.tick(100);
+      expect(controller.getPrerenderedUrl()).to.equal(
+        "https://www.ampproject.org/a"
+      );
+      const viewer = controller.prerenderedViewer_;
+      expect(viewer.getVisibilityState()).to.equal(VisibilityState.PRERENDER);
+      expect(viewer.iframe_.style.visibility).to.equal("hidden");
+    });
+
+    it("should keep maxPrerenders to its own viewers", () => {
+      const maxPrerenders = prerenderBudget.getMaxPrerenders();
+      const a = link("https://www.ampproject.org/a");
+      intersect(a, true);
+      clock.tick(100);
+      const viewer = controller.prerenderedViewer_;
+      expect(viewer.prerenderBudget_).to.not.equal(prerenderBudget);
+      expect(viewer.prerenderBudget_.getMaxPrerenders()).to.equal(1);
+      expect(prerenderBudget.getMaxPrerenders()).to.equal(maxPrerenders);
+    });
+
+    it("should drop the prerender when its link leaves", () => {
+      const a = link("https://www.ampproject.org/a");
+      intersect(a, true);
+      clock.tick(100);
+      const viewer = controller.prerenderedViewer_;
+      intersect(a, false);
+      expect(controller.getPrerenderedUrl()).to.be.null;
+      expect(viewer.iframe_).to.be.null;
+    });
+
+    it("should hand over and show the prerendered viewer", () => {
+      const a = link("https://www.ampproject.org/a");
+      intersect(a, true);
+      clock.tick(100);
+      const prerendered = controller.prerenderedViewer_;
+      const viewer = take(a);
+      expect(viewer).to.equal(prerendered);
+      expect(viewer.getVisibilityState()).to.equal(VisibilityState.VISIBLE);
+      expect(viewer.iframe_.style.visibility).to.equal("");
+      expect(controller.getPrerenderedUrl()).to.be.null;
+    });
+
+    it("should attach a new viewer for a link that isn't prerendered", () => {
+      const a = link("https://www.ampproject.org/a");
+      const b = link("https://www.ampproject.org/b");
+      intersect(a, true);
+      clock.tick(100);
+      const prerendered = controller.prerenderedViewer_;
+      const viewer = take(b);
+      expect(viewer).to.not.equal(prerendered);
+      expect(viewer.getVisibilityState()).to.equal(VisibilityState.VISIBLE);
+      expect(prerendered.iframe_).to.be.null;
+      expect(controller.getPrerenderedUrl()).to.be.null;
+    });
+  });
+});
@@ -0,0 +1,125 @@
+/**
+ * Copyright 2020 The AMP HTML Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS-IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+import { MessageRouter, RoutedWindowPort } from "../src/message-router";
+
+describe("Tests for MessageRouter", () => {
+  let router;
+  let addEventListener;
+  let iframes;
+
+  beforeEach(() => {
+    addEventListener = sinon.spy(window, "addEventListener");
+    router = new MessageRouter(window);
+    iframes = [];
+  });
+
+  afterEach(() => {
+    addEventListener.restore();
+    iframes.forEach(iframe => iframe.parentNode.removeChild(iframe));
+  });
+
+  function createIframe() {
+    const iframe = document.createElement("iframe");
+    document.body.appendChild(iframe);
+    iframes.push(iframe);
+    return iframe;
+  }
+
+  function post(source, origin, data) {
+    window.dispatchEvent(new MessageEvent("message", { data, origin, source }));
+  }
+
+  it("should route messages by source window", () => {
+    const first = createIframe();
+    const second = createIframe();
+    const firstHandler = sinon.spy();
+    const secondHandler = sinon.spy();
+    router.listen(first, "https://a.example", firstHandler);
+    router.listen(second, "https://b.example", secondHandler);
+
+    post(second.contentWindow, "https://b.example", "hello");
+    expect(firstHandler).to.not.have.been.called;
+    expect(secondHandler).to.have.been.calledOnce;
+    expect(secondHandler.firstCall.args[0].data).to.equal("hello");
+  });
+
+  it("should drop messages from the wrong origin or window", () => {
+    const iframe = createIframe();
+    const handler = sinon.spy();
+    router.listen(iframe, "https://a.example", handler);
+
+    post(iframe.contentWindow, "https://evil.example", "hello");
+    post(createIframe().contentWindow, "https://a.example", "hello");
+    expect(handler).to.not.have.been.called;
+  });
+
+  it("should listen on the window once while there are routes", () => {
+    const unlisteners = [createIframe(), createIframe(), createIframe()].map(
+      iframe => router.listen(iframe, "https://a.example", () => {})
+    );
+    const messageListeners = addEventListener
+      .getCalls()
+      .filter(call => call.args[0] == "message");
+    expect(messageListeners).to.have.length(1);
+
+    const removeEventListener = sinon.spy(window, "removeEventListener");
+    unlisteners.forEach(unlisten => unlisten());
+    expect(router.getRouteCount()).to.equal(0);
+    expect(removeEventListener).to.have.been.calledWith(
+      "message",
+      messageListeners[0].args[1]
+    );
+    removeEventListener.restore();
+  });
+
+  it("should route to iframes added before they had a window", () => {
+    const iframe = document.createElement("iframe");
+    const handler = sinon.spy();
+    router.listen(iframe, "https://a.example", handler);
+    document.body.appendChild(iframe);
+    iframes.push(iframe);
+
+    post(iframe.contentWindow, "https://a.example", "hello");
+    expect(handler).to.have.been.calledOnce;
+  });
+
+  it("should replace the handler of an iframe", () => {
+    const iframe = createIframe();
+    const older = sinon.spy();
+    const newer = sinon.spy();
+    const unlistenOlder = router.listen(iframe, "https://a.example", older);
+    router.listen(iframe, "https://a.example", newer);
+    unlistenOlder();
+
+    post(iframe.contentWindow, "https://a.example", "hello");
+    expect(older).to.not.have.been.called;
+    expect(newer).to.have.been.calledOnce;
+  });
+
+  it("should stop delivering to a closed port", () => {
+    const iframe = createIframe();
+    const handler = sinon.spy();
+    const port = new RoutedWindowPort(window, iframe, "https://a.example");
+    port.addEventListener("message", handler);
+    port.close();
+
+    post(iframe.contentWindow, "https://a.example", "hello");
+    expect(handler).to.not.have.been.called;
+    expect(MessageRouter.forWindow(window).getRouteCount()).to.equal(0);
+  });
+});
@@ -0,0 +1,62 @@
+/**
+ * Copyright 2020 The AMP HTML Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS-IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+import { PrerenderBudget } from "../src/prerender-budget";
+
+describe("Tests for PrerenderBudget", () => {
+  it("should grant slots up to the max", () => {
+    const budget = new PrerenderBudget(2);
+    expect(budget.tryAcquire("a")).to.be.true;
+    expect(budget.tryAcquire("b")).to.be.true;
+    expect(budget.tryAcquire("c")).to.be.false;
+    expect(budget.tryAcquire("a")).to.be.true;
+    expect(budget.getPrerenderCount()).to.equal(2);
+  });
+
+  it("should hand released slots to waiting holders in order", () => {
+    const budget = new PrerenderBudget(1);
+    const granted = [];
+    budget.tryAcquire("a");
+    budget.enqueue("b", () => granted.push("b"));
+    budget.enqueue("c", () => granted.push("c"));
+    expect(granted).to.deep.equal([]);
+
+    budget.release("a");
+    expect(granted).to.deep.equal(["b"]);
+    budget.release("b");
+    expect(granted).to.deep.equal(["b", "c"]);
+  });
+
+  it("should not grant a slot to a cancelled holder", () => {
+    const budget = new PrerenderBudget(1);
+    const granted = [];
+    budget.tryAcquire("a");
+    budget.enqueue("b", () => granted.push("b"));
+    budget.cancel("b");
+    budget.release("a");
+    expect(granted).to.deep.equal([]);
+    expect(budget.getPrerenderCount()).to.equal(0);
+  });
+
+  it("should grant waiting holders when the max is raised", () => {
+    const budget = new PrerenderBudget(0);
+    const granted = [];
+    budget.enqueue("a", () => granted.push("a"));
+    expect(granted).to.deep.equal([]);
+    budget.setMaxPrerenders(1);
+    expect(granted).to.deep.equal(["a"]);
+  });
+});
@@ -0,0 +1,70 @@
+/**
+ * Copyright 2020 The AMP HTML Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS-IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+import { parseUrl } from "../utils/url";
+
+describe("Tests for parseUrl", () => {
+  it("should parse all url parts", () => {
+    const parsed = parseUrl("https://www.example.com:8443/foo/bar?amp=1#hash");
+    expect(parsed.href).to.equal(
+      "https://www.example.com:8443/foo/bar?amp=1#hash"
+    );
+    expect(parsed.protocol).to.equal("https:");
+    expect(parsed.host).to.equal("www.example.com:8443");
+    expect(parsed.hostname).to.equal("www.example.com");
+    expect(parsed.port).to.equal("8443");
+    expect(parsed.pathname).to.equal("/foo/bar");
+    expect(parsed.search).to.equal("?amp=1");
+    expect(parsed.hash).to.equal("#hash");
+    expect(parsed.origin).to.equal("https://www.example.com:8443");
+  });
+
+  it("should drop default ports", () => {
+    const parsed = parseUrl("http://www.example.com:80/");
+    expect(parsed.port).to.equal("");
+    expect(parsed.origin).to.equal("http://www.example.com");
+  });
+
+  it("should resolve relative urls against the current location", () => {
+    const parsed = parseUrl("/amp/s/www.example.com");
+    expect(parsed.origin).to.equal(window.location.origin);
+    expect(parsed.pathname).to.equal("/amp/s/www.example.com");
+  });
+
+  it("should return the cached result for the same url", () => {
+    const url = "https://www.ampproject.org/cached";
+    expect(parseUrl(url)).to.equal(parseUrl(url));
+    expect(Object.isFrozen(parseUrl(url))).to.be.true;
+  });
+
+  it("should resolve relative urls against the location after pushState", () => {
+    const href = window.location.href;
+    try {
+      window.history.pushState(null, "", "/first/page.html");
+      expect(parseUrl("next.html").pathname).to.equal("/first/next.html");
+      window.history.pushState(null, "", "/second/page.html");
+      expect(parseUrl("next.html").pathname).to.equal("/second/next.html");
+    } finally {
+      window.history.replaceState(null, "", href);
+    }
+  });
+
+  it("should not throw on urls URL rejects", () => {
+    const parsed = parseUrl("http://exa mple.com/");
+    expect(parsed.href).to.be.a("string");
+    expect(Object.isFrozen(parsed)).to.be.true;
+  });
+});
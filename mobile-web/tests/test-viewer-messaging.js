@@ -0,0 +1,235 @@
+/**
+ * Copyright 2020 The AMP HTML Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS-IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+import { APP, Messaging } from "amp-viewer-messaging/messaging";
+import { ViewerMessaging } from "../src/viewer-messaging";
+
+describe("Tests for ViewerMessaging", () => {
+  let sendRequest;
+  let viewerMessaging;
+
+  beforeEach(() => {
+    sendRequest = sinon
+      .stub(Messaging.prototype, "sendRequest")
+      .callsFake(type => Promise.resolve(type + "-response"));
+    viewerMessaging = new ViewerMessaging(
+      window,
+      document.createElement("iframe"),
+      "https://example-com.cdn.ampproject.org",
+      () => {},
+      "prerender"
+    );
+    viewerMessaging.start();
+  });
+
+  afterEach(() => {
+    viewerMessaging.stop();
+    sendRequest.restore();
+  });
+
+  function completeHandshake() {
+    viewerMessaging.completeHandshake_(new MessageChannel().port1, "1");
+  }
+
+  it("should report no handshake attempts when the AMP Doc opened the channel", () => {
+    const count = sinon.spy();
+    viewerMessaging.setPerformance({ count, duration() {}, now: Date.now });
+    completeHandshake();
+    expect(count).to.have.been.calledWith("handshakeAttempts", 0);
+  });
+
+  it("should queue requests until the handshake", () => {
+    const promise = viewerMessaging.sendRequest("scroll", { y: 1 }, true);
+    expect(sendRequest).to.not.have.been.called;
+
+    completeHandshake();
+    expect(sendRequest).to.have.been.calledWith("scroll", { y: 1 }, true);
+    return promise.then(response => {
+      expect(response).to.equal("scroll-response");
+    });
+  });
+
+  it("should send the visibility state first and only once", () => {
+    viewerMessaging.sendRequest("scroll", { y: 1 }, false);
+    viewerMessaging.sendRequest(
+      "visibilitychange",
+      { state: "visible", prerenderSize: 1 },
+      false
+    );
+    viewerMessaging.sendRequest(
+      "visibilitychange",
+      { state: "inactive", prerenderSize: 1 },
+      false
+    );
+
+    completeHandshake();
+    expect(sendRequest).to.have.been.calledTwice;
+    expect(sendRequest.firstCall).to.have.been.calledWith(
+      "visibilitychange",
+      { state: "inactive", prerenderSize: 1 },
+      true
+    );
+    expect(sendRequest.secondCall.args[0]).to.equal("scroll");
+  });
+
+  it("should resolve coalesced visibility requests together", () => {
+    const first = viewerMessaging.sendRequest(
+      "visibilitychange",
+      { state: "visible" },
+      true
+    );
+    const second = viewerMessaging.sendRequest(
+      "visibilitychange",
+      { state: "inactive" },
+      true
+    );
+    completeHandshake();
+    return Promise.all([first, second]).then(responses => {
+      expect(responses).to.deep.equal([
+        "visibilitychange-response",
+        "visibilitychange-response"
+      ]);
+    });
+  });
+
+  it("should reject queued requests when stopped", () => {
+    const promise = viewerMessaging.sendRequest("scroll", {}, false);
+    viewerMessaging.stop();
+    return promise.then(
+      () => {
+        throw new Error("should have been rejected");
+      },
+      error => {
+        expect(error.message).to.contain("scroll");
+      }
+    );
+  });
+});
+
+describe("Tests for the ViewerMessaging handshake poll", () => {
+  let clock;
+  let sendRequest;
+  let iframe;
+  let offers;
+  let viewerMessaging;
+
+  beforeEach(() => {
+    clock = sinon.useFakeTimers({ toFake: ["setTimeout", "clearTimeout"] });
+    sendRequest = sinon
+      .stub(Messaging.prototype, "sendRequest")
+      .callsFake(() => Promise.resolve());
+    // Records the ports offered to the AMP Doc.
+    offers = [];
+    iframe = document.createElement("iframe");
+    Object.defineProperty(iframe, "contentWindow", {
+      value: {
+        postMessage: (message, origin, transfer) => {
+          if (message.name == "handshake-poll") {
+            offers.push(transfer[0]);
+          }
+        }
+      }
+    });
+    viewerMessaging = new ViewerMessaging(
+      window,
+      iframe,
+      "https://example-com.cdn.ampproject.org",
+      () => {}
+    );
+  });
+
+  afterEach(() => {
+    viewerMessaging.stop();
+    sendRequest.restore();
+    clock.restore();
+  });
+
+  /**
+   * Opens the channel on an offered port, like the AMP runtime.
+   * @return {!Promise<*>} the viewer's response.
+   */
+  function answer(port) {
+    return new Promise(resolve => {
+      port.onmessage = e => resolve(e.data);
+      port.postMessage({
+        app: APP,
+        name: "channelOpen",
+        requestid: 7,
+        type: "q"
+      });
+    });
+  }
+
+  it("should offer ports with backoff until one is answered", () => {
+    const handshake = viewerMessaging.start(true);
+    expect(offers).to.have.length(1);
+    clock.tick(50);
+    expect(offers).to.have.length(2);
+    clock.tick(100);
+    expect(offers).to.have.length(3);
+
+    const count = sinon.spy();
+    viewerMessaging.setPerformance({ count, duration() {}, now: Date.now });
+    const response = answer(offers[2]);
+    return Promise.all([handshake, response]).then(results => {
+      expect(results[1].requestid).to.equal(7);
+      expect(count).to.have.been.calledWith("handshakeAttempts", 3);
+      clock.tick(5000);
+      expect(offers).to.have.length(3);
+    });
+  });
+
+  it("should take the reply on an earlier offer after a retry", () => {
+    const handshake = viewerMessaging.start(true);
+    // The AMP Doc took the first offer, then a retry fired before its reply.
+    clock.tick(50);
+    expect(offers).to.have.length(2);
+
+    const response = answer(offers[0]);
+    return Promise.all([handshake, response]).then(results => {
+      expect(results[1].requestid).to.equal(7);
+      expect(viewerMessaging.getTimeToHandshake()).to.not.be.null;
+    });
+  });
+
+  it("should take the reply on an earlier offer after the iframe loads", () => {
+    const handshake = viewerMessaging.start(true);
+    iframe.dispatchEvent(new Event("load"));
+    expect(offers).to.have.length(2);
+
+    return Promise.all([handshake, answer(offers[0])]);
+  });
+
+  it("should keep offering after the iframe loads until one is answered", () => {
+    // The runtime wasn't listening yet when the offer made on load arrived.
+    const handshake = viewerMessaging.start(true);
+    iframe.dispatchEvent(new Event("load"));
+    expect(offers).to.have.length(2);
+    clock.tick(50);
+    expect(offers).to.have.length(3);
+
+    return Promise.all([handshake, answer(offers[2])]).then(() => {
+      clock.tick(5000);
+      expect(offers).to.have.length(3);
+    });
+  });
+
+  it("should give up offering after too many attempts", () => {
+    viewerMessaging.start(true);
+    clock.tick(60000);
+    expect(offers).to.have.length(25);
+  });
+});
@@ -0,0 +1,84 @@
+/**
+ * Copyright 2020 The AMP HTML Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS-IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+import {
+  ViewerPerformance,
+  onViewerTiming
+} from "../src/viewer-performance";
+
+describe("Tests for ViewerPerformance", () => {
+  let timings;
+  let unlisten;
+
+  beforeEach(() => {
+    timings = [];
+    unlisten = onViewerTiming(timing => timings.push(timing));
+  });
+
+  afterEach(() => {
+    unlisten();
+  });
+
+  it("should report marks and measures between them", () => {
+    const perf = new ViewerPerformance("https://www.ampproject.org");
+    perf.mark("attachStart");
+    perf.mark("srcSet");
+    perf.measure("src", "attachStart", "srcSet");
+
+    expect(timings.map(timing => timing.type + ":" + timing.name)).to.deep.equal(
+      ["mark:attachStart", "mark:srcSet", "measure:src"]
+    );
+    expect(timings[2].value).to.equal(
+      perf.getMark("srcSet") - perf.getMark("attachStart")
+    );
+    expect(timings[2].viewerId).to.equal(perf.viewerId);
+    expect(timings[2].ampDocUrl).to.equal("https://www.ampproject.org");
+    expect(
+      performance.getEntriesByName("amp-viewer:" + perf.viewerId + ":src")
+    ).to.have.length(1);
+  });
+
+  it("should skip measures whose marks didn't happen", () => {
+    const perf = new ViewerPerformance("https://www.ampproject.org");
+    perf.mark("attachStart");
+    perf.measure("documentLoad", "attachStart", "documentLoaded");
+    expect(timings).to.have.length(1);
+  });
+
+  it("should clear its entries from the performance timeline", () => {
+    const perf = new ViewerPerformance("https://www.ampproject.org");
+    const entryName = name => "amp-viewer:" + perf.viewerId + ":" + name;
+    perf.mark("attachStart");
+    perf.mark("srcSet");
+    perf.measure("src", "attachStart", "srcSet");
+    perf.clear();
+
+    expect(performance.getEntriesByName(entryName("attachStart"))).to.have
+      .length(0);
+    expect(performance.getEntriesByName(entryName("srcSet"))).to.have.length(
+      0
+    );
+    expect(performance.getEntriesByName(entryName("src"))).to.have.length(0);
+    expect(perf.getMark("attachStart")).to.be.undefined;
+    expect(timings).to.have.length(3);
+  });
+
+  it("should stop reporting once unregistered", () => {
+    unlisten();
+    new ViewerPerformance("https://www.ampproject.org").count("retries", 2);
+    expect(timings).to.deep.equal([]);
+  });
+});
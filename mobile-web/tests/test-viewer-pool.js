@@ -0,0 +1,103 @@
+/**
+ * Copyright 2020 The AMP HTML Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS-IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+import { Viewer } from "../src/viewer";
+import { ViewerPool } from "../src/viewer-pool";
+
+describe("Tests for ViewerPool", () => {
+  let buildIframeSrc;
+  let host;
+  let pool;
+
+  beforeEach(() => {
+    // Nothing is actually loaded: the cache url never arrives.
+    buildIframeSrc = sinon
+      .stub(Viewer.prototype, "buildIframeSrc_")
+      .returns(new Promise(() => {}));
+    Viewer.setMaxPrerenders(10);
+    host = document.createElement("div");
+    document.body.appendChild(host);
+    pool = new ViewerPool(host, 1);
+  });
+
+  afterEach(() => {
+    pool.destroy();
+    document.body.removeChild(host);
+    Viewer.setMaxPrerenders(2);
+    buildIframeSrc.restore();
+  });
+
+  function urls(count) {
+    const urls = [];
+    for (let i = 0; i < count; i++) {
+      urls.push("https://www.example.com/" + i + ".html");
+    }
+    return urls;
+  }
+
+  it("should attach the current AMP Doc and prerender its neighbors", () => {
+    pool.setAmpDocUrls(urls(5), 2);
+
+    expect(pool.getCurrentIndex()).to.equal(2);
+    expect(pool.getCurrentViewer().getVisibilityState()).to.equal("visible");
+    expect(host.querySelectorAll("iframe")).to.have.length(3);
+  });
+
+  it("should recycle the iframes that leave the window", () => {
+    pool.setAmpDocUrls(urls(5), 0);
+    expect(host.querySelectorAll("iframe")).to.have.length(2);
+
+    pool.next();
+    pool.next();
+    pool.next();
+    expect(pool.getCurrentIndex()).to.equal(3);
+    expect(host.querySelectorAll("iframe")).to.have.length(3);
+  });
+
+  it("should promote a neighbor and make the old current one inactive", () => {
+    pool.setAmpDocUrls(urls(5), 0);
+    const first = pool.getCurrentViewer();
+
+    pool.next();
+    expect(pool.getCurrentViewer().getVisibilityState()).to.equal("visible");
+    expect(first.getVisibilityState()).to.equal("inactive");
+  });
+
+  it("should make freed AMP Docs inactive and unload them", () => {
+    pool.setAmpDocUrls(urls(5), 0);
+    const first = pool.getCurrentViewer();
+    const iframe = pool.iframes_.get(first);
+    const setVisibilityState = sinon.spy(first, "setVisibilityState");
+    let srcWhenReleased;
+    const release = sinon.stub(first, "release").callsFake(() => {
+      srcWhenReleased = iframe.src;
+      return Viewer.prototype.release.call(first);
+    });
+
+    pool.setCurrentIndex(3);
+
+    expect(setVisibilityState).to.have.been.calledWith("inactive");
+    expect(release).to.have.been.calledAfter(setVisibilityState);
+    expect(srcWhenReleased).to.equal("about:blank");
+  });
+
+  it("should remove the iframes when destroyed", () => {
+    pool.setAmpDocUrls(urls(5), 2);
+    pool.destroy();
+    expect(host.querySelectorAll("iframe")).to.have.length(0);
+    expect(pool.getCurrentViewer()).to.be.null;
+  });
+});
@@ -0,0 +1,125 @@
+/**
+ * Copyright 2020 The AMP HTML Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS-IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+import { Viewer } from "../src/viewer";
+import { prerenderBudget } from "../src/prerender-budget";
+
+describe("Tests for Viewer", () => {
+  let host;
+
+  beforeEach(() => {
+    host = document.createElement("div");
+    document.body.appendChild(host);
+  });
+
+  afterEach(() => {
+    Viewer.setHandshakePoll(true);
+    document.body.removeChild(host);
+  });
+
+  it("should advertise the handshake poll by default", () => {
+    const viewer = new Viewer(host, "https://www.example.com/amp.html");
+    expect(viewer.createInitParams_()["cap"]).to.equal(
+      "history,handshakepoll"
+    );
+  });
+
+  it("should not advertise the handshake poll once disabled", () => {
+    Viewer.setHandshakePoll(false);
+    const viewer = new Viewer(host, "https://www.example.com/amp.html");
+    expect(viewer.createInitParams_()["cap"]).to.equal("history");
+  });
+
+  describe("prerender budget", () => {
+    let buildIframeSrc;
+    let viewers;
+
+    beforeEach(() => {
+      // Nothing is actually loaded: the cache url never arrives.
+      buildIframeSrc = sinon
+        .stub(Viewer.prototype, "buildIframeSrc_")
+        .returns(new Promise(() => {}));
+      Viewer.setMaxPrerenders(1);
+      viewers = [];
+    });
+
+    afterEach(() => {
+      viewers.forEach(viewer => viewer.release());
+      Viewer.setMaxPrerenders(2);
+      buildIframeSrc.restore();
+    });
+
+    function attachPrerender(path) {
+      const viewer = new Viewer(
+        host,
+        "https://www.example.com/" + path,
+        undefined,
+        true
+      );
+      viewer.attach();
+      viewers.push(viewer);
+      return viewer;
+    }
+
+    it("should queue prerenders over the budget", () => {
+      const first = attachPrerender("first.html");
+      const second = attachPrerender("second.html");
+      expect(first.loadStarted_).to.be.true;
+      expect(second.loadStarted_).to.be.false;
+
+      first.release();
+      expect(second.loadStarted_).to.be.true;
+      expect(prerenderBudget.getPrerenderCount()).to.equal(1);
+    });
+
+    it("should keep a demoted viewer queued until it gets a slot", () => {
+      const first = attachPrerender("first.html");
+      const second = attachPrerender("second.html");
+
+      second.setVisibilityState("inactive");
+      second.setVisibilityState("paused");
+      expect(second.loadStarted_).to.be.false;
+
+      first.setVisibilityState("inactive");
+      expect(second.loadStarted_).to.be.true;
+      expect(second.getVisibilityState()).to.equal("paused");
+    });
+
+    it("should load a queued viewer right away once visible", () => {
+      attachPrerender("first.html");
+      const second = attachPrerender("second.html");
+      const third = attachPrerender("third.html");
+
+      second.setVisibilityState("visible");
+      expect(second.loadStarted_).to.be.true;
+      expect(third.loadStarted_).to.be.false;
+      expect(prerenderBudget.getPrerenderCount()).to.equal(1);
+    });
+
+    it("should free the slot of a viewer granted one while inactive", () => {
+      const first = attachPrerender("first.html");
+      const second = attachPrerender("second.html");
+      second.setVisibilityState("inactive");
+      first.release();
+      expect(second.loadStarted_).to.be.true;
+      const third = attachPrerender("third.html");
+      expect(third.loadStarted_).to.be.false;
+
+      second.setVisibilityState("visible");
+      expect(third.loadStarted_).to.be.true;
+    });
+  });
+});
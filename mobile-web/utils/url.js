@@ -14,23 +14,90 @@
  * limitations under the License.
  */
 
+/** @const {number} The maximum number of parsed urls to keep around. */
+const PARSED_URL_CACHE_SIZE = 100;
+
+/** @const {!Map<string, !Object>} */
+const parsedUrlCache = new Map();
+
+/** @const {!RegExp} Matches urls that start with a scheme. */
+const ABSOLUTE_URL_REGEX = /^[a-z][a-z0-9+.-]*:/i;
 
 /**
+ * Parses a url without touching the DOM, so it is also usable from a Worker.
+ * Relative urls are resolved against the current global's location.
+ * Results are frozen, callers must not modify them. Only absolute urls are
+ * cached, relative ones resolve differently once the location changes.
  * @param {string} urlString
  * @return {*}
  */
 export function parseUrl(urlString) {
-  const a = document.createElement('a');
-  a.href = urlString;
+  const cacheable = ABSOLUTE_URL_REGEX.test(urlString);
+  let parsed = cacheable ? parsedUrlCache.get(urlString) : undefined;
+  if (parsed) {
+    // Move the entry to the back so the cache evicts least recently used urls.
+    parsedUrlCache.delete(urlString);
+    parsedUrlCache.set(urlString, parsed);
+    return parsed;
+  }
+
+  let url;
+  try {
+    url = new URL(urlString, getBaseHref_());
+  } catch (e) {
+    url = parseLeniently_(urlString);
+  }
+  parsed = Object.freeze({
+    href: url.href,
+    protocol: url.protocol,
+    host: url.host,
+    hostname: url.hostname,
+    port: url.port == '0' ? '' : url.port,
+    pathname: url.pathname,
+    search: url.search,
+    hash: url.hash,
+    origin: url.protocol + '//' + url.host
+  });
+
+  if (cacheable) {
+    if (parsedUrlCache.size >= PARSED_URL_CACHE_SIZE) {
+      parsedUrlCache.delete(parsedUrlCache.keys().next().value);
+    }
+    parsedUrlCache.set(urlString, parsed);
+  }
+  return parsed;
+}
+
+/**
+ * Parses a url that URL rejects the way an anchor element does, which is how
+ * urls used to be parsed. Without a DOM only the href is kept.
+ * @param {string} urlString
+ * @return {*}
+ * @private
+ */
+function parseLeniently_(urlString) {
+  if (typeof document != 'undefined') {
+    const a = document.createElement('a');
+    a.href = urlString;
+    return a;
+  }
   return {
-    href: a.href,
-    protocol: a.protocol,
-    host: a.host,
-    hostname: a.hostname,
-    port: a.port == '0' ? '' : a.port,
-    pathname: a.pathname,
-    search: a.search,
-    hash: a.hash,
-    origin: a.protocol + '//' + a.host
+    href: urlString,
+    protocol: '',
+    host: '',
+    hostname: '',
+    port: '',
+    pathname: '',
+    search: '',
+    hash: '',
   };
-}
\ No newline at end of file
+}
+
+/**
+ * @return {string|undefined} the href relative urls should be resolved against.
+ * @private
+ */
+function getBaseHref_() {
+  return typeof self != 'undefined' && self.location ?
+    self.location.href : undefined;
+}